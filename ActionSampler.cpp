@@ -0,0 +1,96 @@
+#include "ActionSampler.h"
+
+#include "ScenarioGenerator.h"
+
+#include <cstdlib>
+
+namespace mtm {
+
+    ActionSampler::ActionSampler(const Game& game, uint64_t seed) :
+        generator(seed),
+        crossfitters(),
+        powerlifters(),
+        last_team(CROSSFITTERS),
+        last_index(0)
+    {
+        game.forEachCharacter([this](const GridPoint& coordinates, const Character& character) {
+            getUnits(character.getTeam()).push_back(coordinates);
+        });
+    }
+
+    std::vector<GridPoint>& ActionSampler::getUnits(Team team)
+    {
+        return team == CROSSFITTERS ? crossfitters : powerlifters;
+    }
+
+    GridPoint ActionSampler::randomOffset(const GridPoint& center, int distance)
+    {
+        int row_offset = ScenarioGenerator::randomInt(generator, -distance, distance);
+        int col_span = distance - std::abs(row_offset);
+        int col_offset = ScenarioGenerator::randomInt(generator, -col_span, col_span);
+        return GridPoint(center.row + row_offset, center.col + col_offset);
+    }
+
+    bool ActionSampler::next(const Game& game, Team team, Command& command)
+    {
+        std::vector<GridPoint>& units = getUnits(team);
+        while (!units.empty())
+        {
+            size_t index = size_t(ScenarioGenerator::randomBelow(generator, units.size()));
+            const GridPoint coordinates = units[index];
+            const Character* character = game.getCharacter(coordinates);
+            if (character == nullptr || (*character).getTeam() != team) {
+                units[index] = units.back();
+                units.pop_back();
+                continue;
+            }
+
+            last_team = team;
+            last_index = index;
+            for (int attempt = 0; attempt < ATTEMPTS; ++attempt)
+            {
+                double roll = ScenarioGenerator::randomReal(generator);
+                if (roll < 0.5) {
+                    GridPoint target = randomOffset(coordinates, (*character).getAttackRange());
+                    if (game.isLegalAttack(coordinates, target)) {
+                        command = Command(ATTACK_COMMAND, coordinates, target);
+                        return true;
+                    }
+                }
+                else if (roll < 0.9) {
+                    GridPoint destination = randomOffset(coordinates, (*character).getTravelDistance());
+                    if (game.isLegalMove(coordinates, destination)) {
+                        command = Command(MOVE_COMMAND, coordinates, destination);
+                        return true;
+                    }
+                }
+                else {
+                    break;
+                }
+            }
+
+            command = Command(RELOAD_COMMAND, coordinates, coordinates);
+            return true;
+        }
+        return false;
+    }
+
+    bool ActionSampler::next(const Game& game, Command& command)
+    {
+        while (!crossfitters.empty() || !powerlifters.empty())
+        {
+            uint64_t roll = ScenarioGenerator::randomBelow(generator, crossfitters.size() + powerlifters.size());
+            if (next(game, roll < crossfitters.size() ? CROSSFITTERS : POWERLIFTERS, command)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ActionSampler::update(const Command& command, CommandStatus status)
+    {
+        if (command.type == MOVE_COMMAND && status == SUCCESS) {
+            getUnits(last_team)[last_index] = command.dst;
+        }
+    }
+}
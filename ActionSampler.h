@@ -0,0 +1,80 @@
+#ifndef ACTION_SAMPLER_H
+#define ACTION_SAMPLER_H
+
+#include "Game.h"
+#include "Command.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * ActionSampler - picks random legal commands against a game.
+     *
+     * The sampler keeps its own list of the characters' coordinates, so picking a command costs
+     * a few O(1) legality checks instead of a scan of the board.
+     * Characters that were killed are dropped from the list lazily, when they are picked.
+     */
+    class ActionSampler
+    {
+        static const int ATTEMPTS = 8;
+
+        std::mt19937_64 generator;
+        std::vector<GridPoint> crossfitters;
+        std::vector<GridPoint> powerlifters;
+        Team last_team;
+        size_t last_index;
+
+        public:
+            ActionSampler() = delete;
+
+            /**
+             * ActionSampler constructor: creates a sampler for the current characters of a game.
+             *
+             * @param game - the game the commands are picked against.
+             * @param seed - the seed of the random choices.
+             */
+            ActionSampler(const Game& game, uint64_t seed);
+
+            /**
+             * next: picks a random legal command for one of the team's characters.
+             * an attack or a move is tried first, a reload (which is always legal) is the fallback.
+             *
+             * @param game    - the game the sampler was created for.
+             * @param team    - the team whose character acts.
+             * @param command - the result keeper.
+             *
+             * @return
+             *     true if a command was picked, false if the team has no characters left.
+             */
+            bool next(const Game& game, Team team, Command& command);
+
+            /**
+             * next: picks a random legal command for a character of any team.
+             *
+             * @return
+             *     true if a command was picked, false if there are no characters left.
+             */
+            bool next(const Game& game, Command& command);
+
+            /**
+             * update: keeps the sampler's list in sync after the last picked command was executed.
+             *
+             * @param command - the last command returned by next.
+             * @param status  - the result of executing it.
+             */
+            void update(const Command& command, CommandStatus status);
+
+        private:
+            std::vector<GridPoint>& getUnits(Team team);
+
+            /**
+             * randomOffset: returns a random cell within a Manhattan distance from a center.
+             */
+            GridPoint randomOffset(const GridPoint& center, int distance);
+    };
+}
+
+#endif
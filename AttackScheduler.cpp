@@ -0,0 +1,193 @@
+#include "AttackScheduler.h"
+
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace mtm {
+
+    AttackScheduler::AttackScheduler(unsigned int threads, int tile_size) :
+        pool(threads),
+        tile_size(tile_size),
+        waves_count(0)
+    {
+        if (tile_size <= 0) {
+            throw IllegalArgument();
+        }
+    }
+
+    int AttackScheduler::getWavesCount() const
+    {
+        return waves_count;
+    }
+
+    unsigned int AttackScheduler::getThreadsCount() const
+    {
+        return pool.getSize();
+    }
+
+    bool AttackScheduler::isConflicting(const Footprint& first, const Footprint& second)
+    {
+        return GridPoint::distance(first.src, second.src) == 0 ||
+               GridPoint::distance(first.src, second.dst) <= second.radius ||
+               GridPoint::distance(first.dst, second.src) <= first.radius ||
+               GridPoint::distance(first.dst, second.dst) <= first.radius + second.radius;
+    }
+
+    int AttackScheduler::schedule(const Game& game, const Command* begin, const Command* end,
+                                  std::vector<int>& waves) const
+    {
+        int height = game.getHeight();
+        int width = game.getWidth();
+        int tile_cols = (width + tile_size - 1) / tile_size;
+
+        // every touched tile keeps the attacks whose footprint covers it. only the touched tiles are kept,
+        // so a batch costs its footprints, not the board's area.
+        std::unordered_map<uint64_t, std::vector<size_t>> tiles;
+        std::vector<Footprint> footprints(size_t(end - begin), Footprint{GridPoint(0, 0), GridPoint(0, 0), 0});
+        waves.assign(size_t(end - begin), 0);
+        int count = 0;
+
+        for (size_t index = 0; index < footprints.size(); ++index)
+        {
+            const Command& command = begin[index];
+            bool is_in_board = command.src.row >= 0 && command.src.row < height &&
+                               command.src.col >= 0 && command.src.col < width &&
+                               command.dst.row >= 0 && command.dst.row < height &&
+                               command.dst.col >= 0 && command.dst.col < width;
+            if (!is_in_board) {
+                continue; // fails with IllegalCell whatever the state of the game, so it conflicts with nothing.
+            }
+
+            const Character* attacker = game.getCharacter(command.src);
+            Footprint& footprint = footprints[index];
+            footprint.src = command.src;
+            footprint.dst = command.dst;
+            footprint.radius = attacker != nullptr ? (*attacker).getSplashRadius() : 0;
+
+            int first_tile_row = std::max(0, command.dst.row - footprint.radius) / tile_size;
+            int last_tile_row  = int(std::min((long long)height - 1, (long long)command.dst.row + footprint.radius) /
+                                     tile_size);
+            int first_tile_col = std::max(0, command.dst.col - footprint.radius) / tile_size;
+            int last_tile_col  = int(std::min((long long)width - 1, (long long)command.dst.col + footprint.radius) /
+                                     tile_size);
+            int src_tile_row = command.src.row / tile_size;
+            int src_tile_col = command.src.col / tile_size;
+            bool is_src_covered = src_tile_row >= first_tile_row && src_tile_row <= last_tile_row &&
+                                  src_tile_col >= first_tile_col && src_tile_col <= last_tile_col;
+
+            int wave = 0;
+            auto visit = [&](int tile_row, int tile_col) {
+                std::vector<size_t>& tile = tiles[uint64_t(tile_row) * uint64_t(tile_cols) + uint64_t(tile_col)];
+                for (size_t other : tile) {
+                    if (waves[other] >= wave && isConflicting(footprints[other], footprint)) {
+                        wave = waves[other] + 1;
+                    }
+                }
+                tile.push_back(index);
+            };
+            for (int tile_row = first_tile_row; tile_row <= last_tile_row; ++tile_row) {
+                for (int tile_col = first_tile_col; tile_col <= last_tile_col; ++tile_col) {
+                    visit(tile_row, tile_col);
+                }
+            }
+            if (!is_src_covered) {
+                visit(src_tile_row, src_tile_col);
+            }
+
+            waves[index] = wave;
+            count = std::max(count, wave + 1);
+        }
+        return std::max(count, footprints.empty() ? 0 : 1);
+    }
+
+    void AttackScheduler::runAttacks(Game& game, const Command* begin, const Command* end, CommandStatus* statuses)
+    {
+        std::vector<int> waves;
+        int count = schedule(game, begin, end, waves);
+        waves_count += count;
+
+        // bucket the attacks by wave, keeping the commands' order within every wave.
+        std::vector<size_t> wave_starts(size_t(count) + 1, 0);
+        for (int wave : waves) {
+            ++wave_starts[size_t(wave) + 1];
+        }
+        std::partial_sum(wave_starts.begin(), wave_starts.end(), wave_starts.begin());
+        std::vector<size_t> order(waves.size());
+        std::vector<size_t> next(wave_starts.begin(), wave_starts.end() - 1);
+        for (size_t index = 0; index < waves.size(); ++index) {
+            order[next[size_t(waves[index])]++] = index;
+        }
+
+        std::vector<AttackOutcome> outcomes(waves.size());
+        unsigned int workers = pool.getSize();
+        int tile_cols = (game.getWidth() + tile_size - 1) / tile_size;
+        std::vector<std::vector<size_t>> shards(workers);
+
+        for (int wave = 0; wave < count; ++wave)
+        {
+            const size_t* first = order.data() + wave_starts[size_t(wave)];
+            const size_t* last = order.data() + wave_starts[size_t(wave) + 1];
+
+            if (size_t(last - first) < MIN_PARALLEL_WAVE || workers < 2) {
+                for (const size_t* index = first; index != last; ++index) {
+                    statuses[*index] = applyAttackCommand(game, begin[*index], outcomes[*index]);
+                }
+            }
+            else {
+                for (std::vector<size_t>& shard : shards) {
+                    shard.clear();
+                }
+                for (const size_t* index = first; index != last; ++index) {
+                    const GridPoint& dst = begin[*index].dst;
+                    size_t tile = dst.row < 0 || dst.col < 0 ? 0 : size_t(dst.row / tile_size) * size_t(tile_cols) +
+                                                                    size_t(dst.col / tile_size);
+                    shards[tile % workers].push_back(*index);
+                }
+                for (unsigned int worker = 0; worker < workers; ++worker) {
+                    if (shards[worker].empty()) {
+                        continue;
+                    }
+                    pool.submit(worker, [&, worker]() {
+                        for (size_t index : shards[worker]) {
+                            statuses[index] = applyAttackCommand(game, begin[index], outcomes[index]);
+                        }
+                    });
+                }
+                pool.wait();
+            }
+
+            for (const size_t* index = first; index != last; ++index) {
+                game.commitAttack(outcomes[*index]);
+            }
+        }
+    }
+
+    void AttackScheduler::execute(Game& game, const std::vector<Command>& commands, std::vector<CommandStatus>& statuses)
+    {
+        statuses.assign(commands.size(), SUCCESS);
+        waves_count = 0;
+
+        size_t index = 0;
+        while (index < commands.size())
+        {
+            size_t run_end = index;
+            while (run_end < commands.size() && commands[run_end].type == ATTACK_COMMAND) {
+                ++run_end;
+            }
+
+            if (run_end > index) {
+                runAttacks(game, commands.data() + index, commands.data() + run_end, statuses.data() + index);
+                index = run_end;
+                continue;
+            }
+
+            // moves and reloads change the board's structure (or the hash), so they run alone.
+            statuses[index] = executeCommand(game, commands[index]);
+            ++waves_count;
+            ++index;
+        }
+    }
+}
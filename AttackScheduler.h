@@ -0,0 +1,101 @@
+#ifndef ATTACK_SCHEDULER_H
+#define ATTACK_SCHEDULER_H
+
+#include "Game.h"
+#include "Command.h"
+#include "ThreadPool.h"
+
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * AttackScheduler - executes a batch of commands, applying non-conflicting attacks in parallel.
+     *
+     * The board is partitioned into square tiles. The footprint of an attack is its source cell, its destination
+     * cell and, for a splash attack, the splash diamond around the destination; two attacks conflict if their
+     * footprints intersect. Every run of consecutive attacks is scheduled into waves in the commands' order:
+     * an attack goes one wave after the last earlier attack it conflicts with (only the attacks registered on the
+     * tiles its footprint covers are checked). The attacks of a wave are applied in parallel, every one by the
+     * worker owning its destination's tile, and committed in the commands' order; moves and reloads run alone.
+     * Since only non-conflicting attacks change their relative order, the result is always equal to executing
+     * the commands one by one (see executeCommand).
+     */
+    class AttackScheduler
+    {
+        static const int DEFAULT_TILE_SIZE = 16;
+        static const size_t MIN_PARALLEL_WAVE = 32;
+
+        struct Footprint
+        {
+            GridPoint src;
+            GridPoint dst;
+            int radius;
+        };
+
+        ThreadPool pool;
+        int tile_size;
+        int waves_count;
+
+        public:
+            /**
+             * AttackScheduler constructor: creates a scheduler and starts its threads.
+             *
+             * @param threads   - the number of threads. 0 means one thread per hardware thread.
+             * @param tile_size - the side length of the tiles.
+             *
+             * @throw
+             *     IllegalArgument - if the tile size is not positive.
+             */
+            explicit AttackScheduler(unsigned int threads = 0, int tile_size = DEFAULT_TILE_SIZE);
+
+            AttackScheduler(const AttackScheduler& other) = delete;
+            AttackScheduler& operator=(const AttackScheduler& other) = delete;
+
+            /**
+             * execute: executes a batch of commands on a game.
+             *
+             * @param game     - the game.
+             * @param commands - the commands, in the order they are to be executed.
+             * @param statuses - the result keeper: the status of every command (see executeCommand).
+             */
+            void execute(Game& game, const std::vector<Command>& commands, std::vector<CommandStatus>& statuses);
+
+            /**
+             * schedule: assigns the waves of a run of attacks against the current state of a game.
+             *
+             * @param game  - the game.
+             * @param begin - a pointer to the first command. every command must be an ATTACK_COMMAND.
+             * @param end   - a pointer past the last command.
+             * @param waves - the result keeper: the wave (starting from 0) of every command.
+             *
+             * @return
+             *     the number of waves.
+             */
+            int schedule(const Game& game, const Command* begin, const Command* end, std::vector<int>& waves) const;
+
+            /**
+             * getWavesCount: the number of waves (and commands run alone) of the last execution.
+             */
+            int getWavesCount() const;
+
+            /**
+             * getThreadsCount: the number of threads of the scheduler.
+             */
+            unsigned int getThreadsCount() const;
+
+        private:
+            /**
+             * isConflicting: checks if two footprints intersect.
+             * two diamonds intersect if the distance between their centers is at most the sum of their radii.
+             */
+            static bool isConflicting(const Footprint& first, const Footprint& second);
+
+            /**
+             * runAttacks: executes a run of attacks, wave by wave.
+             */
+            void runAttacks(Game& game, const Command* begin, const Command* end, CommandStatus* statuses);
+    };
+}
+
+#endif
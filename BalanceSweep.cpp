@@ -0,0 +1,385 @@
+#include "BalanceSweep.h"
+
+#include "ActionSampler.h"
+#include "Command.h"
+#include "Exceptions.h"
+#include "ThreadPool.h"
+#include "Zobrist.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+namespace mtm {
+
+    static const char SWEEP_MAGIC[] = "MTMSWEEP";
+    static const uint32_t SWEEP_VERSION = 1;
+    static const uint32_t BLOCK_MARKER = 0x4B4F4C42; // "BLOK"
+    static const int INT_COLUMNS = 10;
+    static const int REAL_COLUMNS = 3;
+    static const char* const COLUMN_NAMES[INT_COLUMNS + REAL_COLUMNS] = {
+        "point_index", "type", "health", "ammo", "range", "power",
+        "matches", "crossfitters_wins", "powerlifters_wins", "draws",
+        "score", "half_width", "mean_actions"
+    };
+
+    size_t SweepGrid::getSize() const
+    {
+        return types.size() * healths.size() * ammos.size() * ranges.size() * powers.size();
+    }
+
+    SweepPoint SweepGrid::getPoint(size_t index) const
+    {
+        SweepPoint point;
+        point.power = powers[index % powers.size()];
+        index /= powers.size();
+        point.range = ranges[index % ranges.size()];
+        index /= ranges.size();
+        point.ammo = ammos[index % ammos.size()];
+        index /= ammos.size();
+        point.health = healths[index % healths.size()];
+        index /= healths.size();
+        point.type = types[index % types.size()];
+        return point;
+    }
+
+    SweepConfig::SweepConfig(int height, int width) :
+        grid(),
+        scenario(height, width),
+        min_matches(16),
+        max_matches(256),
+        batch_matches(16),
+        target_half_width(0.05),
+        confidence_z(1.96),
+        max_actions(2000),
+        threads(0),
+        block_rows(64),
+        flush_seconds(10),
+        seed(0)
+    {}
+
+    static void writeBytes(std::ostream& os, uint64_t bits, int size)
+    {
+        char bytes[8];
+        for (int i = 0; i < size; ++i) {
+            bytes[i] = char(uint8_t(bits >> (8 * i)));
+        }
+        os.write(bytes, size);
+    }
+
+    static uint64_t readBytes(const char* bytes, int size)
+    {
+        uint64_t bits = 0;
+        for (int i = 0; i < size; ++i) {
+            bits |= uint64_t(uint8_t(bytes[i])) << (8 * i);
+        }
+        return bits;
+    }
+
+    static void toRow(const SweepRecord& record, int64_t* ints, double* reals)
+    {
+        const int64_t values[INT_COLUMNS] = {
+            int64_t(record.point_index), int64_t(record.point.type), record.point.health, record.point.ammo,
+            record.point.range, record.point.power, record.matches, record.crossfitters_wins,
+            record.powerlifters_wins, record.draws
+        };
+        std::memcpy(ints, values, sizeof(values));
+        reals[0] = record.score;
+        reals[1] = record.half_width;
+        reals[2] = record.mean_actions;
+    }
+
+    static SweepRecord fromRow(const int64_t* ints, const double* reals)
+    {
+        SweepRecord record;
+        record.point_index = uint64_t(ints[0]);
+        record.point.type = CharacterType(ints[1]);
+        record.point.health = units_t(ints[2]);
+        record.point.ammo = units_t(ints[3]);
+        record.point.range = units_t(ints[4]);
+        record.point.power = units_t(ints[5]);
+        record.matches = int(ints[6]);
+        record.crossfitters_wins = int(ints[7]);
+        record.powerlifters_wins = int(ints[8]);
+        record.draws = int(ints[9]);
+        record.score = reals[0];
+        record.half_width = reals[1];
+        record.mean_actions = reals[2];
+        return record;
+    }
+
+    static void writeHeader(std::ostream& os)
+    {
+        os.write(SWEEP_MAGIC, 8);
+        writeBytes(os, SWEEP_VERSION, 4);
+        writeBytes(os, INT_COLUMNS + REAL_COLUMNS, 4);
+        for (int column = 0; column < INT_COLUMNS + REAL_COLUMNS; ++column) {
+            size_t length = std::strlen(COLUMN_NAMES[column]);
+            writeBytes(os, column < INT_COLUMNS ? 0 : 1, 1);
+            writeBytes(os, length, 1);
+            os.write(COLUMN_NAMES[column], std::streamsize(length));
+        }
+    }
+
+    /**
+     * writeBlock: writes a block of results, column by column.
+     */
+    static void writeBlock(std::ostream& os, const std::vector<SweepRecord>& records)
+    {
+        size_t rows = records.size();
+        std::vector<int64_t> ints(rows * INT_COLUMNS);
+        std::vector<double> reals(rows * REAL_COLUMNS);
+        for (size_t row = 0; row < rows; ++row) {
+            toRow(records[row], &ints[row * INT_COLUMNS], &reals[row * REAL_COLUMNS]);
+        }
+
+        writeBytes(os, BLOCK_MARKER, 4);
+        writeBytes(os, rows, 4);
+        for (int column = 0; column < INT_COLUMNS; ++column) {
+            for (size_t row = 0; row < rows; ++row) {
+                writeBytes(os, uint64_t(ints[row * INT_COLUMNS + column]), 8);
+            }
+        }
+        for (int column = 0; column < REAL_COLUMNS; ++column) {
+            for (size_t row = 0; row < rows; ++row) {
+                uint64_t bits;
+                std::memcpy(&bits, &reals[row * REAL_COLUMNS + column], sizeof(bits));
+                writeBytes(os, bits, 8);
+            }
+        }
+        os.flush();
+    }
+
+    uint64_t BalanceSweep::readResults(const std::string& path, std::vector<SweepRecord>& records)
+    {
+        records.clear();
+        std::ifstream input(path, std::ios::binary);
+        if (!input) {
+            return 0;
+        }
+
+        // the header must match the columns of this version exactly.
+        char bytes[8];
+        if (!input.read(bytes, 8) || std::memcmp(bytes, SWEEP_MAGIC, 8) != 0 ||
+            !input.read(bytes, 8) || readBytes(bytes, 4) != SWEEP_VERSION ||
+            readBytes(bytes + 4, 4) != INT_COLUMNS + REAL_COLUMNS) {
+            return 0;
+        }
+        for (int column = 0; column < INT_COLUMNS + REAL_COLUMNS; ++column) {
+            char name[256];
+            size_t length = std::strlen(COLUMN_NAMES[column]);
+            if (!input.read(bytes, 2) || readBytes(bytes, 1) != uint64_t(column < INT_COLUMNS ? 0 : 1) ||
+                readBytes(bytes + 1, 1) != length || !input.read(name, std::streamsize(length)) ||
+                std::memcmp(name, COLUMN_NAMES[column], length) != 0) {
+                return 0;
+            }
+        }
+
+        uint64_t valid_size = uint64_t(input.tellg());
+        std::vector<char> block;
+        while (input.read(bytes, 8) && readBytes(bytes, 4) == BLOCK_MARKER)
+        {
+            size_t rows = size_t(readBytes(bytes + 4, 4));
+            block.resize(rows * 8 * (INT_COLUMNS + REAL_COLUMNS));
+            if (!input.read(block.data(), std::streamsize(block.size()))) {
+                break; // a truncated last block.
+            }
+
+            std::vector<int64_t> ints(INT_COLUMNS);
+            std::vector<double> reals(REAL_COLUMNS);
+            for (size_t row = 0; row < rows; ++row) {
+                for (int column = 0; column < INT_COLUMNS + REAL_COLUMNS; ++column) {
+                    uint64_t bits = readBytes(&block[(size_t(column) * rows + row) * 8], 8);
+                    if (column < INT_COLUMNS) {
+                        ints[column] = int64_t(bits);
+                    }
+                    else {
+                        std::memcpy(&reals[column - INT_COLUMNS], &bits, sizeof(bits));
+                    }
+                }
+                records.push_back(fromRow(ints.data(), reals.data()));
+            }
+            valid_size = uint64_t(input.tellg());
+        }
+        return valid_size;
+    }
+
+    void BalanceSweep::validateConfig(const SweepConfig& config)
+    {
+        const SweepGrid& grid = config.grid;
+        if (grid.getSize() == 0 || config.min_matches < 1 || config.max_matches < config.min_matches ||
+            config.batch_matches < 1 || config.target_half_width < 0 || config.confidence_z <= 0 ||
+            config.max_actions == 0 || config.block_rows == 0 || !(config.flush_seconds >= 0)) {
+            throw IllegalArgument();
+        }
+        for (units_t health : grid.healths) {
+            if (health <= 0) {
+                throw IllegalArgument();
+            }
+        }
+        for (const std::vector<units_t>* stats : {&grid.ammos, &grid.ranges, &grid.powers}) {
+            for (units_t stat : *stats) {
+                if (stat < 0) {
+                    throw IllegalArgument();
+                }
+            }
+        }
+        for (CharacterType type : grid.types) {
+            if (type != SOLDIER && type != MEDIC && type != SNIPER) {
+                throw IllegalArgument();
+            }
+        }
+        ScenarioGenerator::generate(config.scenario); // throws if the scenario is incorrect.
+    }
+
+    int BalanceSweep::playMatch(const SweepConfig& config, const SweepPoint& point, uint64_t seed,
+                                bool is_crossfitters_first, uint64_t& actions)
+    {
+        ScenarioConfig scenario = config.scenario;
+        scenario.seed = seed;
+        std::vector<UnitDescriptor> units = ScenarioGenerator::generate(scenario);
+        for (UnitDescriptor& unit : units) {
+            if (unit.team == CROSSFITTERS) {
+                unit = UnitDescriptor(unit.coordinates, point.type, CROSSFITTERS,
+                                      point.health, point.ammo, point.range, point.power);
+            }
+        }
+
+        Game game(scenario.height, scenario.width);
+        game.loadValidUnits(units.data(), units.data() + units.size());
+        ActionSampler sampler(game, Zobrist::mix(seed));
+        Team team = is_crossfitters_first ? CROSSFITTERS : POWERLIFTERS;
+        Team winning_team;
+        Command command;
+
+        for (actions = 0; actions < config.max_actions && !game.isOver(&winning_team); ++actions) {
+            if (!sampler.next(game, team, command)) {
+                break;
+            }
+            sampler.update(command, executeCommand(game, command));
+            team = (team == CROSSFITTERS ? POWERLIFTERS : CROSSFITTERS);
+        }
+
+        if (!game.isOver(&winning_team)) {
+            return 0;
+        }
+        return winning_team == CROSSFITTERS ? 1 : -1;
+    }
+
+    SweepRecord BalanceSweep::runPoint(const SweepConfig& config, size_t point_index)
+    {
+        if (point_index >= config.grid.getSize()) {
+            throw IllegalArgument();
+        }
+
+        SweepRecord record;
+        record.point_index = point_index;
+        record.point = config.grid.getPoint(point_index);
+        record.matches = 0;
+        record.crossfitters_wins = 0;
+        record.powerlifters_wins = 0;
+        record.draws = 0;
+        record.half_width = 0;
+
+        double sum = 0, sum_of_squares = 0, total_actions = 0;
+        uint64_t point_seed = Zobrist::mix(config.seed ^ Zobrist::mix(point_index));
+        while (record.matches < config.max_matches)
+        {
+            uint64_t actions = 0;
+            int result = playMatch(config, record.point, point_seed + uint64_t(record.matches),
+                                   record.matches % 2 == 0, actions);
+            double score = (result + 1) / 2.0;
+            (result > 0 ? record.crossfitters_wins : result < 0 ? record.powerlifters_wins : record.draws) += 1;
+            ++record.matches;
+            sum += score;
+            sum_of_squares += score * score;
+            total_actions += double(actions);
+
+            int n = record.matches;
+            double variance = n > 1 ? std::max(0.0, (sum_of_squares - sum * sum / n) / (n - 1)) : 0;
+            record.half_width = config.confidence_z * std::sqrt(variance / n);
+            bool is_check = n >= config.min_matches && (n - config.min_matches) % config.batch_matches == 0;
+            if (config.target_half_width > 0 && is_check && record.half_width <= config.target_half_width) {
+                break;
+            }
+        }
+
+        record.score = sum / record.matches;
+        record.mean_actions = total_actions / record.matches;
+        return record;
+    }
+
+    size_t BalanceSweep::run(const SweepConfig& config, const std::string& path)
+    {
+        validateConfig(config);
+
+        std::vector<SweepRecord> done;
+        uint64_t valid_size = readResults(path, done);
+        std::vector<bool> is_done(config.grid.getSize(), false);
+        for (const SweepRecord& record : done) {
+            if (record.point_index < is_done.size()) {
+                is_done[record.point_index] = true;
+            }
+        }
+
+        std::ofstream output;
+        if (valid_size == 0) {
+            output.open(path, std::ios::binary | std::ios::trunc);
+            writeHeader(output);
+        }
+        else {
+            std::error_code error;
+            std::filesystem::resize_file(path, valid_size, error); // drops a truncated last block.
+            output.open(path, std::ios::binary | std::ios::app);
+        }
+        if (!output) {
+            throw IllegalArgument();
+        }
+
+        std::vector<size_t> pending;
+        for (size_t index = 0; index < is_done.size(); ++index) {
+            if (!is_done[index]) {
+                pending.push_back(index);
+            }
+        }
+
+        // the points differ a lot in cost (adaptive stops, match lengths), so instead of dealing them out
+        // in advance, every worker takes the next pending point whenever it finishes one.
+        std::atomic<size_t> next_pending(0);
+        std::mutex block_mutex;
+        std::vector<SweepRecord> block;
+        std::chrono::steady_clock::time_point last_write = std::chrono::steady_clock::now();
+        std::chrono::duration<double> flush_interval(config.flush_seconds);
+        {
+            ThreadPool pool(config.threads);
+            for (unsigned int worker = 0; worker < pool.getSize(); ++worker) {
+                pool.submit(worker, [&]() {
+                    for (size_t position = next_pending++; position < pending.size(); position = next_pending++) {
+                        SweepRecord record = runPoint(config, pending[position]);
+                        std::lock_guard<std::mutex> lock(block_mutex);
+                        block.push_back(record);
+                        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                        if (block.size() >= config.block_rows || now - last_write >= flush_interval) {
+                            writeBlock(output, block);
+                            block.clear();
+                            last_write = now;
+                        }
+                    }
+                });
+            }
+            pool.wait();
+        }
+
+        if (!block.empty()) {
+            writeBlock(output, block);
+        }
+        if (!output) {
+            throw IllegalArgument();
+        }
+        return pending.size();
+    }
+}
@@ -0,0 +1,176 @@
+#ifndef BALANCE_SWEEP_H
+#define BALANCE_SWEEP_H
+
+#include "ScenarioGenerator.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * SweepPoint - the type and stats given to every crossfitters' unit in the matches of a grid point.
+     */
+    struct SweepPoint
+    {
+        CharacterType type;
+        units_t health;
+        units_t ammo;
+        units_t range;
+        units_t power;
+    };
+
+    /**
+     * SweepGrid - the parameter grid of a sweep: every combination of the listed values is a grid point.
+     * the points are numbered in a mixed radix, the type varying slowest and the power fastest.
+     */
+    struct SweepGrid
+    {
+        std::vector<CharacterType> types;
+        std::vector<units_t> healths;
+        std::vector<units_t> ammos;
+        std::vector<units_t> ranges;
+        std::vector<units_t> powers;
+
+        /**
+         * getSize: the number of grid points.
+         */
+        size_t getSize() const;
+
+        /**
+         * getPoint: the grid point of an index, lesser than getSize().
+         */
+        SweepPoint getPoint(size_t index) const;
+    };
+
+    /**
+     * SweepConfig - the parameters of a sweep.
+     *
+     * scenario           - the board and the units of every match. the powerlifters keep their generated stats,
+     *                      the crossfitters get the grid point's type and stats.
+     * min_matches        - the number of matches played before the confidence interval is first checked.
+     * max_matches        - the maximal number of matches of a grid point (K).
+     * batch_matches      - the number of matches played between two checks of the confidence interval.
+     * target_half_width  - a point stops once the half width of its score's confidence interval is at most
+     *                      this value. 0 disables the adaptive stop (every point plays max_matches).
+     * confidence_z       - the z value of the confidence interval (1.96 for 95%).
+     * max_actions        - a match without a winner after this number of actions is a draw.
+     * threads            - the number of threads. 0 means one thread per hardware thread.
+     * block_rows         - the maximal number of results per block of the output file.
+     * flush_seconds      - a block is also written once this many seconds passed since the last one, so an
+     *                      interrupted sweep loses at most that much of finished work. 0 writes every result.
+     * seed               - the same seed and parameters always give the same results.
+     */
+    struct SweepConfig
+    {
+        SweepGrid grid;
+        ScenarioConfig scenario;
+        int min_matches;
+        int max_matches;
+        int batch_matches;
+        double target_half_width;
+        double confidence_z;
+        uint64_t max_actions;
+        unsigned int threads;
+        size_t block_rows;
+        double flush_seconds;
+        uint64_t seed;
+
+        /**
+         * SweepConfig constructor: creates a config of matches on boards of the given dimensions,
+         * with an empty grid, 16 to 256 matches per point in batches of 16, a 0.05 target half width (95%),
+         * 2000 actions per match, all hardware threads and blocks of up to 64 results or 10 seconds of
+         * results.
+         */
+        SweepConfig(int height, int width);
+    };
+
+    /**
+     * SweepRecord - the result of a grid point.
+     *
+     * score is the mean score of the crossfitters (a win is 1, a draw is 0.5, a loss is 0),
+     * half_width is the half width of its confidence interval.
+     */
+    struct SweepRecord
+    {
+        uint64_t point_index;
+        SweepPoint point;
+        int matches;
+        int crossfitters_wins;
+        int powerlifters_wins;
+        int draws;
+        double score;
+        double half_width;
+        double mean_actions;
+    };
+
+    /**
+     * BalanceSweep - a team-vs-team balance sweep engine.
+     *
+     * Every grid point runs random-policy matches (see ActionSampler, the teams alternating and the first team
+     * alternating between matches) on all the cores, one point per task, in a single process.
+     * The results are streamed to a columnar file, which is also the sweep's checkpoint:
+     *
+     *      header: "MTMSWEEP", uint32 version, uint32 columns count, and per column a uint8 kind (0 - int64,
+     *              1 - float64), a uint8 name length and the name.
+     *      blocks: uint32 "BLOK" marker, uint32 rows count, then every column's values, contiguous.
+     *
+     * all the numbers are little endian. an interrupted sweep leaves at most a truncated last block, which is
+     * dropped when the sweep is resumed; the points of the complete blocks are not played again.
+     */
+    class BalanceSweep
+    {
+        public:
+            /**
+             * run: runs a sweep, resuming it if the output file holds the results of a previous run.
+             *
+             * @param config - the parameters of the sweep. must be the same as the ones of the resumed run.
+             * @param path   - the path of the output file.
+             *
+             * @throw
+             *     IllegalArgument - if a parameter is incorrect, or the file can't be read or written.
+             *
+             * @return
+             *     the number of grid points played by this call.
+             */
+            static size_t run(const SweepConfig& config, const std::string& path);
+
+            /**
+             * runPoint: plays the matches of a single grid point.
+             *
+             * @throw
+             *     IllegalArgument - if a parameter is incorrect.
+             */
+            static SweepRecord runPoint(const SweepConfig& config, size_t point_index);
+
+            /**
+             * readResults: reads the complete blocks of an output file.
+             *
+             * @param path    - the path of the output file.
+             * @param records - the result keeper. its previous content is removed.
+             *
+             * @return
+             *     the size in bytes of the file's valid prefix (the header and the complete blocks),
+             *     0 if the file does not exist or has no valid header.
+             */
+            static uint64_t readResults(const std::string& path, std::vector<SweepRecord>& records);
+
+            /**
+             * validateConfig: throws IllegalArgument if one of the config's parameters is incorrect.
+             */
+            static void validateConfig(const SweepConfig& config);
+
+        private:
+            /**
+             * playMatch: plays a single match.
+             *
+             * @return
+             *     1 if the crossfitters won, -1 if the powerlifters won, 0 for a draw.
+             */
+            static int playMatch(const SweepConfig& config, const SweepPoint& point, uint64_t seed,
+                                 bool is_crossfitters_first, uint64_t& actions);
+    };
+}
+
+#endif
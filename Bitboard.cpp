@@ -0,0 +1,159 @@
+#include "Bitboard.h"
+
+#include <algorithm>
+
+namespace mtm {
+
+    const uint64_t Bitboard::DENSE_WORDS_LIMIT;
+
+    Bitboard::Bitboard(int height, int width) :
+        height(height > 0 ? height : 0),
+        width(width > 0 ? width : 0),
+        words_per_row((uint64_t(this->width) + BITS_PER_WORD - 1) / BITS_PER_WORD),
+        is_dense(uint64_t(this->height) * words_per_row <= DENSE_WORDS_LIMIT),
+        words(is_dense ? size_t(this->height) * size_t(words_per_row) : 0, 0),
+        sparse_words()
+    {}
+
+    uint64_t Bitboard::getIndex(int row, int word_index) const
+    {
+        return uint64_t(row) * words_per_row + uint64_t(word_index);
+    }
+
+    uint64_t Bitboard::loadWord(uint64_t index) const
+    {
+        if (is_dense) {
+            return words[size_t(index)];
+        }
+        std::unordered_map<uint64_t, uint64_t>::const_iterator word = sparse_words.find(index);
+        return word != sparse_words.end() ? (*word).second : 0;
+    }
+
+    void Bitboard::storeWord(uint64_t index, uint64_t word)
+    {
+        if (is_dense) {
+            words[size_t(index)] = word;
+        }
+        else if (word != 0) {
+            sparse_words[index] = word;
+        }
+        else {
+            sparse_words.erase(index);
+        }
+    }
+
+    bool Bitboard::test(const GridPoint& coordinates) const
+    {
+        uint64_t word = loadWord(getIndex(coordinates.row, coordinates.col / BITS_PER_WORD));
+        return (word >> (coordinates.col % BITS_PER_WORD)) & 1;
+    }
+
+    void Bitboard::set(const GridPoint& coordinates)
+    {
+        uint64_t index = getIndex(coordinates.row, coordinates.col / BITS_PER_WORD);
+        storeWord(index, loadWord(index) | (uint64_t(1) << (coordinates.col % BITS_PER_WORD)));
+    }
+
+    void Bitboard::reset(const GridPoint& coordinates)
+    {
+        uint64_t index = getIndex(coordinates.row, coordinates.col / BITS_PER_WORD);
+        storeWord(index, loadWord(index) & ~(uint64_t(1) << (coordinates.col % BITS_PER_WORD)));
+    }
+
+    void Bitboard::clear()
+    {
+        std::fill(words.begin(), words.end(), 0);
+        sparse_words.clear();
+    }
+
+    uint64_t Bitboard::maskWord(uint64_t word, int word_index, int first_col, int last_col)
+    {
+        int word_first_col = word_index * BITS_PER_WORD;
+        if (first_col > word_first_col) {
+            word &= ~uint64_t(0) << (first_col - word_first_col);
+        }
+        if (last_col < word_first_col + BITS_PER_WORD - 1) {
+            word &= ~uint64_t(0) >> (BITS_PER_WORD - 1 - (last_col - word_first_col));
+        }
+        return word;
+    }
+
+    uint64_t Bitboard::getWord(int row, int word_index, int first_col, int last_col) const
+    {
+        return maskWord(loadWord(getIndex(row, word_index)), word_index, first_col, last_col);
+    }
+
+    int Bitboard::countRow(int row, int first_col, int last_col) const
+    {
+        int count = 0;
+        for (int word_index = first_col / BITS_PER_WORD; first_col <= last_col &&
+                                                         word_index <= last_col / BITS_PER_WORD; ++word_index) {
+            count += __builtin_popcountll(getWord(row, word_index, first_col, last_col));
+        }
+        return count;
+    }
+
+    int Bitboard::countColumn(int col, int first_row, int last_row) const
+    {
+        int count = 0;
+        for (int row = first_row; row <= last_row; ++row) {
+            count += test(GridPoint(row, col));
+        }
+        return count;
+    }
+
+    long long Bitboard::countRegion(const GridPoint& top_left, const GridPoint& bottom_right) const
+    {
+        if (top_left.row > bottom_right.row || top_left.col > bottom_right.col) {
+            return 0;
+        }
+
+        long long count = 0;
+        int first_word = top_left.col / BITS_PER_WORD;
+        int last_word = bottom_right.col / BITS_PER_WORD;
+        uint64_t region_words = uint64_t(bottom_right.row - top_left.row + 1) * uint64_t(last_word - first_word + 1);
+
+        // a sparse region larger than the set words is counted by its words instead of by its rows.
+        if (!is_dense && region_words > sparse_words.size()) {
+            for (const std::pair<const uint64_t, uint64_t>& word : sparse_words) {
+                int row = int(word.first / words_per_row);
+                int word_index = int(word.first % words_per_row);
+                if (row >= top_left.row && row <= bottom_right.row &&
+                    word_index >= first_word && word_index <= last_word) {
+                    count += __builtin_popcountll(maskWord(word.second, word_index, top_left.col, bottom_right.col));
+                }
+            }
+            return count;
+        }
+
+        for (int row = top_left.row; row <= bottom_right.row; ++row) {
+            count += countRow(row, top_left.col, bottom_right.col);
+        }
+        return count;
+    }
+
+    int Bitboard::findNextInRow(int row, int first_col, int last_col) const
+    {
+        for (int word_index = first_col / BITS_PER_WORD; first_col <= last_col &&
+                                                         word_index <= last_col / BITS_PER_WORD; ++word_index) {
+            uint64_t word = getWord(row, word_index, first_col, last_col);
+            if (word != 0) {
+                return word_index * BITS_PER_WORD + __builtin_ctzll(word);
+            }
+        }
+        return -1;
+    }
+
+    size_t Bitboard::getMemoryUsage() const
+    {
+        // a node of the map holds its key, its word and a link, and the buckets are an array of links.
+        return words.capacity() * sizeof(uint64_t) +
+               sparse_words.size() * (2 * sizeof(uint64_t) + sizeof(void*)) +
+               (sparse_words.empty() ? 0 : sparse_words.bucket_count() * sizeof(void*));
+    }
+
+    size_t Bitboard::getAllocationsCount() const
+    {
+        return (words.capacity() > 0 ? 1 : 0) + sparse_words.size() + (sparse_words.empty() ? 0 : 1);
+    }
+}
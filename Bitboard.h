@@ -0,0 +1,153 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "Auxiliaries.h"
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+namespace mtm {
+
+    /**
+     * Bitboard - a bit-packed set of board cells, one bit per cell.
+     *
+     * Every row is padded to a whole number of 64-bit words, so row-wise queries never
+     * have to deal with bits that belong to the next row.
+     * A board of up to DENSE_WORDS_LIMIT words (128 MB, such as 32768x32768) keeps all its words in an array,
+     * so its queries are plain bit tests. A larger board could not afford the array (a game holds three
+     * bitboards, and its copies as many), so it keeps only its non-zero words, in a hash map keyed by the
+     * word's index, and its memory follows the set bits and not the board's area.
+     */
+    class Bitboard
+    {
+        static const int BITS_PER_WORD = 64;
+        static const uint64_t DENSE_WORDS_LIMIT = uint64_t(1) << 24;
+
+        int height;
+        int width;
+        uint64_t words_per_row;
+        bool is_dense;
+        std::vector<uint64_t> words;
+        std::unordered_map<uint64_t, uint64_t> sparse_words;
+
+        public:
+            Bitboard() = delete;
+
+            /**
+             * Bitboard constructor: creates an empty bitboard with the given dimensions.
+             *
+             * @param height - the number of rows. non-positive values create an empty bitboard.
+             * @param width  - the number of columns. non-positive values create an empty bitboard.
+             */
+            Bitboard(int height, int width);
+
+            /**
+             * test: checks if a cell's bit is set.
+             *
+             * @param coordinates - a reference to a valid cell coordinates (within the board's range).
+             *
+             * @return
+             *      true if the bit is set, false otherwise.
+             */
+            bool test(const GridPoint& coordinates) const;
+
+            /**
+             * set: sets a cell's bit.
+             *
+             * @param coordinates - a reference to a valid cell coordinates (within the board's range).
+             */
+            void set(const GridPoint& coordinates);
+
+            /**
+             * reset: clears a cell's bit.
+             *
+             * @param coordinates - a reference to a valid cell coordinates (within the board's range).
+             */
+            void reset(const GridPoint& coordinates);
+
+            /**
+             * clear: clears all the bits of the bitboard.
+             */
+            void clear();
+
+            /**
+             * countRow: counts the set bits of a row between two columns (inclusive).
+             *
+             * @param row       - a valid row index.
+             * @param first_col - the first column to count. must be non-negative.
+             * @param last_col  - the last column to count. must be lesser than the width.
+             *
+             * @return
+             *      the number of set bits in the range, 0 if the range is empty.
+             */
+            int countRow(int row, int first_col, int last_col) const;
+
+            /**
+             * countColumn: counts the set bits of a column between two rows (inclusive).
+             *
+             * @param col       - a valid column index.
+             * @param first_row - the first row to count. must be non-negative.
+             * @param last_row  - the last row to count. must be lesser than the height.
+             *
+             * @return
+             *      the number of set bits in the range, 0 if the range is empty.
+             */
+            int countColumn(int col, int first_row, int last_row) const;
+
+            /**
+             * countRegion: counts the set bits of a rectangle, row by row.
+             *
+             * @param top_left     - the top left corner of the rectangle (within the board's range).
+             * @param bottom_right - the bottom right corner of the rectangle (within the board's range).
+             *
+             * @return
+             *      the number of set bits in the rectangle, 0 if the rectangle is empty.
+             */
+            long long countRegion(const GridPoint& top_left, const GridPoint& bottom_right) const;
+
+            /**
+             * findNextInRow: finds the first set bit of a row between two columns (inclusive).
+             *
+             * @param row       - a valid row index.
+             * @param first_col - the first column to search from. must be non-negative.
+             * @param last_col  - the last column to search. must be lesser than the width.
+             *
+             * @return
+             *      the column of the first set bit, or -1 if there is no such bit.
+             */
+            int findNextInRow(int row, int first_col, int last_col) const;
+
+            /**
+             * getMemoryUsage: the number of bytes used by the bits of the bitboard.
+             */
+            size_t getMemoryUsage() const;
+
+            /**
+             * getAllocationsCount: the number of blocks the bits of the bitboard are allocated in.
+             */
+            size_t getAllocationsCount() const;
+
+        private:
+            /**
+             * loadWord, storeWord: read or write a word by its index (row * words per row + word in the row).
+             *                      a sparse bitboard keeps only the words that are not 0.
+             */
+            uint64_t loadWord(uint64_t index) const;
+            void storeWord(uint64_t index, uint64_t word);
+
+            uint64_t getIndex(int row, int word_index) const;
+
+            /**
+             * maskWord: masks the bits of a row's word to the columns [first_col, last_col].
+             */
+            static uint64_t maskWord(uint64_t word, int word_index, int first_col, int last_col);
+
+            /**
+             * getWord: returns the bits of a row's word, masked to the columns [first_col, last_col].
+             */
+            uint64_t getWord(int row, int word_index, int first_col, int last_col) const;
+    };
+}
+
+#endif
@@ -25,6 +25,11 @@ namespace mtm {
         return type;
     }
 
+    UnitTypeId Character::getTypeId() const
+    {
+        return UnitTypeId(type);
+    }
+
     bool Character::isAlive()
     {
         return health > 0;
@@ -40,9 +45,19 @@ namespace mtm {
         return max_movement_units;
     }
 
-    bool Character::exists(const Character& character)
+    units_t Character::getHealth() const
     {
-        return &character != nullptr;
+        return health;
+    }
+
+    units_t Character::getAmmo() const
+    {
+        return ammo;
+    }
+
+    units_t Character::getPower() const
+    {
+        return power;
     }
 
     void Character::addHealth(units_t value)
@@ -55,11 +70,40 @@ namespace mtm {
         ammo += reload_value;
     }
 
-    bool Character::hasAmmoToAttack(const Character& other)
+    void Character::restore(units_t health, units_t ammo)
+    {
+        this->health = health;
+        this->ammo = ammo;
+    }
+
+    bool Character::hasAmmoToAttack(const Character*)
+    {
+        return hasAmmo();
+    }
+
+    bool Character::hasAmmo() const
     {
         return ammo >= attack_cost;
     }
 
+    int Character::getSplashRadius() const
+    {
+        return 0;
+    }
+
+    size_t Character::getObjectSize() const
+    {
+        return sizeof(Character);
+    }
+
+    int Character::getAttackCounter() const
+    {
+        return 0;
+    }
+
+    void Character::setAttackCounter(int)
+    {}
+
     bool Character::isInAttackRange2(const GridPoint& src, const GridPoint& dst)
     {
         return true;
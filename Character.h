@@ -2,6 +2,10 @@
 #define CHARACTER_H
 
 #include "Auxiliaries.h"
+#include "MemoryTracker.h"
+#include "UnitRule.h"
+
+#include <memory>
 
 namespace mtm {
 
@@ -27,10 +31,30 @@ namespace mtm {
             */
             virtual Character* clone() = 0;
 
+            /**
+            * cloneShared: create a clone of the current character, allocated together with its shared_ptr
+            *              control block (see std::allocate_shared).
+            *
+            * @param allocator - the allocator of the clone and its control block.
+            *
+            * @return
+            *      a shared pointer to the new created character.
+            */
+            virtual std::shared_ptr<Character> cloneShared(const TrackingAllocator<Character>& allocator) const = 0;
+
+            /**
+            * getObjectSize: the size of the character's object, for memory accounting.
+            *
+            * @return
+            *      sizeof the character's most derived class.
+            */
+            virtual size_t getObjectSize() const;
+
             /**
             * ~Character: delete current character.
+            *             virtual, as the characters are deleted through pointers to Character.
             */
-            ~Character() = default;
+            virtual ~Character() = default;
 
             /**
             * getTeam: checks which team the current character belongs to. 
@@ -48,6 +72,15 @@ namespace mtm {
             */
             CharacterType getType() const;
 
+            /**
+            * getTypeId: the id of the character's type in a UnitTypeRegistry. unlike getType, it tells apart
+            *            the types a registry defines on top of the same built-in type.
+            *
+            * @return
+            *     UnitTypeId - the id of the type. the built-in types have the ids of their CharacterType.
+            */
+            virtual UnitTypeId getTypeId() const;
+
             /**
             * getAttackRange: checks what is the attack range of the current character. 
             *
@@ -64,6 +97,30 @@ namespace mtm {
             *     an unit_t (int) representing the maximum allowed movment units.
             */
             int getTravelDistance() const;
+
+            /**
+            * getHealth: checks how many health units the current character has.
+            *
+            * @return
+            *     the health units of the character.
+            */
+            units_t getHealth() const;
+
+            /**
+            * getAmmo: checks how many ammo units the current character has.
+            *
+            * @return
+            *     the ammo units of the character.
+            */
+            units_t getAmmo() const;
+
+            /**
+            * getPower: checks what is the attack power of the current character.
+            *
+            * @return
+            *     the power of the character.
+            */
+            units_t getPower() const;
             
             /**
             * isAlive- checks if the current character is still alive- 
@@ -87,6 +144,14 @@ namespace mtm {
             */
             void reload();
 
+            /**
+            * restore - overwrites the health and the ammo of the current character (used to patch a game's state).
+            *
+            * @param health - the new amount of health units.
+            * @param ammo   - the new amount of ammo units.
+            */
+            void restore(units_t health, units_t ammo);
+
             /**
             * convertToChar - gets the symbol of the character, 'm'-medic, 's'- soldier, 'n'- sniper.
             *                 upper case letter if the character is in the "powerlifters" team,
@@ -97,16 +162,16 @@ namespace mtm {
             char convertToChar() const;
 
             /** 
-            * attack: gets a reference to a slot on the board (character) and attacks it
+            * attack: gets a slot on the board (character) and attacks it
             *         according to the attack  rules of the relevant type of character.
             *
-            * @param other - a reference to the character we want to attack.
+            * @param other - a pointer to the character we want to attack, nullptr if the attacked cell is empty.
             *
             * @return
             *       false if attack failed, 
             *       true if the attack was successful 
             */
-            virtual bool attack(Character& other) = 0;
+            virtual bool attack(Character* other) = 0;
             
             /** 
             * canAttackEmptyCell - checks if the current character can attack an empty slot,
@@ -141,16 +206,61 @@ namespace mtm {
             */
             virtual void attackNearbyCharacter(Character& other) const {};
 
+            /** 
+            * getSplashRadius: checks the Manhattan radius around an attacked cell in which enemies
+            *                  are attacked by attackNearbyCharacter.
+            *
+            * @return
+            *       the splash radius. 0 (the default) if the character has no splash.
+            */
+            virtual int getSplashRadius() const;
+
+            /** 
+            * getAttackCounter: checks the state of the character's damage cadence (the sniper's hits counter).
+            *
+            * @return
+            *       the counter. 0 (the default) if the character has no cadence.
+            */
+            virtual int getAttackCounter() const;
+
+            /** 
+            * setAttackCounter: overwrites the state of the character's damage cadence (used to patch a game's state).
+            * does nothing (the default) if the character has no cadence.
+            *
+            * @param counter - a counter, as returned by getAttackCounter.
+            */
+            virtual void setAttackCounter(int counter);
+
             /** 
             * hasAmmoToAttack: checks if the current character has enough ammo to attack
             *
-            * @param other - a reference to the coordinates of the attacked character
+            * @param other - a pointer to the attacked character, nullptr if the attacked cell is empty.
             *
             * @return
             *       false if the current character doesn't have enough ammo, 
             *       true  if the current character does    have enough ammo.
             */
-            virtual bool hasAmmoToAttack(const Character& other);
+            virtual bool hasAmmoToAttack(const Character* other);
+
+            /** 
+            * hasAmmo: checks if the current character has enough ammo for a single attack (attack_cost).
+            *
+            * @return
+            *       false if the current character doesn't have enough ammo, 
+            *       true  if the current character does    have enough ammo.
+            */
+            bool hasAmmo() const;
+
+            /** 
+            * isLegalTarget: checks if the type of the current character allows attacking a target,
+            *                without changing any of the characters.
+            *
+            * @param other - a pointer to the attacked character, nullptr if the attacked cell is empty.
+            *
+            * @return
+            *       true if attack(other) would succeed, false otherwise.
+            */
+            virtual bool isLegalTarget(const Character* other) const = 0;
 
             /** 
             * isInAttackRange2: checks (again) if an attacked character is in the range of an attacking character.
@@ -167,19 +277,6 @@ namespace mtm {
             *       In my opinion Your logic is flawed, therefore I've added this flawed method as a silent protest :)
             */
             virtual bool isInAttackRange2(const GridPoint& src, const GridPoint& dst);
-
-            /** 
-            * exists: checks if the character exists.
-            *
-            * @param character - a reference to the character
-            *
-            * @return
-            *       false if the character is null. else, returns true.
-            * 
-            * NOTE: the function is static because an object's method guarranties that the object isn't nullptr,
-            *       therefore a non-static method won't be useful at all.
-            */
-            static bool exists(const Character& character);
         
         protected:
 
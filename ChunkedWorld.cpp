@@ -0,0 +1,359 @@
+#include "ChunkedWorld.h"
+
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace mtm {
+
+    const int ChunkedWorld::CHUNK_BITS;
+    const int ChunkedWorld::CHUNK_SIZE;
+    const int64_t ChunkedWorld::LOCAL_MASK;
+    const int64_t ChunkedWorld::MAX_SIZE;
+
+    WorldPoint::WorldPoint(int64_t row, int64_t col) :
+        row(row),
+        col(col)
+    {}
+
+    bool WorldPoint::operator==(const WorldPoint& other) const
+    {
+        return row == other.row && col == other.col;
+    }
+
+    int64_t WorldPoint::distance(const WorldPoint& a, const WorldPoint& b)
+    {
+        return std::llabs(a.row - b.row) + std::llabs(a.col - b.col);
+    }
+
+    ChunkedWorld::Chunk::Chunk() :
+        occupancy(),
+        units()
+    {}
+
+    bool ChunkedWorld::Chunk::test(int row, int col) const
+    {
+        return (occupancy[row] >> col) & 1;
+    }
+
+    size_t ChunkedWorld::Chunk::getRank(int row, int col) const
+    {
+        size_t rank = 0;
+        for (int i = 0; i < row; ++i) {
+            rank += __builtin_popcountll(occupancy[i]);
+        }
+        return rank + __builtin_popcountll(occupancy[row] & ((uint64_t(1) << col) - 1));
+    }
+
+    CompactUnit* ChunkedWorld::Chunk::find(int row, int col)
+    {
+        return test(row, col) ? &units[getRank(row, col)] : nullptr;
+    }
+
+    void ChunkedWorld::Chunk::insert(int row, int col, const CompactUnit& unit)
+    {
+        units.insert(units.begin() + getRank(row, col), unit);
+        occupancy[row] |= uint64_t(1) << col;
+    }
+
+    void ChunkedWorld::Chunk::erase(int row, int col)
+    {
+        units.erase(units.begin() + getRank(row, col));
+        occupancy[row] &= ~(uint64_t(1) << col);
+
+        // the units' storage is trimmed once most of it is unused.
+        if (units.capacity() > 2 * units.size() + 8) {
+            units.shrink_to_fit();
+        }
+    }
+
+    ChunkedWorld::ChunkedWorld() :
+        height(0),
+        width(0),
+        units_count(0),
+        chunks()
+    {}
+
+    ChunkedWorld::ChunkedWorld(int64_t height, int64_t width) :
+        height(height),
+        width(width),
+        units_count(0),
+        chunks()
+    {
+        if (height < 1 || width < 1 || height > MAX_SIZE || width > MAX_SIZE) {
+            throw IllegalArgument();
+        }
+    }
+
+    const char* ChunkedWorld::getName() const
+    {
+        return "chunked";
+    }
+
+    void ChunkedWorld::load(int height, int width, const std::vector<UnitDescriptor>& units)
+    {
+        if (height < 1 || width < 1) {
+            throw IllegalArgument();
+        }
+
+        this->height = height;
+        this->width = width;
+        units_count = 0;
+        chunks.clear();
+        for (const UnitDescriptor& unit : units) {
+            addUnit(WorldPoint(unit.coordinates.row, unit.coordinates.col), CompactUnit(unit));
+        }
+    }
+
+    CommandStatus ChunkedWorld::execute(const Command& command)
+    {
+        const WorldPoint src(command.src.row, command.src.col);
+        const WorldPoint dst(command.dst.row, command.dst.col);
+        switch (command.type)
+        {
+            case MOVE_COMMAND:   return move(src, dst);
+            case ATTACK_COMMAND: return attack(src, dst);
+            case RELOAD_COMMAND: return reload(src);
+            default: return ILLEGAL_ARGUMENT;
+        }
+    }
+
+    void ChunkedWorld::getState(std::vector<UnitState>& state) const
+    {
+        state.clear();
+        for (const auto& entry : chunks) {
+            const Chunk& chunk = *entry.second;
+            int64_t first_row = int64_t(entry.first >> 32) << CHUNK_BITS;
+            int64_t first_col = int64_t(entry.first & 0xFFFFFFFF) << CHUNK_BITS;
+
+            size_t rank = 0;
+            for (int row = 0; row < CHUNK_SIZE; ++row) {
+                for (uint64_t word = chunk.occupancy[row]; word != 0; word &= word - 1) {
+                    const CompactUnit& unit = chunk.units[rank++];
+                    const UnitRule& rule = CompactUnit::getBuiltinRule(unit.getType());
+                    state.push_back(UnitState(GridPoint(int(first_row + row), int(first_col + __builtin_ctzll(word))),
+                                              unit.getSymbol(rule), unit.getHealth(), unit.getAmmo(),
+                                              rule.cadence_period > 0 ? unit.getAttackCounter() : 0));
+                }
+            }
+        }
+
+        std::sort(state.begin(), state.end(), [](const UnitState& a, const UnitState& b) {
+            return ComparePoints()(a.coordinates, b.coordinates);
+        });
+    }
+
+    void ChunkedWorld::addUnit(const WorldPoint& coordinates, const CompactUnit& unit)
+    {
+        if (!unit.isAlive()) {
+            throw IllegalArgument();
+        }
+        if (isOutOfBound(coordinates)) {
+            throw IllegalCell();
+        }
+
+        std::unique_ptr<Chunk>& chunk = chunks[getChunkKey(coordinates)];
+        if (chunk == nullptr) {
+            chunk.reset(new Chunk());
+        }
+        int row = int(coordinates.row & LOCAL_MASK);
+        int col = int(coordinates.col & LOCAL_MASK);
+        if ((*chunk).test(row, col)) {
+            throw CellOccupied();
+        }
+
+        (*chunk).insert(row, col, unit);
+        ++units_count;
+    }
+
+    const CompactUnit* ChunkedWorld::getUnit(const WorldPoint& coordinates) const
+    {
+        return isOutOfBound(coordinates) ? nullptr : findUnit(coordinates);
+    }
+
+    CommandStatus ChunkedWorld::move(const WorldPoint& src, const WorldPoint& dst)
+    {
+        if (isOutOfBound(src) || isOutOfBound(dst)) {
+            return ILLEGAL_CELL;
+        }
+        const CompactUnit* unit = findUnit(src);
+        if (unit == nullptr) {
+            return CELL_EMPTY;
+        }
+        if (WorldPoint::distance(src, dst) > CompactUnit::getBuiltinRule((*unit).getType()).movement) {
+            return MOVE_TOO_FAR;
+        }
+        if (findUnit(dst) != nullptr) {
+            return CELL_OCCUPIED;
+        }
+
+        CompactUnit moved = *unit;
+        removeUnit(src);
+        addUnit(dst, moved);
+        return SUCCESS;
+    }
+
+    CommandStatus ChunkedWorld::attack(const WorldPoint& src, const WorldPoint& dst)
+    {
+        if (isOutOfBound(src) || isOutOfBound(dst)) {
+            return ILLEGAL_CELL;
+        }
+        CompactUnit* attacker = findUnit(src);
+        if (attacker == nullptr) {
+            return CELL_EMPTY;
+        }
+
+        // the kernel gets the cells relative to the attacker, as they may not fit a GridPoint.
+        // a target farther than any range a compact unit can hold is out of range anyway.
+        const UnitRule& rule = CompactUnit::getBuiltinRule((*attacker).getType());
+        if (WorldPoint::distance(src, dst) > CompactUnit::MAX_VALUE) {
+            return OUT_OF_RANGE;
+        }
+        const GridPoint origin(0, 0);
+        const GridPoint target_point(int(dst.row - src.row), int(dst.col - src.col));
+        if (!(*attacker).isInAttackRange(rule, origin, target_point)) {
+            return OUT_OF_RANGE;
+        }
+
+        CompactUnit* target = findUnit(dst);
+        if (!(*attacker).hasAmmoToAttack(rule, target)) {
+            return OUT_OF_AMMO;
+        }
+        if (!(*attacker).isInAttackLine(rule, origin, target_point) || !(*attacker).attack(rule, target)) {
+            return ILLEGAL_TARGET;
+        }
+
+        // the attacker is copied, as the units of its chunk move when a splash removes one of them.
+        const CompactUnit splashing = *attacker;
+        if (splashing.getSplashRadius(rule) > 0) {
+            attackNearbyUnits(splashing, rule, dst);
+        }
+        if (target != nullptr && !(*findUnit(dst)).isAlive()) {
+            removeUnit(dst);
+        }
+        return SUCCESS;
+    }
+
+    CommandStatus ChunkedWorld::reload(const WorldPoint& coordinates)
+    {
+        if (isOutOfBound(coordinates)) {
+            return ILLEGAL_CELL;
+        }
+        CompactUnit* unit = findUnit(coordinates);
+        if (unit == nullptr) {
+            return CELL_EMPTY;
+        }
+
+        (*unit).reload(CompactUnit::getBuiltinRule((*unit).getType()));
+        return SUCCESS;
+    }
+
+    int64_t ChunkedWorld::getHeight() const
+    {
+        return height;
+    }
+
+    int64_t ChunkedWorld::getWidth() const
+    {
+        return width;
+    }
+
+    size_t ChunkedWorld::getUnitsCount() const
+    {
+        return units_count;
+    }
+
+    size_t ChunkedWorld::getChunksCount() const
+    {
+        return chunks.size();
+    }
+
+    size_t ChunkedWorld::getMemoryUsage() const
+    {
+        // a node of the index holds its key, its pointer, a next pointer and the cached hash.
+        size_t bytes = chunks.bucket_count() * sizeof(void*) +
+                       chunks.size() * (sizeof(uint64_t) + 3 * sizeof(void*) + sizeof(Chunk));
+        for (const auto& entry : chunks) {
+            bytes += (*entry.second).units.capacity() * sizeof(CompactUnit);
+        }
+        return bytes;
+    }
+
+    bool ChunkedWorld::isOutOfBound(const WorldPoint& coordinates) const
+    {
+        return (coordinates.col < 0 || coordinates.row < 0 ||
+                coordinates.col >= width || coordinates.row >= height);
+    }
+
+    uint64_t ChunkedWorld::getChunkKey(const WorldPoint& coordinates)
+    {
+        return (uint64_t(coordinates.row >> CHUNK_BITS) << 32) | uint64_t(coordinates.col >> CHUNK_BITS);
+    }
+
+    ChunkedWorld::Chunk* ChunkedWorld::findChunk(const WorldPoint& coordinates) const
+    {
+        auto chunk = chunks.find(getChunkKey(coordinates));
+        return chunk != chunks.end() ? (*chunk).second.get() : nullptr;
+    }
+
+    CompactUnit* ChunkedWorld::findUnit(const WorldPoint& coordinates) const
+    {
+        Chunk* chunk = findChunk(coordinates);
+        return chunk != nullptr ? (*chunk).find(int(coordinates.row & LOCAL_MASK), int(coordinates.col & LOCAL_MASK))
+                                : nullptr;
+    }
+
+    void ChunkedWorld::removeUnit(const WorldPoint& coordinates)
+    {
+        auto chunk = chunks.find(getChunkKey(coordinates));
+        (*(*chunk).second).erase(int(coordinates.row & LOCAL_MASK), int(coordinates.col & LOCAL_MASK));
+        --units_count;
+        if ((*(*chunk).second).units.empty()) {
+            chunks.erase(chunk);
+        }
+    }
+
+    void ChunkedWorld::attackNearbyUnits(const CompactUnit& attacker, const UnitRule& rule, const WorldPoint& dst)
+    {
+        int64_t radius = attacker.getSplashRadius(rule);
+        int64_t first_row = std::max(int64_t(0), dst.row - radius);
+        int64_t last_row = std::min(height - 1, dst.row + radius);
+        for (int64_t row = first_row; row <= last_row; ++row) {
+            int64_t span = radius - std::llabs(row - dst.row);
+            int64_t first_col = std::max(int64_t(0), dst.col - span);
+            int64_t last_col = std::min(width - 1, dst.col + span);
+
+            // the row's span is split by the chunks it overlaps, each scanned through its occupancy word.
+            for (int64_t chunk_col = first_col; chunk_col <= last_col; chunk_col = (chunk_col | LOCAL_MASK) + 1) {
+                Chunk* chunk = findChunk(WorldPoint(row, chunk_col));
+                if (chunk == nullptr) {
+                    continue;
+                }
+
+                int local_row = int(row & LOCAL_MASK);
+                int low = int(chunk_col & LOCAL_MASK);
+                int high = int(std::min(last_col, chunk_col | LOCAL_MASK) & LOCAL_MASK);
+                uint64_t word = (*chunk).occupancy[local_row] >> low;
+                word &= high - low == 63 ? ~uint64_t(0) : (uint64_t(1) << (high - low + 1)) - 1;
+                for (; word != 0; word &= word - 1) {
+                    const WorldPoint coordinates(row, (chunk_col & ~LOCAL_MASK) + low + __builtin_ctzll(word));
+                    if (coordinates == dst) {
+                        continue;
+                    }
+
+                    CompactUnit& unit = *(*chunk).find(local_row, int(coordinates.col & LOCAL_MASK));
+                    attacker.attackNearbyUnit(rule, unit);
+                    if (!unit.isAlive()) {
+                        // the chunk is freed with its last unit, which leaves nothing else to scan in it.
+                        bool is_last = (*chunk).units.size() == 1;
+                        removeUnit(coordinates);
+                        if (is_last) {
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,165 @@
+#ifndef CHUNKED_WORLD_H
+#define CHUNKED_WORLD_H
+
+#include "GameEngine.h"
+#include "CompactUnit.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * WorldPoint - the coordinates of a cell of a ChunkedWorld, wide enough for boards far beyond int's range.
+     */
+    struct WorldPoint
+    {
+        int64_t row;
+        int64_t col;
+
+        WorldPoint(int64_t row, int64_t col);
+
+        bool operator==(const WorldPoint& other) const;
+
+        /**
+         * distance: the Manhattan distance between two cells, as GridPoint::distance.
+         */
+        static int64_t distance(const WorldPoint& a, const WorldPoint& b);
+    };
+
+    /**
+     * ChunkedWorld - a sparse board of CompactUnits for open worlds, up to MAX_SIZE cells in each dimension.
+     *
+     * The board is split into CHUNK_SIZE x CHUNK_SIZE chunks, allocated when their first unit arrives and freed
+     * when their last unit leaves, so the memory stays proportional to the occupied chunks and their units.
+     * A chunk keeps a bit per cell and its units packed in the order of their cells, found by the rank of their bit,
+     * so a chunk with a single unit costs about 600 bytes, and its units' storage is trimmed as they leave.
+     * Every action looks up only the chunks of the cells it touches; a splash scans the occupancy words of the
+     * chunks its diamond overlaps.
+     *
+     * The actions follow Game's semantics and order of checks, as evaluated by the rule kernel (see CompactEngine.h),
+     * so a world whose dimensions fit an int is also a GameEngine, comparable to Game (see DifferentialHarness.h).
+     */
+    class ChunkedWorld : public GameEngine
+    {
+        static const int CHUNK_BITS = 6;
+        static const int CHUNK_SIZE = 1 << CHUNK_BITS;
+        static const int64_t LOCAL_MASK = CHUNK_SIZE - 1; // the bits of a cell's coordinates within its chunk.
+
+        /**
+         * Chunk - the cells of a chunk: a row of CHUNK_SIZE bits per word, and the units of the set bits.
+         */
+        struct Chunk
+        {
+            uint64_t occupancy[CHUNK_SIZE];
+            std::vector<CompactUnit> units;
+
+            Chunk();
+
+            bool test(int row, int col) const;
+
+            /**
+             * getRank: the number of occupied cells before a cell, in row by row order.
+             */
+            size_t getRank(int row, int col) const;
+
+            CompactUnit* find(int row, int col);
+            void insert(int row, int col, const CompactUnit& unit);
+            void erase(int row, int col);
+        };
+
+        int64_t height;
+        int64_t width;
+        size_t units_count;
+        std::unordered_map<uint64_t, std::unique_ptr<Chunk>> chunks;
+
+        public:
+            /**
+             * the largest dimension of a world: the coordinates of a chunk must fit 32 bits each.
+             */
+            static const int64_t MAX_SIZE = int64_t(1) << (32 + CHUNK_BITS);
+
+            /**
+             * ChunkedWorld constructor: creates an empty world of 0x0 cells, to be loaded (see load).
+             */
+            ChunkedWorld();
+
+            /**
+             * ChunkedWorld constructor: creates an empty world of the given dimensions.
+             *
+             * @throw
+             *     IllegalArgument - if a dimension is non-positive or above MAX_SIZE.
+             */
+            ChunkedWorld(int64_t height, int64_t width);
+
+            const char* getName() const override;
+            void load(int height, int width, const std::vector<UnitDescriptor>& units) override;
+            CommandStatus execute(const Command& command) override;
+            void getState(std::vector<UnitState>& state) const override;
+
+            /**
+             * addUnit: puts a unit in an empty cell.
+             *
+             * @throw
+             *     IllegalArgument - if the unit is dead.
+             *     IllegalCell     - if the cell is not within the world's range.
+             *     CellOccupied    - if the cell is occupied.
+             */
+            void addUnit(const WorldPoint& coordinates, const CompactUnit& unit);
+
+            /**
+             * getUnit: returns the unit of a cell, nullptr if the cell is empty or out of the world's range.
+             * the pointer is invalidated by the next change of the world.
+             */
+            const CompactUnit* getUnit(const WorldPoint& coordinates) const;
+
+            /**
+             * move, attack, reload: the actions of a unit, as described in Game.h.
+             *
+             * @return
+             *     SUCCESS, or the status matching the exception Game would throw (nothing is changed).
+             */
+            CommandStatus move(const WorldPoint& src, const WorldPoint& dst);
+            CommandStatus attack(const WorldPoint& src, const WorldPoint& dst);
+            CommandStatus reload(const WorldPoint& coordinates);
+
+            int64_t getHeight() const;
+            int64_t getWidth() const;
+
+            /**
+             * getUnitsCount: the number of units of the world.
+             */
+            size_t getUnitsCount() const;
+
+            /**
+             * getChunksCount: the number of allocated chunks (those holding at least one unit).
+             */
+            size_t getChunksCount() const;
+
+            /**
+             * getMemoryUsage: an estimate of the bytes used by the chunks, their units and the chunks' index.
+             */
+            size_t getMemoryUsage() const;
+
+        private:
+            bool isOutOfBound(const WorldPoint& coordinates) const;
+
+            static uint64_t getChunkKey(const WorldPoint& coordinates);
+            Chunk* findChunk(const WorldPoint& coordinates) const;
+            CompactUnit* findUnit(const WorldPoint& coordinates) const;
+
+            /**
+             * removeUnit: empties an occupied cell, freeing its chunk if it was its last unit.
+             */
+            void removeUnit(const WorldPoint& coordinates);
+
+            /**
+             * attackNearbyUnits: makes a unit's splash hit the enemies around an attacked cell, removing the killed ones.
+             */
+            void attackNearbyUnits(const CompactUnit& attacker, const UnitRule& rule, const WorldPoint& dst);
+    };
+}
+
+#endif
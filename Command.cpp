@@ -0,0 +1,112 @@
+#include "Command.h"
+
+#include "Exceptions.h"
+
+namespace mtm {
+
+    Command::Command() :
+        type(RELOAD_COMMAND),
+        src(0, 0),
+        dst(0, 0)
+    {}
+
+    Command::Command(CommandType type, const GridPoint& src, const GridPoint& dst) :
+        type(type),
+        src(src),
+        dst(dst)
+    {}
+
+    /**
+     * runAction: runs a game action, translating the game's exceptions to a status.
+     */
+    template <class Action>
+    static CommandStatus runAction(Action action)
+    {
+        try {
+            action();
+        }
+        catch (const IllegalArgument&) { return ILLEGAL_ARGUMENT; }
+        catch (const IllegalCell&)     { return ILLEGAL_CELL;     }
+        catch (const CellEmpty&)       { return CELL_EMPTY;       }
+        catch (const MoveTooFar&)      { return MOVE_TOO_FAR;     }
+        catch (const CellOccupied&)    { return CELL_OCCUPIED;    }
+        catch (const OutOfRange&)      { return OUT_OF_RANGE;     }
+        catch (const OutOfAmmo&)       { return OUT_OF_AMMO;      }
+        catch (const IllegalTarget&)   { return ILLEGAL_TARGET;   }
+
+        return SUCCESS;
+    }
+
+    CommandStatus executeCommand(Game& game, const Command& command)
+    {
+        switch (command.type)
+        {
+            case MOVE_COMMAND:   return runAction([&]() { game.move(command.src, command.dst);   });
+            case ATTACK_COMMAND: return runAction([&]() { game.attack(command.src, command.dst); });
+            case RELOAD_COMMAND: return runAction([&]() { game.reload(command.src);              });
+            default: return ILLEGAL_ARGUMENT;
+        }
+    }
+
+    CommandStatus applyAttackCommand(Game& game, const Command& command, AttackOutcome& outcome)
+    {
+        outcome.clear();
+        return runAction([&]() { game.applyAttack(command.src, command.dst, outcome); });
+    }
+
+    static void writeInt(int32_t value, uint8_t* buffer)
+    {
+        uint32_t bits = uint32_t(value);
+        for (int i = 0; i < 4; ++i) {
+            buffer[i] = uint8_t(bits >> (8 * i));
+        }
+    }
+
+    static int32_t readInt(const uint8_t* buffer)
+    {
+        uint32_t bits = 0;
+        for (int i = 0; i < 4; ++i) {
+            bits |= uint32_t(buffer[i]) << (8 * i);
+        }
+        return int32_t(bits);
+    }
+
+    size_t encodeCommand(const Command& command, uint8_t* buffer)
+    {
+        buffer[0] = uint8_t(command.type);
+        writeInt(command.src.row, buffer + 1);
+        writeInt(command.src.col, buffer + 5);
+        writeInt(command.dst.row, buffer + 9);
+        writeInt(command.dst.col, buffer + 13);
+        return COMMAND_ENCODED_SIZE;
+    }
+
+    bool decodeCommand(const uint8_t* buffer, size_t size, Command& command)
+    {
+        if (buffer == nullptr || size != COMMAND_ENCODED_SIZE || buffer[0] > RELOAD_COMMAND) {
+            return false;
+        }
+
+        command = Command(CommandType(buffer[0]),
+                          GridPoint(readInt(buffer + 1), readInt(buffer + 5)),
+                          GridPoint(readInt(buffer + 9), readInt(buffer + 13)));
+        return true;
+    }
+
+    const char* getStatusName(CommandStatus status)
+    {
+        switch (status)
+        {
+            case SUCCESS:          return "Success";
+            case ILLEGAL_ARGUMENT: return "IllegalArgument";
+            case ILLEGAL_CELL:     return "IllegalCell";
+            case CELL_EMPTY:       return "CellEmpty";
+            case MOVE_TOO_FAR:     return "MoveTooFar";
+            case CELL_OCCUPIED:    return "CellOccupied";
+            case OUT_OF_RANGE:     return "OutOfRange";
+            case OUT_OF_AMMO:      return "OutOfAmmo";
+            case ILLEGAL_TARGET:   return "IllegalTarget";
+            default:               return "Unknown";
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include "Game.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mtm {
+
+    /**
+     * CommandType - the kind of action a command asks the game to perform.
+     */
+    enum CommandType { MOVE_COMMAND, ATTACK_COMMAND, RELOAD_COMMAND };
+
+    /**
+     * CommandStatus - the result of executing a command.
+     *
+     * Every failure status matches one of the exceptions thrown by Game (see Exceptions.h),
+     * so callers that handle many commands do not need to use exceptions as their error channel.
+     */
+    enum CommandStatus
+    {
+        SUCCESS,
+        ILLEGAL_ARGUMENT,
+        ILLEGAL_CELL,
+        CELL_EMPTY,
+        MOVE_TOO_FAR,
+        CELL_OCCUPIED,
+        OUT_OF_RANGE,
+        OUT_OF_AMMO,
+        ILLEGAL_TARGET
+    };
+
+    /**
+     * Command - a single player action against a Game.
+     *
+     * src is the acting character's coordinates, dst is the destination of a move or an attack.
+     * dst is ignored by RELOAD_COMMAND.
+     */
+    struct Command
+    {
+        CommandType type;
+        GridPoint src;
+        GridPoint dst;
+
+        /**
+         * Command constructor: creates a reload command of the cell (0, 0).
+         * exists so commands can be stored in preallocated buffers.
+         */
+        Command();
+
+        /**
+         * Command constructor: creates a new command.
+         *
+         * @param type - the kind of the action.
+         * @param src  - the coordinates of the acting character.
+         * @param dst  - the coordinates of the action's destination.
+         */
+        Command(CommandType type, const GridPoint& src, const GridPoint& dst);
+    };
+
+    /**
+     * executeCommand: performs a command on a game.
+     *
+     * @param game    - a reference to the game. must be non-nullptr.
+     * @param command - a reference to the command to perform.
+     * 
+     * @return
+     *     SUCCESS if the command was performed,
+     *     otherwise the status matching the exception thrown by the game (the game is left as the exception left it).
+     * 
+     * NOTE: the function does not throw any game related exceptions.
+     */
+    CommandStatus executeCommand(Game& game, const Command& command);
+
+    /**
+     * applyAttackCommand: applies an attack command on a game, leaving its outcome to commit (see Game::applyAttack).
+     *
+     * @param game    - a reference to the game. must be non-nullptr.
+     * @param command - a reference to the command to apply. must be an ATTACK_COMMAND.
+     * @param outcome - the result keeper. left empty if the attack failed.
+     *
+     * @return
+     *     SUCCESS if the attack was applied, otherwise the status matching the exception thrown by the game.
+     *
+     * NOTE: the function does not throw any game related exceptions.
+     */
+    CommandStatus applyAttackCommand(Game& game, const Command& command, AttackOutcome& outcome);
+
+    /**
+     * COMMAND_ENCODED_SIZE - the size in bytes of an encoded command:
+     * one byte of CommandType followed by src.row, src.col, dst.row, dst.col as little endian 32-bit integers.
+     */
+    const size_t COMMAND_ENCODED_SIZE = 1 + 4 * sizeof(int32_t);
+
+    /**
+     * encodeCommand: writes a command in its wire format.
+     *
+     * @param command - a reference to the command to encode.
+     * @param buffer  - the output buffer. must hold at least COMMAND_ENCODED_SIZE bytes.
+     *
+     * @return
+     *     the number of bytes written (COMMAND_ENCODED_SIZE).
+     */
+    size_t encodeCommand(const Command& command, uint8_t* buffer);
+
+    /**
+     * decodeCommand: reads a command from its wire format.
+     *
+     * @param buffer  - the encoded bytes.
+     * @param size    - the number of bytes in the buffer.
+     * @param command - the result keeper.
+     *
+     * @return
+     *     true if the buffer holds exactly one valid command, false otherwise (command is left unchanged).
+     */
+    bool decodeCommand(const uint8_t* buffer, size_t size, Command& command);
+
+    /**
+     * getStatusName: returns the name of a command status, matching the exception names of Exceptions.h.
+     */
+    const char* getStatusName(CommandStatus status);
+}
+
+#endif
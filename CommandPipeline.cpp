@@ -0,0 +1,264 @@
+#include "CommandPipeline.h"
+
+#include <utility>
+
+namespace mtm {
+
+    CommandChannel::CommandChannel(ThreadPool& pool) :
+        pool(pool),
+        messages(),
+        waiting_consumer(nullptr),
+        closed(false)
+    {}
+
+    void CommandChannel::push(Message message)
+    {
+        std::coroutine_handle<> consumer = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (closed) {
+                return;
+            }
+            messages.push_back(std::move(message));
+            std::swap(consumer, waiting_consumer);
+        }
+        wake(consumer);
+    }
+
+    void CommandChannel::close()
+    {
+        std::coroutine_handle<> consumer = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+            std::swap(consumer, waiting_consumer);
+        }
+        wake(consumer);
+    }
+
+    void CommandChannel::wake(std::coroutine_handle<> consumer)
+    {
+        if (consumer) {
+            pool.submit([consumer]() { consumer.resume(); });
+        }
+    }
+
+    CommandChannel::NextMessage CommandChannel::next()
+    {
+        return NextMessage{*this};
+    }
+
+    bool CommandChannel::NextMessage::await_ready() const noexcept
+    {
+        return false; // the queue is checked under the lock in await_suspend.
+    }
+
+    bool CommandChannel::NextMessage::await_suspend(std::coroutine_handle<> consumer)
+    {
+        std::lock_guard<std::mutex> lock(channel.mutex);
+        if (!channel.messages.empty() || channel.closed) {
+            return false; // resume immediately.
+        }
+        channel.waiting_consumer = consumer;
+        return true;
+    }
+
+    std::optional<Message> CommandChannel::NextMessage::await_resume()
+    {
+        std::lock_guard<std::mutex> lock(channel.mutex);
+        if (channel.messages.empty()) {
+            return std::nullopt; // closed and drained.
+        }
+        Message message = std::move(channel.messages.front());
+        channel.messages.pop_front();
+        return message;
+    }
+
+    SessionTask::promise_type::promise_type(GameSession& session) :
+        session(session)
+    {}
+
+    SessionTask SessionTask::promise_type::get_return_object()
+    {
+        return SessionTask(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    std::suspend_always SessionTask::promise_type::initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    SessionTask::promise_type::FinalAwaiter SessionTask::promise_type::final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    void SessionTask::promise_type::return_void() const noexcept
+    {}
+
+    void SessionTask::promise_type::unhandled_exception()
+    {
+        session.error = std::current_exception();
+    }
+
+    bool SessionTask::promise_type::FinalAwaiter::await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void SessionTask::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept
+    {
+        // the coroutine is suspended here, so the session may destroy its frame as soon as it is notified.
+        coroutine.promise().session.finish();
+    }
+
+    void SessionTask::promise_type::FinalAwaiter::await_resume() const noexcept
+    {}
+
+    SessionTask::SessionTask() :
+        coroutine(nullptr)
+    {}
+
+    SessionTask::SessionTask(std::coroutine_handle<promise_type> coroutine) :
+        coroutine(coroutine)
+    {}
+
+    SessionTask::SessionTask(SessionTask&& other) noexcept :
+        coroutine(std::exchange(other.coroutine, nullptr))
+    {}
+
+    SessionTask& SessionTask::operator=(SessionTask&& other) noexcept
+    {
+        if (this != &other) {
+            if (coroutine) {
+                coroutine.destroy();
+            }
+            coroutine = std::exchange(other.coroutine, nullptr);
+        }
+        return *this;
+    }
+
+    SessionTask::~SessionTask()
+    {
+        if (coroutine) {
+            coroutine.destroy();
+        }
+    }
+
+    std::coroutine_handle<SessionTask::promise_type> SessionTask::getHandle() const
+    {
+        return coroutine;
+    }
+
+    GameSession::GameSession(unsigned int id, const Game& initial_state, ThreadPool& pool) :
+        id(id),
+        game(initial_state),
+        pool(pool),
+        channel(pool),
+        subscribers(),
+        task(),
+        done(false),
+        error(nullptr)
+    {}
+
+    GameSession::~GameSession()
+    {
+        if (task.getHandle()) {
+            std::unique_lock<std::mutex> lock(done_mutex);
+            done_condition.wait(lock, [this]() { return done; });
+        }
+    }
+
+    CommandChannel& GameSession::getChannel()
+    {
+        return channel;
+    }
+
+    void GameSession::subscribe(BroadcastCallback callback)
+    {
+        subscribers.push_back(std::move(callback));
+    }
+
+    void GameSession::start()
+    {
+        task = run();
+        std::coroutine_handle<> coroutine = task.getHandle();
+        pool.submit([coroutine]() { coroutine.resume(); });
+    }
+
+    void GameSession::wait()
+    {
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done_condition.wait(lock, [this]() { return done; });
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    const Game& GameSession::getGame() const
+    {
+        return game;
+    }
+
+    void GameSession::finish()
+    {
+        std::lock_guard<std::mutex> lock(done_mutex);
+        done = true;
+        done_condition.notify_all();
+    }
+
+    SessionTask GameSession::run()
+    {
+        for (uint64_t sequence = 0; ; ++sequence)
+        {
+            std::optional<Message> message = co_await channel.next();
+            if (!message) {
+                break;
+            }
+
+            CommandBroadcast broadcast;
+            broadcast.session_id = id;
+            broadcast.sequence = sequence;
+            broadcast.winner = CROSSFITTERS;
+
+            // decode and validate. malformed messages are reported and skipped.
+            if (!decodeCommand(message->data(), message->size(), broadcast.command)) {
+                broadcast.status = ILLEGAL_ARGUMENT;
+            }
+            // apply.
+            else {
+                broadcast.status = executeCommand(game, broadcast.command);
+            }
+            broadcast.over = game.isOver(&broadcast.winner);
+
+            // broadcast.
+            for (const BroadcastCallback& subscriber : subscribers) {
+                subscriber(broadcast);
+            }
+        }
+    }
+
+    LoopbackProducer::LoopbackProducer(CommandChannel& channel) :
+        channel(channel)
+    {}
+
+    void LoopbackProducer::send(const Command& command)
+    {
+        Message message(COMMAND_ENCODED_SIZE);
+        encodeCommand(command, message.data());
+        channel.push(std::move(message));
+    }
+
+    void LoopbackProducer::sendRaw(const Message& message)
+    {
+        channel.push(message);
+    }
+
+    void LoopbackProducer::play(const std::vector<Command>& script)
+    {
+        for (const Command& command : script) {
+            send(command);
+        }
+        channel.close();
+    }
+}
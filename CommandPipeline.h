@@ -0,0 +1,272 @@
+#ifndef COMMAND_PIPELINE_H
+#define COMMAND_PIPELINE_H
+
+/**
+ * The command pipeline is built on C++20 coroutines, and must be compiled with -std=c++20.
+ */
+
+#include "Game.h"
+#include "Command.h"
+#include "ThreadPool.h"
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace mtm {
+
+    typedef std::vector<uint8_t> Message;
+
+    /**
+     * CommandChannel - an asynchronous queue of encoded commands with a single consuming coroutine.
+     *
+     * A consumer that finds the channel empty is suspended (its worker thread is released),
+     * and is resumed on the thread pool by the next push or by close.
+     * push and close are thread safe.
+     */
+    class CommandChannel
+    {
+        ThreadPool& pool;
+        std::mutex mutex;
+        std::deque<Message> messages;
+        std::coroutine_handle<> waiting_consumer;
+        bool closed;
+
+        public:
+            /**
+             * NextMessage - the awaitable returned by next().
+             *
+             * co_await-ing it returns the next message, or std::nullopt once the channel is closed and drained.
+             */
+            struct NextMessage
+            {
+                CommandChannel& channel;
+
+                bool await_ready() const noexcept;
+                bool await_suspend(std::coroutine_handle<> consumer);
+                std::optional<Message> await_resume();
+            };
+
+            /**
+             * CommandChannel constructor: creates an open, empty channel.
+             *
+             * @param pool - the thread pool that resumes the suspended consumer.
+             */
+            explicit CommandChannel(ThreadPool& pool);
+
+            CommandChannel(const CommandChannel& other) = delete;
+            CommandChannel& operator=(const CommandChannel& other) = delete;
+
+            /**
+             * push: adds a message to the channel. messages pushed after close are dropped.
+             */
+            void push(Message message);
+
+            /**
+             * close: marks the end of the stream. the consumer drains the remaining messages and stops.
+             */
+            void close();
+
+            /**
+             * next: waits (asynchronously) for the next message.
+             */
+            NextMessage next();
+
+        private:
+            /**
+             * wake: hands a suspended consumer (if any) to the thread pool.
+             */
+            void wake(std::coroutine_handle<> consumer);
+    };
+
+    /**
+     * CommandBroadcast - the record sent to the subscribers of a session after every message.
+     *
+     * sequence is the index of the message in the session's stream.
+     * if the message could not be decoded, status is ILLEGAL_ARGUMENT and command is a default command.
+     * winner is meaningful only if over is true.
+     */
+    struct CommandBroadcast
+    {
+        unsigned int session_id;
+        uint64_t sequence;
+        Command command;
+        CommandStatus status;
+        bool over;
+        Team winner;
+    };
+
+    typedef std::function<void(const CommandBroadcast&)> BroadcastCallback;
+
+    class GameSession;
+
+    /**
+     * SessionTask - the coroutine type of a session's pipeline.
+     *
+     * The coroutine starts suspended, and the session is notified when it reaches its end.
+     */
+    class SessionTask
+    {
+        public:
+            struct promise_type
+            {
+                GameSession& session;
+
+                struct FinalAwaiter
+                {
+                    bool await_ready() const noexcept;
+                    void await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept;
+                    void await_resume() const noexcept;
+                };
+
+                explicit promise_type(GameSession& session);
+
+                SessionTask get_return_object();
+                std::suspend_always initial_suspend() const noexcept;
+                FinalAwaiter final_suspend() const noexcept;
+                void return_void() const noexcept;
+                void unhandled_exception();
+            };
+
+            SessionTask();
+            explicit SessionTask(std::coroutine_handle<promise_type> coroutine);
+            SessionTask(SessionTask&& other) noexcept;
+            SessionTask& operator=(SessionTask&& other) noexcept;
+            SessionTask(const SessionTask& other) = delete;
+            SessionTask& operator=(const SessionTask& other) = delete;
+
+            /**
+             * SessionTask destructor: destroys the coroutine frame. the coroutine must be finished or never started.
+             */
+            ~SessionTask();
+
+            /**
+             * getHandle: the handle of the coroutine.
+             */
+            std::coroutine_handle<promise_type> getHandle() const;
+
+        private:
+            std::coroutine_handle<promise_type> coroutine;
+    };
+
+    /**
+     * GameSession - a game fed by a stream of encoded commands.
+     *
+     * The session's pipeline decodes every message, validates it, applies it to the game
+     * and broadcasts the result to the subscribers.
+     * Sessions run on a shared thread pool and overlap with each other,
+     * while the messages of a single session are always handled one after the other, in order.
+     */
+    class GameSession
+    {
+        unsigned int id;
+        Game game;
+        ThreadPool& pool;
+        CommandChannel channel;
+        std::vector<BroadcastCallback> subscribers;
+        SessionTask task;
+
+        std::mutex done_mutex;
+        std::condition_variable done_condition;
+        bool done;
+        std::exception_ptr error;
+
+        friend class SessionTask;
+
+        public:
+            /**
+             * GameSession constructor: creates a session that was not started yet.
+             *
+             * @param id            - the id of the session, copied to its broadcasts.
+             * @param initial_state - the game the session starts from. the session keeps its own copy.
+             * @param pool          - the thread pool running the session's pipeline.
+             */
+            GameSession(unsigned int id, const Game& initial_state, ThreadPool& pool);
+
+            GameSession(const GameSession& other) = delete;
+            GameSession& operator=(const GameSession& other) = delete;
+
+            /**
+             * GameSession destructor: waits for the pipeline to finish if it was started.
+             * NOTE: the channel must be closed before a started session is destroyed.
+             */
+            ~GameSession();
+
+            /**
+             * getChannel: the channel the session reads its commands from.
+             */
+            CommandChannel& getChannel();
+
+            /**
+             * subscribe: adds a callback that receives every broadcast of the session.
+             * callbacks run on the pool's threads, and must be thread safe if shared between sessions.
+             *
+             * NOTE: subscribers must be added before the session is started.
+             */
+            void subscribe(BroadcastCallback callback);
+
+            /**
+             * start: schedules the session's pipeline on the thread pool. a session may be started only once.
+             */
+            void start();
+
+            /**
+             * wait: blocks until the channel is closed and every message was handled.
+             *
+             * @throw
+             *     any exception that escaped the pipeline (for example, from a subscriber).
+             */
+            void wait();
+
+            /**
+             * getGame: the current state of the session's game. may be read only after wait().
+             */
+            const Game& getGame() const;
+
+        private:
+            /**
+             * run: the session's pipeline - decode, validate, apply and broadcast until the channel is closed.
+             */
+            SessionTask run();
+
+            /**
+             * finish: marks the pipeline as finished. called when the coroutine reaches its final suspension.
+             */
+            void finish();
+    };
+
+    /**
+     * LoopbackProducer - a local producer that feeds commands into a channel through the wire format,
+     * exactly as a remote client would.
+     */
+    class LoopbackProducer
+    {
+        CommandChannel& channel;
+
+        public:
+            explicit LoopbackProducer(CommandChannel& channel);
+
+            /**
+             * send: encodes a command and pushes it into the channel.
+             */
+            void send(const Command& command);
+
+            /**
+             * sendRaw: pushes raw bytes into the channel (used to exercise the decoding stage).
+             */
+            void sendRaw(const Message& message);
+
+            /**
+             * play: sends every command of a script, then closes the channel.
+             */
+            void play(const std::vector<Command>& script);
+    };
+}
+
+#endif
@@ -0,0 +1,166 @@
+#include "CompactEngine.h"
+
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace mtm {
+
+    CompactEngine::CompactEngine() :
+        height(0),
+        width(0),
+        cells()
+    {}
+
+    const char* CompactEngine::getName() const
+    {
+        return "compact";
+    }
+
+    void CompactEngine::load(int height, int width, const std::vector<UnitDescriptor>& units)
+    {
+        if (height < 1 || width < 1) {
+            throw IllegalArgument();
+        }
+
+        this->height = height;
+        this->width = width;
+        cells.assign(size_t(height) * size_t(width), CompactUnit());
+        for (const UnitDescriptor& unit : units) {
+            getCell(unit.coordinates) = CompactUnit(unit);
+        }
+    }
+
+    CommandStatus CompactEngine::execute(const Command& command)
+    {
+        switch (command.type)
+        {
+            case MOVE_COMMAND:   return move(command.src, command.dst);
+            case ATTACK_COMMAND: return attack(command.src, command.dst);
+            case RELOAD_COMMAND: return reload(command.src);
+            default: return ILLEGAL_ARGUMENT;
+        }
+    }
+
+    void CompactEngine::getState(std::vector<UnitState>& state) const
+    {
+        state.clear();
+        for (int row = 0; row < height; ++row) {
+            for (int col = 0; col < width; ++col) {
+                const GridPoint coordinates(row, col);
+                const CompactUnit& unit = getCell(coordinates);
+                if (!unit.isAlive()) {
+                    continue;
+                }
+
+                const UnitRule& rule = CompactUnit::getBuiltinRule(unit.getType());
+                state.push_back(UnitState(coordinates, unit.getSymbol(rule), unit.getHealth(), unit.getAmmo(),
+                                          rule.cadence_period > 0 ? unit.getAttackCounter() : 0));
+            }
+        }
+    }
+
+    bool CompactEngine::isOutOfBound(const GridPoint& coordinates) const
+    {
+        return (coordinates.col < 0 || coordinates.row < 0 ||
+                coordinates.col >= width || coordinates.row >= height);
+    }
+
+    CompactUnit& CompactEngine::getCell(const GridPoint& coordinates)
+    {
+        return cells[size_t(coordinates.row) * size_t(width) + size_t(coordinates.col)];
+    }
+
+    const CompactUnit& CompactEngine::getCell(const GridPoint& coordinates) const
+    {
+        return cells[size_t(coordinates.row) * size_t(width) + size_t(coordinates.col)];
+    }
+
+    CommandStatus CompactEngine::move(const GridPoint& src, const GridPoint& dst)
+    {
+        if (isOutOfBound(src) || isOutOfBound(dst)) {
+            return ILLEGAL_CELL;
+        }
+        if (!getCell(src).isAlive()) {
+            return CELL_EMPTY;
+        }
+        if (GridPoint::distance(src, dst) > CompactUnit::getBuiltinRule(getCell(src).getType()).movement) {
+            return MOVE_TOO_FAR;
+        }
+        if (getCell(dst).isAlive()) {
+            return CELL_OCCUPIED;
+        }
+
+        getCell(dst) = getCell(src);
+        getCell(src) = CompactUnit();
+        return SUCCESS;
+    }
+
+    CommandStatus CompactEngine::attack(const GridPoint& src, const GridPoint& dst)
+    {
+        if (isOutOfBound(src) || isOutOfBound(dst)) {
+            return ILLEGAL_CELL;
+        }
+        if (!getCell(src).isAlive()) {
+            return CELL_EMPTY;
+        }
+
+        CompactUnit& attacker = getCell(src);
+        const UnitRule& rule = CompactUnit::getBuiltinRule(attacker.getType());
+        if (!attacker.isInAttackRange(rule, src, dst)) {
+            return OUT_OF_RANGE;
+        }
+
+        CompactUnit* target = getCell(dst).isAlive() ? &getCell(dst) : nullptr;
+        if (!attacker.hasAmmoToAttack(rule, target)) {
+            return OUT_OF_AMMO;
+        }
+        if (!attacker.isInAttackLine(rule, src, dst) || !attacker.attack(rule, target)) {
+            return ILLEGAL_TARGET;
+        }
+
+        // a splashed unit is removed as soon as it dies (the splash skips the attacked cell, so no other hit
+        // depends on it), and the target after the splash, as Game commits its kills last.
+        int radius = attacker.getSplashRadius(rule);
+        int first_row = std::max(0, dst.row - radius);
+        int last_row  = std::min(height - 1, dst.row + radius);
+        for (int row = first_row; radius > 0 && row <= last_row; ++row) {
+            int span = radius - std::abs(row - dst.row);
+            int first_col = std::max(0, dst.col - span);
+            int last_col  = std::min(width - 1, dst.col + span);
+            for (int col = first_col; col <= last_col; ++col) {
+                const GridPoint coordinates(row, col);
+                if (!(coordinates == dst) && getCell(coordinates).isAlive()) {
+                    attacker.attackNearbyUnit(rule, getCell(coordinates));
+                    removeIfDead(coordinates);
+                }
+            }
+        }
+        if (target != nullptr) {
+            removeIfDead(dst);
+        }
+        return SUCCESS;
+    }
+
+    CommandStatus CompactEngine::reload(const GridPoint& coordinates)
+    {
+        if (isOutOfBound(coordinates)) {
+            return ILLEGAL_CELL;
+        }
+        if (!getCell(coordinates).isAlive()) {
+            return CELL_EMPTY;
+        }
+
+        CompactUnit& unit = getCell(coordinates);
+        unit.reload(CompactUnit::getBuiltinRule(unit.getType()));
+        return SUCCESS;
+    }
+
+    void CompactEngine::removeIfDead(const GridPoint& coordinates)
+    {
+        if (!getCell(coordinates).isAlive()) {
+            getCell(coordinates) = CompactUnit();
+        }
+    }
+}
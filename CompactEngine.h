@@ -0,0 +1,49 @@
+#ifndef COMPACT_ENGINE_H
+#define COMPACT_ENGINE_H
+
+#include "GameEngine.h"
+#include "CompactUnit.h"
+
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * CompactEngine - an engine keeping the board as a dense array of 12 bytes CompactUnits, one per cell.
+     *
+     * A cell is empty if its unit is not alive, so every lookup is a single array access, and the actions are
+     * evaluated by the rule kernel, in the same order of checks as Game's.
+     * Only the built-in types are supported. The stats saturate at CompactUnit::MAX_VALUE (see CompactUnit.h),
+     * where Game's do not.
+     */
+    class CompactEngine : public GameEngine
+    {
+        int height;
+        int width;
+        std::vector<CompactUnit> cells;
+
+        public:
+            CompactEngine();
+
+            const char* getName() const override;
+            void load(int height, int width, const std::vector<UnitDescriptor>& units) override;
+            CommandStatus execute(const Command& command) override;
+            void getState(std::vector<UnitState>& state) const override;
+
+        private:
+            bool isOutOfBound(const GridPoint& coordinates) const;
+            CompactUnit& getCell(const GridPoint& coordinates);
+            const CompactUnit& getCell(const GridPoint& coordinates) const;
+
+            CommandStatus move(const GridPoint& src, const GridPoint& dst);
+            CommandStatus attack(const GridPoint& src, const GridPoint& dst);
+            CommandStatus reload(const GridPoint& coordinates);
+
+            /**
+             * removeIfDead: empties a cell whose unit died.
+             */
+            void removeIfDead(const GridPoint& coordinates);
+    };
+}
+
+#endif
@@ -0,0 +1,186 @@
+#include "CompactUnit.h"
+
+#include "Exceptions.h"
+
+namespace mtm {
+
+    static_assert(sizeof(CompactUnit) == 12, "a compact unit must stay 12 bytes");
+
+    CompactUnit::CompactUnit() :
+        health(0),
+        ammo(0),
+        range(0),
+        power(0),
+        counter(1),
+        type(0),
+        team(0)
+    {}
+
+    CompactUnit::CompactUnit(UnitTypeId type, Team team, units_t health, units_t ammo, units_t range, units_t power) :
+        health(narrow(health)),
+        ammo(narrow(ammo)),
+        range(narrow(range)),
+        power(narrow(power)),
+        counter(1),
+        type(uint8_t(type)),
+        team(uint8_t(team == CROSSFITTERS))
+    {
+        if (health <= 0 || type < 0 || type > MAX_TYPE) {
+            throw IllegalArgument();
+        }
+    }
+
+    CompactUnit::CompactUnit(const UnitDescriptor& unit) :
+        CompactUnit(getBuiltinType(unit.type), unit.team, unit.health, unit.ammo, unit.range, unit.power)
+    {}
+
+    uint16_t CompactUnit::narrow(units_t value)
+    {
+        if (value < 0 || value > MAX_VALUE) {
+            throw IllegalArgument();
+        }
+        return uint16_t(value);
+    }
+
+    uint16_t CompactUnit::addSaturated(uint16_t stat, units_t value)
+    {
+        long long result = (long long)stat + value;
+        if (result < 0) {
+            return 0;
+        }
+        if (result > MAX_VALUE) {
+#ifdef COMPACT_UNIT_CHECKED
+            throw IllegalArgument();
+#else
+            return uint16_t(MAX_VALUE);
+#endif
+        }
+        return uint16_t(result);
+    }
+
+    UnitTypeId CompactUnit::getType() const
+    {
+        return type;
+    }
+
+    Team CompactUnit::getTeam() const
+    {
+        return team ? CROSSFITTERS : POWERLIFTERS;
+    }
+
+    units_t CompactUnit::getHealth() const
+    {
+        return health;
+    }
+
+    units_t CompactUnit::getAmmo() const
+    {
+        return ammo;
+    }
+
+    units_t CompactUnit::getRange() const
+    {
+        return range;
+    }
+
+    units_t CompactUnit::getPower() const
+    {
+        return power;
+    }
+
+    int CompactUnit::getAttackCounter() const
+    {
+        return counter;
+    }
+
+    bool CompactUnit::isAlive() const
+    {
+        return health > 0;
+    }
+
+    char CompactUnit::getSymbol(const UnitRule& rule) const
+    {
+        return char(rule.symbol + (team ? 'a' - 'A' : 0));
+    }
+
+    void CompactUnit::addHealth(units_t value)
+    {
+        health = addSaturated(health, value);
+    }
+
+    void CompactUnit::reload(const UnitRule& rule)
+    {
+        ammo = addSaturated(ammo, rule.reload_value);
+    }
+
+    bool CompactUnit::isInAttackRange(const UnitRule& rule, const GridPoint& src, const GridPoint& dst) const
+    {
+        return isInRuleRange(rule, range, src, dst);
+    }
+
+    bool CompactUnit::isInAttackLine(const UnitRule& rule, const GridPoint& src, const GridPoint& dst) const
+    {
+        return isInRuleLine(rule, src, dst);
+    }
+
+    bool CompactUnit::hasAmmoToAttack(const UnitRule& rule, const CompactUnit* other) const
+    {
+        return hasRuleAmmo(rule, ammo, other != nullptr, other != nullptr && team == (*other).team);
+    }
+
+    bool CompactUnit::isLegalTarget(const UnitRule& rule, const CompactUnit* other) const
+    {
+        return isRuleTarget(rule, other != nullptr, other == this, other != nullptr && team == (*other).team);
+    }
+
+    bool CompactUnit::attack(const UnitRule& rule, CompactUnit* other)
+    {
+        if (!isLegalTarget(rule, other)) {
+            return false;
+        }
+
+        bool exists = (other != nullptr);
+        bool same_team = exists && team == (*other).team;
+        if (exists && !same_team) {
+            int hits_counter = counter;
+            units_t damage = getRuleHitDamage(rule, power, hits_counter);
+            counter = uint16_t(hits_counter);
+            (*other).addHealth(-damage);
+        }
+        else if (same_team && rule.ally_effect == ALLY_HEAL) {
+            (*other).addHealth(power);
+        }
+
+        if (getRuleSpendsAmmo(rule, exists, same_team)) {
+            ammo = uint16_t(ammo - rule.attack_cost);
+        }
+        return true;
+    }
+
+    void CompactUnit::attackNearbyUnit(const UnitRule& rule, CompactUnit& other) const
+    {
+        if (team == other.team) {
+            return;
+        }
+
+        other.addHealth(-getRuleSplashDamage(rule, power));
+    }
+
+    int CompactUnit::getSplashRadius(const UnitRule& rule) const
+    {
+        return getRuleSplashRadius(rule, range);
+    }
+
+    const UnitRule& CompactUnit::getBuiltinRule(UnitTypeId type)
+    {
+        static const UnitRule* const BUILTIN_RULES[] = {&UnitTypeRegistry::getBuiltinRule(SOLDIER),
+                                                         &UnitTypeRegistry::getBuiltinRule(MEDIC),
+                                                         &UnitTypeRegistry::getBuiltinRule(SNIPER)};
+        return *BUILTIN_RULES[type];
+    }
+
+    UnitTypeId CompactUnit::getBuiltinType(CharacterType type)
+    {
+        return type == SOLDIER ? 0 : type == MEDIC ? 1 : 2;
+    }
+}
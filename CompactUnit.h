@@ -0,0 +1,160 @@
+#ifndef COMPACT_UNIT_H
+#define COMPACT_UNIT_H
+
+#include "UnitRule.h"
+#include "UnitTypeRegistry.h"
+#include "Utilities.h"
+
+#include <cstdint>
+
+namespace mtm {
+
+    /**
+     * CompactUnit - a 12 bytes record of a unit, holding only its per-instance state.
+     *
+     * The per-type constants (movement, reload value, attack cost, symbol and attack behaviour) are not stored:
+     * they are looked up from the type's UnitRule, which every rule-dependent method receives. The built-in rules
+     * are kept in a static table (see getBuiltinRule); the ids of the built-in types are the same in every registry.
+     * The stats are kept in 16 bits each: damage saturates at 0 health, and values that would pass MAX_VALUE
+     * (a heal or a reload) saturate too, unless COMPACT_UNIT_CHECKED is defined, in which case they throw.
+     * NOTE: cadence periods above MAX_VALUE are not supported.
+     * Every behaviour is evaluated by the rule kernel (see UnitRule.h), so a compact unit acts exactly as a character
+     * of the same type and stats.
+     */
+    class CompactUnit
+    {
+        uint16_t health;
+        uint16_t ammo;
+        uint16_t range;
+        uint16_t power;
+        uint16_t counter; // the hits counter of the cadence.
+        uint8_t type;
+        uint8_t team;
+
+        public:
+            static const units_t MAX_VALUE = 0xFFFF;
+            static const UnitTypeId MAX_TYPE = 0xFF;
+
+            /**
+             * CompactUnit constructor: creates a dead soldier of the powerlifters (all stats 0).
+             * exists so compact units can be stored in preallocated arrays.
+             */
+            CompactUnit();
+
+            /**
+             * CompactUnit constructor: creates a new unit.
+             *
+             * @param type   - the id of the unit's type (see UnitTypeRegistry). the built-in ids are 0 (soldier),
+             *                 1 (medic) and 2 (sniper).
+             * @param team   - the team of the unit.
+             * @param health - the health of the unit. must be positive.
+             * @param ammo, range, power - the other stats of the unit. must be non-negative.
+             *
+             * @throw
+             *     IllegalArgument - if a stat is incorrect or above MAX_VALUE, or the type is above MAX_TYPE.
+             */
+            CompactUnit(UnitTypeId type, Team team, units_t health, units_t ammo, units_t range, units_t power);
+
+            /**
+             * CompactUnit constructor: creates the unit of a unit descriptor (its coordinates are not kept).
+             *
+             * @throw
+             *     IllegalArgument - if a stat is incorrect or above MAX_VALUE.
+             */
+            explicit CompactUnit(const UnitDescriptor& unit);
+
+            UnitTypeId getType() const;
+            Team getTeam() const;
+            units_t getHealth() const;
+            units_t getAmmo() const;
+            units_t getRange() const;
+            units_t getPower() const;
+
+            /**
+             * getAttackCounter: the hits counter of the unit's cadence. starts at 1.
+             */
+            int getAttackCounter() const;
+
+            /**
+             * isAlive: checks if the unit's health is positive.
+             */
+            bool isAlive() const;
+
+            /**
+             * getSymbol: the symbol of the unit (lower case for the crossfitters, as Character::convertToChar).
+             */
+            char getSymbol(const UnitRule& rule) const;
+
+            /**
+             * addHealth: adds health to the unit (a negative value is damage).
+             *
+             * @throw
+             *     IllegalArgument - with COMPACT_UNIT_CHECKED, if the health would pass MAX_VALUE.
+             */
+            void addHealth(units_t value);
+
+            /**
+             * reload: adds the rule's reload value to the unit's ammo.
+             *
+             * @throw
+             *     IllegalArgument - with COMPACT_UNIT_CHECKED, if the ammo would pass MAX_VALUE.
+             */
+            void reload(const UnitRule& rule);
+
+            /**
+             * isInAttackRange, isInAttackLine, hasAmmoToAttack, isLegalTarget: the checks of an attack, in the order
+             * Game::attack makes them (see the matching methods of Character).
+             *
+             * @param other - the unit in the attacked cell, nullptr if the cell is empty.
+             */
+            bool isInAttackRange(const UnitRule& rule, const GridPoint& src, const GridPoint& dst) const;
+            bool isInAttackLine(const UnitRule& rule, const GridPoint& src, const GridPoint& dst) const;
+            bool hasAmmoToAttack(const UnitRule& rule, const CompactUnit* other) const;
+            bool isLegalTarget(const UnitRule& rule, const CompactUnit* other) const;
+
+            /**
+             * attack: make the unit attack another unit (or an empty cell), as GenericCharacter::attack.
+             *
+             * @param other - the unit in the attacked cell, nullptr if the cell is empty.
+             *
+             * @return
+             *     true if the attack succeeded, false if the target is illegal (nothing is changed).
+             */
+            bool attack(const UnitRule& rule, CompactUnit* other);
+
+            /**
+             * attackNearbyUnit: the splash damage of the unit's attack to a unit near the attacked cell.
+             * units of the attacker's team are not affected.
+             */
+            void attackNearbyUnit(const UnitRule& rule, CompactUnit& other) const;
+
+            /**
+             * getSplashRadius: the radius of the unit's splash. 0 if it has no splash.
+             */
+            int getSplashRadius(const UnitRule& rule) const;
+
+            /**
+             * getBuiltinRule: the rule of a built-in type id (0 to 2), from a static table.
+             */
+            static const UnitRule& getBuiltinRule(UnitTypeId type);
+
+            /**
+             * getBuiltinType: the id of a built-in character type.
+             */
+            static UnitTypeId getBuiltinType(CharacterType type);
+
+        private:
+            /**
+             * narrow: checks a stat and converts it to 16 bits.
+             */
+            static uint16_t narrow(units_t value);
+
+            /**
+             * addSaturated: adds a value to a 16-bit stat, saturating at 0 and MAX_VALUE
+             * (or throwing on overflow, with COMPACT_UNIT_CHECKED).
+             */
+            static uint16_t addSaturated(uint16_t stat, units_t value);
+    };
+}
+
+#endif
@@ -0,0 +1,57 @@
+#include "CounterRng.h"
+
+#include "Zobrist.h"
+
+namespace mtm {
+
+    CounterRng::CounterRng(uint64_t game_id, uint64_t turn, uint64_t unit) :
+        key(getKey(game_id, turn, unit)),
+        counter(0)
+    {}
+
+    uint64_t CounterRng::generate(uint64_t key, uint64_t counter)
+    {
+        // Zobrist::mix adds the gamma itself, so this is the counter-th output of splitmix64 seeded with the key.
+        return Zobrist::mix(key + counter * GOLDEN_GAMMA);
+    }
+
+    uint64_t CounterRng::getKey(uint64_t game_id, uint64_t turn, uint64_t unit)
+    {
+        return Zobrist::mix(Zobrist::mix(Zobrist::mix(game_id) ^ turn) ^ unit);
+    }
+
+    uint64_t CounterRng::next()
+    {
+        return generate(key, counter++);
+    }
+
+    uint64_t CounterRng::nextBelow(uint64_t bound)
+    {
+        if (bound <= 1) {
+            return 0;
+        }
+
+        // values below the threshold would make the low residues more likely, so they are drawn again.
+        uint64_t threshold = (0 - bound) % bound;
+        uint64_t value = next();
+        while (value < threshold) {
+            value = next();
+        }
+        return value % bound;
+    }
+
+    double CounterRng::nextReal()
+    {
+        return double(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    uint64_t CounterRng::getCounter() const
+    {
+        return counter;
+    }
+
+    void CounterRng::seek(uint64_t position)
+    {
+        counter = position;
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef COUNTER_RNG_H
+#define COUNTER_RNG_H
+
+#include <cstdint>
+
+namespace mtm {
+
+    /**
+     * CounterRng - a counter-based random number generator.
+     *
+     * Every stream is keyed on a (game id, turn, unit) triple, and its n-th number is a pure function of
+     * the key and n (the splitmix64 sequence of the key). Streams do not share any state, so the numbers a
+     * simulation draws do not depend on the number of threads, on their scheduling or on the order in which
+     * the streams are used.
+     */
+    class CounterRng
+    {
+        static const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+        uint64_t key;
+        uint64_t counter;
+
+        public:
+            CounterRng() = delete;
+
+            /**
+             * CounterRng constructor: creates the stream of a (game id, turn, unit) triple, at its first number.
+             *
+             * @param game_id - the id of the game (for example, its seed).
+             * @param turn    - the index of the turn.
+             * @param unit    - the id of the unit the numbers are drawn for.
+             */
+            CounterRng(uint64_t game_id, uint64_t turn, uint64_t unit);
+
+            /**
+             * generate: the n-th number of a stream, without creating it.
+             *
+             * @param key     - the key of the stream (see getKey).
+             * @param counter - the index of the number.
+             */
+            static uint64_t generate(uint64_t key, uint64_t counter);
+
+            /**
+             * getKey: the key of the stream of a (game id, turn, unit) triple.
+             */
+            static uint64_t getKey(uint64_t game_id, uint64_t turn, uint64_t unit);
+
+            /**
+             * next: draws the next 64 random bits of the stream.
+             */
+            uint64_t next();
+
+            /**
+             * nextBelow: draws an integer uniformly from [0, bound), without modulo bias.
+             *
+             * @param bound - the number of possible values. 0 is treated as 1.
+             */
+            uint64_t nextBelow(uint64_t bound);
+
+            /**
+             * nextReal: draws a real number uniformly from [0, 1), with 53 random bits.
+             */
+            double nextReal();
+
+            /**
+             * getCounter: the number of numbers drawn from the stream so far.
+             */
+            uint64_t getCounter() const;
+
+            /**
+             * seek: moves the stream to the number of a position, in O(1).
+             */
+            void seek(uint64_t position);
+    };
+}
+
+#endif
@@ -0,0 +1,372 @@
+#include "DifferentialHarness.h"
+
+#include "Exceptions.h"
+#include "ScenarioParser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <sstream>
+
+namespace mtm {
+
+    typedef std::chrono::steady_clock DifferentialClock;
+
+    // the maximal distance, in every axis, between the source and the destination of a generated command.
+    static const int MAX_COMMAND_OFFSET = 4;
+
+    DifferentialConfig::DifferentialConfig() :
+        scenario(8, 8),
+        cases(200),
+        steps(200)
+    {
+        scenario.density = 0.3;
+    }
+
+    DifferentialCase::DifferentialCase(int height, int width) :
+        height(height),
+        width(width),
+        units(),
+        commands()
+    {}
+
+    std::ostream& DifferentialCase::write(std::ostream& os) const
+    {
+        Game game(height, width);
+        game.loadUnits(units.data(), units.data() + units.size());
+        ScenarioParser::writeScenario(os, game);
+        for (const Command& command : commands) {
+            ScenarioParser::writeCommand(os, command);
+        }
+        return os;
+    }
+
+    DifferentialFailure::DifferentialFailure() :
+        test(0, 0),
+        step(0),
+        description()
+    {}
+
+    EngineReport::EngineReport() :
+        name(),
+        failed_cases(0),
+        failure(),
+        seconds(0)
+    {}
+
+    DifferentialResult::DifferentialResult() :
+        cases(0),
+        commands(0),
+        reference_seconds(0),
+        engines()
+    {}
+
+    bool DifferentialResult::isPassing() const
+    {
+        for (const EngineReport& engine : engines) {
+            if (engine.failed_cases > 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    double DifferentialResult::getRelativeSpeed(const EngineReport& engine) const
+    {
+        return engine.seconds > 0 ? reference_seconds / engine.seconds : 0;
+    }
+
+    /**
+     * describeUnit: writes the state of a unit, or "nothing" if there is none.
+     */
+    static void describeUnit(std::ostream& os, const std::vector<UnitState>& state, size_t index)
+    {
+        if (index >= state.size()) {
+            os << "nothing";
+            return;
+        }
+
+        const UnitState& unit = state[index];
+        os << unit.symbol << " at (" << unit.coordinates.row << ", " << unit.coordinates.col << ") health "
+           << unit.health << " ammo " << unit.ammo << " counter " << unit.counter;
+    }
+
+    /**
+     * shrinkList: removes as many elements as possible from a list of a case, keeping the case failing.
+     * chunks of halving sizes are removed in turn, down to single elements (a simplified delta debugging).
+     */
+    template <typename Element, typename Predicate>
+    static void shrinkList(DifferentialCase& test, std::vector<Element> DifferentialCase::* list, Predicate fails)
+    {
+        for (size_t chunk = (test.*list).size() / 2; chunk > 0; chunk /= 2) {
+            for (size_t begin = 0; begin < (test.*list).size(); ) {
+                DifferentialCase candidate = test;
+                std::vector<Element>& elements = candidate.*list;
+                elements.erase(elements.begin() + begin, elements.begin() + std::min(begin + chunk, elements.size()));
+                if (fails(candidate)) {
+                    test = std::move(candidate);
+                }
+                else {
+                    begin += chunk;
+                }
+            }
+        }
+    }
+
+    DifferentialHarness::DifferentialHarness() :
+        reference(),
+        engines()
+    {}
+
+    void DifferentialHarness::addEngine(std::unique_ptr<GameEngine> engine)
+    {
+        if (engine == nullptr) {
+            throw IllegalArgument();
+        }
+        engines.push_back(std::move(engine));
+    }
+
+    DifferentialResult DifferentialHarness::run(const DifferentialConfig& config)
+    {
+        DifferentialResult result;
+        result.cases = config.cases;
+        result.engines.resize(engines.size());
+        for (size_t i = 0; i < engines.size(); ++i) {
+            result.engines[i].name = (*engines[i]).getName();
+        }
+
+        std::vector<DifferentialCase> cases;
+        std::vector<UnitState> expected;
+        std::vector<UnitState> state;
+        std::vector<bool> active(engines.size());
+        std::string description;
+
+        // the engines are compared in lockstep, and an engine is dropped from a case at its first difference.
+        auto fail = [&](size_t engine, const DifferentialCase& test, size_t step) {
+            EngineReport& report = result.engines[engine];
+            if (report.failed_cases++ == 0) {
+                report.failure.test = test;
+                report.failure.step = step;
+                report.failure.description = description;
+            }
+            active[engine] = false;
+        };
+
+        for (uint64_t index = 0; index < config.cases; ++index) {
+            ScenarioConfig scenario = config.scenario;
+            scenario.seed += index;
+            DifferentialCase test(scenario.height, scenario.width);
+            test.units = ScenarioGenerator::generate(scenario);
+
+            reference.load(test.height, test.width, test.units);
+            reference.getState(expected);
+            for (size_t i = 0; i < engines.size(); ++i) {
+                active[i] = load(*engines[i], test, description);
+                if (active[i]) {
+                    (*engines[i]).getState(state);
+                    active[i] = compare(SUCCESS, SUCCESS, expected, state, description);
+                }
+                if (!active[i]) {
+                    fail(i, test, 0);
+                }
+            }
+
+            CounterRng rng(config.scenario.seed, index, 0);
+            for (uint64_t step = 0; step < config.steps; ++step) {
+                test.commands.push_back(nextCommand(rng, test, expected));
+                const Command& command = test.commands.back();
+                CommandStatus expected_status = execute(reference, command);
+                reference.getState(expected);
+
+                for (size_t i = 0; i < engines.size(); ++i) {
+                    if (!active[i]) {
+                        continue;
+                    }
+
+                    CommandStatus status = execute(*engines[i], command);
+                    (*engines[i]).getState(state);
+                    if (!compare(expected_status, status, expected, state, description)) {
+                        fail(i, test, test.commands.size());
+                    }
+                }
+            }
+
+            result.commands += test.commands.size();
+            cases.push_back(std::move(test));
+        }
+
+        for (size_t i = 0; i < engines.size(); ++i) {
+            if (result.engines[i].failed_cases > 0) {
+                shrink(*engines[i], result.engines[i].failure);
+            }
+        }
+
+        result.reference_seconds = time(reference, cases);
+        for (size_t i = 0; i < engines.size(); ++i) {
+            result.engines[i].seconds = time(*engines[i], cases);
+        }
+        return result;
+    }
+
+    bool DifferentialHarness::replay(GameEngine& engine, const DifferentialCase& test, DifferentialFailure& failure)
+    {
+        std::vector<UnitState> expected;
+        std::vector<UnitState> state;
+
+        failure.step = 0;
+        reference.load(test.height, test.width, test.units);
+        reference.getState(expected);
+        if (!load(engine, test, failure.description)) {
+            return false;
+        }
+        engine.getState(state);
+        if (!compare(SUCCESS, SUCCESS, expected, state, failure.description)) {
+            return false;
+        }
+
+        for (const Command& command : test.commands) {
+            ++failure.step;
+            CommandStatus expected_status = execute(reference, command);
+            CommandStatus status = execute(engine, command);
+            reference.getState(expected);
+            engine.getState(state);
+            if (!compare(expected_status, status, expected, state, failure.description)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void DifferentialHarness::shrink(GameEngine& engine, DifferentialFailure& failure)
+    {
+        DifferentialFailure attempt;
+        auto fails = [&](DifferentialCase& candidate) {
+            if (replay(engine, candidate, attempt)) {
+                return false;
+            }
+            // the commands past the first difference are not needed to reproduce it.
+            candidate.commands.resize(attempt.step);
+            return true;
+        };
+
+        DifferentialCase test = failure.test;
+        if (!fails(test)) {
+            return;
+        }
+        shrinkList(test, &DifferentialCase::commands, fails);
+        shrinkList(test, &DifferentialCase::units, fails);
+
+        replay(engine, test, failure);
+        failure.test = std::move(test);
+    }
+
+    std::ostream& DifferentialHarness::printReport(std::ostream& os, const DifferentialResult& result)
+    {
+        os << "engine,cases,commands,failed_cases,seconds,relative_speed" << std::endl;
+        os << "reference," << result.cases << ',' << result.commands << ",0," << result.reference_seconds << ",1"
+           << std::endl;
+        for (const EngineReport& engine : result.engines) {
+            os << engine.name << ',' << result.cases << ',' << result.commands << ',' << engine.failed_cases << ','
+               << engine.seconds << ',' << result.getRelativeSpeed(engine) << std::endl;
+        }
+
+        for (const EngineReport& engine : result.engines) {
+            if (engine.failed_cases == 0) {
+                continue;
+            }
+            os << std::endl << engine.name << " differs at step " << engine.failure.step << ": "
+               << engine.failure.description << std::endl;
+            engine.failure.test.write(os);
+        }
+        return os;
+    }
+
+    Command DifferentialHarness::nextCommand(CounterRng& rng, const DifferentialCase& test,
+                                             const std::vector<UnitState>& state)
+    {
+        CommandType type = CommandType(rng.nextBelow(3));
+
+        // 1 of 8 commands starts at a random cell, which may be empty or out of the board.
+        GridPoint src(0, 0);
+        if (!state.empty() && rng.nextBelow(8) != 0) {
+            src = state[rng.nextBelow(state.size())].coordinates;
+        }
+        else {
+            src = GridPoint(int(rng.nextBelow(uint64_t(test.height) + 2)) - 1,
+                            int(rng.nextBelow(uint64_t(test.width) + 2)) - 1);
+        }
+        if (type == RELOAD_COMMAND) {
+            return Command(type, src, src);
+        }
+
+        GridPoint dst(src.row + int(rng.nextBelow(2 * MAX_COMMAND_OFFSET + 1)) - MAX_COMMAND_OFFSET,
+                      src.col + int(rng.nextBelow(2 * MAX_COMMAND_OFFSET + 1)) - MAX_COMMAND_OFFSET);
+        return Command(type, src, dst);
+    }
+
+    bool DifferentialHarness::compare(CommandStatus expected_status, CommandStatus status,
+                                      const std::vector<UnitState>& expected, const std::vector<UnitState>& state,
+                                      std::string& description)
+    {
+        std::ostringstream os;
+        if (status != expected_status) {
+            os << "status " << getStatusName(status) << ", expected " << getStatusName(expected_status);
+            description = os.str();
+            return false;
+        }
+
+        size_t index = 0;
+        while (index < expected.size() && index < state.size() && expected[index] == state[index]) {
+            ++index;
+        }
+        if (index == expected.size() && index == state.size()) {
+            return true;
+        }
+
+        os << "unit ";
+        describeUnit(os, state, index);
+        os << ", expected ";
+        describeUnit(os, expected, index);
+        description = os.str();
+        return false;
+    }
+
+    bool DifferentialHarness::load(GameEngine& engine, const DifferentialCase& test, std::string& description)
+    {
+        try {
+            engine.load(test.height, test.width, test.units);
+        }
+        catch (const std::exception& e) {
+            description = std::string("load threw ") + e.what();
+            return false;
+        }
+        return true;
+    }
+
+    CommandStatus DifferentialHarness::execute(GameEngine& engine, const Command& command)
+    {
+        try {
+            return engine.execute(command);
+        }
+        catch (const std::exception&) {
+            return ILLEGAL_ARGUMENT;
+        }
+    }
+
+    double DifferentialHarness::time(GameEngine& engine, const std::vector<DifferentialCase>& cases)
+    {
+        DifferentialClock::duration total(0);
+        std::string description;
+        for (const DifferentialCase& test : cases) {
+            if (!load(engine, test, description)) {
+                continue;
+            }
+            DifferentialClock::time_point start = DifferentialClock::now();
+            for (const Command& command : test.commands) {
+                execute(engine, command);
+            }
+            total += DifferentialClock::now() - start;
+        }
+        return std::chrono::duration<double>(total).count();
+    }
+}
@@ -0,0 +1,212 @@
+#ifndef DIFFERENTIAL_HARNESS_H
+#define DIFFERENTIAL_HARNESS_H
+
+#include "GameEngine.h"
+#include "CounterRng.h"
+#include "ScenarioGenerator.h"
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * DifferentialConfig - the parameters of a differential run.
+     *
+     * scenario - the board and the units of every case. the case i is generated with the seed scenario.seed + i,
+     *            and its commands are drawn from the counter-based streams of (scenario.seed, i).
+     * cases    - the number of cases.
+     * steps    - the number of commands of every case.
+     */
+    struct DifferentialConfig
+    {
+        ScenarioConfig scenario;
+        uint64_t cases;
+        uint64_t steps;
+
+        /**
+         * DifferentialConfig constructor: creates a config of small crowded boards, where the characters meet
+         * quickly: 8x8 boards of density 0.3, 200 cases of 200 commands.
+         */
+        DifferentialConfig();
+    };
+
+    /**
+     * DifferentialCase - a reproducible case: a board, its units and the commands run on it.
+     */
+    struct DifferentialCase
+    {
+        int height;
+        int width;
+        std::vector<UnitDescriptor> units;
+        std::vector<Command> commands;
+
+        DifferentialCase(int height, int width);
+
+        /**
+         * write: writes the case in the scenario format (see ScenarioParser.h), so it can be replayed.
+         */
+        std::ostream& write(std::ostream& os) const;
+    };
+
+    /**
+     * DifferentialFailure - the first difference between an engine and the reference in a case.
+     *
+     * step        - the number of commands run when the difference was found. 0 means right after the load.
+     * description - the differing statuses or unit states.
+     */
+    struct DifferentialFailure
+    {
+        DifferentialCase test;
+        size_t step;
+        std::string description;
+
+        DifferentialFailure();
+    };
+
+    /**
+     * EngineReport - the outcome of an engine in a differential run.
+     *
+     * failed_cases - the number of cases in which the engine differed from the reference.
+     * failure      - the first failing case, shrunk. meaningful only if failed_cases is positive.
+     * seconds      - the time of running the commands of every case on the engine, alone.
+     */
+    struct EngineReport
+    {
+        std::string name;
+        uint64_t failed_cases;
+        DifferentialFailure failure;
+        double seconds;
+
+        EngineReport();
+    };
+
+    /**
+     * DifferentialResult - the outcome of a differential run.
+     */
+    struct DifferentialResult
+    {
+        uint64_t cases;
+        uint64_t commands;
+        double reference_seconds;
+        std::vector<EngineReport> engines;
+
+        DifferentialResult();
+
+        /**
+         * isPassing: true if no engine differed from the reference.
+         */
+        bool isPassing() const;
+
+        /**
+         * getRelativeSpeed: the speed of an engine relative to the reference (2 means twice as fast).
+         */
+        double getRelativeSpeed(const EngineReport& engine) const;
+    };
+
+    /**
+     * DifferentialHarness - runs random command streams against Game (the reference engine) and against
+     * alternative engines in lockstep, comparing the status and the state of every engine after every command.
+     *
+     * The commands are biased towards the characters of the board, so most of them reach the checks past
+     * IllegalCell and CellEmpty, while a few start out of the board or at empty cells.
+     * A failing case is shrunk by removing commands, then units, as long as the engine still differs,
+     * and the time of every engine is then measured on the same cases, separately.
+     */
+    class DifferentialHarness
+    {
+        ReferenceEngine reference;
+        std::vector<std::unique_ptr<GameEngine>> engines;
+
+        public:
+            DifferentialHarness();
+
+            DifferentialHarness(const DifferentialHarness& other) = delete;
+            DifferentialHarness& operator=(const DifferentialHarness& other) = delete;
+
+            /**
+             * addEngine: adds an engine to compare to the reference.
+             *
+             * @throw
+             *     IllegalArgument - if the engine is null.
+             */
+            void addEngine(std::unique_ptr<GameEngine> engine);
+
+            /**
+             * run: runs a differential test of every engine added.
+             *
+             * @param config - the parameters of the run.
+             *
+             * @throw
+             *     IllegalArgument - if one of the scenario's parameters is incorrect.
+             */
+            DifferentialResult run(const DifferentialConfig& config);
+
+            /**
+             * replay: runs a case on the reference and on an engine in lockstep, until the first difference.
+             *
+             * @param engine  - the engine to compare.
+             * @param test    - the case to run.
+             * @param failure - the result keeper of the difference, if found (test is not copied into it).
+             *
+             * @return
+             *     true if the engine matched the reference on the whole case, false otherwise.
+             */
+            bool replay(GameEngine& engine, const DifferentialCase& test, DifferentialFailure& failure);
+
+            /**
+             * shrink: minimizes a failing case, keeping it failing on the engine.
+             *
+             * @param engine  - the engine the case fails on.
+             * @param failure - a failure of the engine. its case and description are replaced by the shrunk ones.
+             */
+            void shrink(GameEngine& engine, DifferentialFailure& failure);
+
+            /**
+             * printReport: prints the result of a run: the relative speed of every engine and its first
+             * failing case, if any.
+             */
+            static std::ostream& printReport(std::ostream& os, const DifferentialResult& result);
+
+        private:
+            /**
+             * nextCommand: draws a random command for the state of the reference.
+             */
+            static Command nextCommand(CounterRng& rng, const DifferentialCase& test,
+                                       const std::vector<UnitState>& state);
+
+            /**
+             * compare: compares the status and the state of an engine to the reference's.
+             *
+             * @return
+             *     true if they match, otherwise false and description is set.
+             */
+            static bool compare(CommandStatus expected_status, CommandStatus status,
+                                const std::vector<UnitState>& expected, const std::vector<UnitState>& state,
+                                std::string& description);
+
+            /**
+             * load: loads a case into an engine.
+             *
+             * @return
+             *     true on success, otherwise (if the engine threw) false and description is set.
+             */
+            static bool load(GameEngine& engine, const DifferentialCase& test, std::string& description);
+
+            /**
+             * execute: executes a command on an engine, turning an exception it throws into ILLEGAL_ARGUMENT
+             * (a status the generated commands never get from the reference).
+             */
+            static CommandStatus execute(GameEngine& engine, const Command& command);
+
+            /**
+             * time: the time of running the commands of the cases on an engine.
+             */
+            static double time(GameEngine& engine, const std::vector<DifferentialCase>& cases);
+    };
+}
+
+#endif
@@ -0,0 +1,305 @@
+#include "EffectScheduler.h"
+
+#include "Exceptions.h"
+
+namespace mtm {
+
+    const int EffectScheduler::LEVEL_BITS;
+    const uint32_t EffectScheduler::SLOTS_PER_LEVEL;
+    const uint32_t EffectScheduler::SLOT_MASK;
+    const int EffectScheduler::LEVELS;
+    const uint32_t EffectScheduler::FIRING_LIST;
+    const uint32_t EffectScheduler::NO_EFFECT;
+
+    EffectId::EffectId() :
+        index(0),
+        generation(0)
+    {}
+
+    EffectId::EffectId(uint32_t index, uint32_t generation) :
+        index(index),
+        generation(generation)
+    {}
+
+    bool EffectId::isNull() const
+    {
+        return generation == 0;
+    }
+
+    bool EffectId::operator==(const EffectId& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool EffectId::operator!=(const EffectId& other) const
+    {
+        return !(*this == other);
+    }
+
+    EffectScheduler::EffectScheduler(Game& game) :
+        game(game),
+        now(0),
+        size(0),
+        effects(),
+        free_effects(),
+        lists(FIRING_LIST + 1, NO_EFFECT),
+        unit_lists()
+    {
+        game.setEffectScheduler(this);
+    }
+
+    EffectScheduler::~EffectScheduler()
+    {
+        if (game.getEffectScheduler() == this) {
+            game.setEffectScheduler(nullptr);
+        }
+    }
+
+    EffectId EffectScheduler::schedule(EffectType type, UnitHandle unit, uint64_t delay, units_t value,
+                                       uint32_t repeats, uint64_t period)
+    {
+        if (!game.isValid(unit) || delay == 0 || repeats == 0 || period == 0) {
+            throw IllegalArgument();
+        }
+
+        uint32_t index;
+        if (free_effects.empty()) {
+            index = uint32_t(effects.size());
+            effects.push_back(Effect());
+            effects[index].generation = 1;
+        }
+        else {
+            index = free_effects.back();
+            free_effects.pop_back();
+        }
+
+        Effect& effect = effects[index];
+        effect.type = type;
+        effect.unit = unit;
+        effect.value = value;
+        effect.repeats = repeats;
+        effect.period = period;
+        effect.due = now + delay;
+
+        if (unit_lists.size() <= unit.index) {
+            unit_lists.resize(size_t(unit.index) + 1, NO_EFFECT);
+        }
+        effect.unit_previous = NO_EFFECT;
+        effect.unit_next = unit_lists[unit.index];
+        if (effect.unit_next != NO_EFFECT) {
+            effects[effect.unit_next].unit_previous = index;
+        }
+        unit_lists[unit.index] = index;
+
+        link(index);
+        ++size;
+        return EffectId(index, effect.generation);
+    }
+
+    EffectId EffectScheduler::scheduleCooldown(UnitHandle unit, uint64_t duration)
+    {
+        return schedule(COOLDOWN_EFFECT, unit, duration);
+    }
+
+    EffectId EffectScheduler::scheduleReload(UnitHandle unit, uint64_t delay)
+    {
+        return schedule(RELOAD_EFFECT, unit, delay);
+    }
+
+    EffectId EffectScheduler::scheduleHealthChange(UnitHandle unit, uint64_t delay, units_t value,
+                                                   uint32_t repeats, uint64_t period)
+    {
+        return schedule(HEALTH_EFFECT, unit, delay, value, repeats, period);
+    }
+
+    bool EffectScheduler::cancel(EffectId effect)
+    {
+        if (!isPending(effect)) {
+            return false;
+        }
+
+        if (effects[effect.index].list != NO_EFFECT) {
+            unlink(effect.index);
+        }
+        release(effect.index);
+        return true;
+    }
+
+    size_t EffectScheduler::cancelUnit(UnitHandle unit)
+    {
+        size_t count = 0;
+        while (unit.index < unit_lists.size() && unit_lists[unit.index] != NO_EFFECT) {
+            uint32_t index = unit_lists[unit.index];
+            cancel(EffectId(index, effects[index].generation));
+            ++count;
+        }
+        return count;
+    }
+
+    bool EffectScheduler::isPending(EffectId effect) const
+    {
+        // a free effect's generation is advanced when it is released, so a stale id never matches.
+        return !effect.isNull() && effect.index < effects.size() && effects[effect.index].repeats > 0 &&
+               effects[effect.index].generation == effect.generation;
+    }
+
+    bool EffectScheduler::hasEffect(UnitHandle unit, EffectType type) const
+    {
+        if (!game.isValid(unit) || unit.index >= unit_lists.size()) {
+            return false;
+        }
+
+        for (uint32_t index = unit_lists[unit.index]; index != NO_EFFECT; index = effects[index].unit_next) {
+            if (effects[index].type == type) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t EffectScheduler::advance(uint64_t ticks)
+    {
+        size_t fired = 0;
+        for (uint64_t tick = 0; tick < ticks; ++tick) {
+            if (size == 0) {
+                now += ticks - tick;
+                break;
+            }
+
+            ++now;
+
+            // every level whose lower groups wrapped to 0 is cascaded, from the highest one down.
+            int level = 1;
+            while (level < LEVELS && (now & ((uint64_t(1) << (level * LEVEL_BITS)) - 1)) == 0) {
+                ++level;
+            }
+            for (--level; level > 0; --level) {
+                cascade(uint32_t(level) * SLOTS_PER_LEVEL + (uint32_t(now >> (level * LEVEL_BITS)) & SLOT_MASK));
+            }
+
+            fired += fire(uint32_t(now) & SLOT_MASK);
+        }
+        return fired;
+    }
+
+    uint64_t EffectScheduler::getTick() const
+    {
+        return now;
+    }
+
+    size_t EffectScheduler::getSize() const
+    {
+        return size;
+    }
+
+    void EffectScheduler::link(uint32_t index)
+    {
+        Effect& effect = effects[index];
+        uint64_t difference = effect.due ^ now;
+        int level = difference == 0 ? 0 : (63 - __builtin_clzll(difference)) / LEVEL_BITS;
+        uint32_t slot = uint32_t(level) * SLOTS_PER_LEVEL + (uint32_t(effect.due >> (level * LEVEL_BITS)) & SLOT_MASK);
+
+        effect.list = slot;
+        effect.previous = NO_EFFECT;
+        effect.next = lists[slot];
+        if (effect.next != NO_EFFECT) {
+            effects[effect.next].previous = index;
+        }
+        lists[slot] = index;
+    }
+
+    void EffectScheduler::unlink(uint32_t index)
+    {
+        Effect& effect = effects[index];
+        if (effect.previous != NO_EFFECT) {
+            effects[effect.previous].next = effect.next;
+        }
+        else {
+            lists[effect.list] = effect.next;
+        }
+        if (effect.next != NO_EFFECT) {
+            effects[effect.next].previous = effect.previous;
+        }
+        effect.list = NO_EFFECT;
+    }
+
+    void EffectScheduler::release(uint32_t index)
+    {
+        Effect& effect = effects[index];
+        if (effect.unit_previous != NO_EFFECT) {
+            effects[effect.unit_previous].unit_next = effect.unit_next;
+        }
+        else {
+            unit_lists[effect.unit.index] = effect.unit_next;
+        }
+        if (effect.unit_next != NO_EFFECT) {
+            effects[effect.unit_next].unit_previous = effect.unit_previous;
+        }
+
+        // generation 0 is kept for the null id.
+        if (++effect.generation == 0) {
+            effect.generation = 1;
+        }
+        effect.list = NO_EFFECT;
+        effect.repeats = 0;
+        free_effects.push_back(index);
+        --size;
+    }
+
+    void EffectScheduler::cascade(uint32_t slot)
+    {
+        uint32_t index = lists[slot];
+        lists[slot] = NO_EFFECT;
+        while (index != NO_EFFECT) {
+            uint32_t next = effects[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+    size_t EffectScheduler::fire(uint32_t slot)
+    {
+        // the slot is moved aside first, so the effects cancelled while others fire are unlinked from it.
+        lists[FIRING_LIST] = lists[slot];
+        lists[slot] = NO_EFFECT;
+        for (uint32_t index = lists[FIRING_LIST]; index != NO_EFFECT; index = effects[index].next) {
+            effects[index].list = FIRING_LIST;
+        }
+
+        size_t fired = 0;
+        while (lists[FIRING_LIST] != NO_EFFECT) {
+            uint32_t index = lists[FIRING_LIST];
+            unlink(index);
+
+            // the game may kill the effect's character (and cancel its effects, this one included) while it applies.
+            uint32_t generation = effects[index].generation;
+            if (game.isValid(effects[index].unit)) {
+                apply(Effect(effects[index]));
+                ++fired;
+            }
+            if (effects[index].generation != generation) {
+                continue;
+            }
+
+            Effect& effect = effects[index];
+            if (--effect.repeats > 0 && game.isValid(effect.unit)) {
+                effect.due = now + effect.period;
+                link(index);
+            }
+            else {
+                release(index);
+            }
+        }
+        return fired;
+    }
+
+    void EffectScheduler::apply(const Effect& effect)
+    {
+        switch (effect.type)
+        {
+            case RELOAD_EFFECT: game.reload(effect.unit); break;
+            case HEALTH_EFFECT: game.addHealth(effect.unit, effect.value); break;
+            default: break;
+        }
+    }
+}
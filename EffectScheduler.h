@@ -0,0 +1,220 @@
+#ifndef EFFECT_SCHEDULER_H
+#define EFFECT_SCHEDULER_H
+
+#include "Game.h"
+#include "UnitTable.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * EffectType - the kinds of timed effects:
+     *      COOLDOWN_EFFECT - a character cooling down. firing it changes nothing, it only ends the cooldown.
+     *      RELOAD_EFFECT   - a delayed reload of a character (see Character::reload).
+     *      HEALTH_EFFECT   - a delayed change of a character's health (see Game::addHealth). repeated
+     *                        with a negative value, it is a damage over time; with a positive value, a regeneration.
+     */
+    enum EffectType { COOLDOWN_EFFECT, RELOAD_EFFECT, HEALTH_EFFECT };
+
+    /**
+     * EffectId - a generational reference to a scheduled effect, as UnitHandle is to a unit.
+     * it becomes stale once its effect fires for the last time or is cancelled. the default id is null.
+     */
+    struct EffectId
+    {
+        uint32_t index;
+        uint32_t generation;
+
+        /**
+         * EffectId constructor: creates a null id.
+         */
+        EffectId();
+
+        EffectId(uint32_t index, uint32_t generation);
+
+        bool isNull() const;
+        bool operator==(const EffectId& other) const;
+        bool operator!=(const EffectId& other) const;
+    };
+
+    /**
+     * EffectScheduler - the timed effects of a game's characters, kept in a hierarchical timing wheel.
+     *
+     * The wheel has LEVELS levels of SLOTS_PER_LEVEL slots. An effect is put in the level of the highest
+     * LEVEL_BITS bits group in which its due tick differs from the current tick, and in the slot of its due
+     * tick's bits in that group. Whenever the lower groups of the current tick wrap to 0, the current slot of
+     * the next level is cascaded down, so only the effects due this tick are in the current slot of level 0.
+     * Every slot is an intrusive doubly linked list over a pool of effects, and so are the effects of every unit,
+     * so scheduling and cancelling an effect costs O(1), and a tick costs O(1) plus the effects it fires or cascades
+     * (every effect is cascaded at most LEVELS - 1 times).
+     *
+     * The scheduler attaches itself to the game (see Game::setEffectScheduler), and the game cancels the effects
+     * of every character it kills, whatever killed it (an attack, or an effect).
+     */
+    class EffectScheduler
+    {
+        static const int LEVEL_BITS = 8;
+        static const uint32_t SLOTS_PER_LEVEL = 1u << LEVEL_BITS;
+        static const uint32_t SLOT_MASK = SLOTS_PER_LEVEL - 1;
+        static const int LEVELS = 8; // LEVELS * LEVEL_BITS covers the 64 bits of a tick.
+        static const uint32_t FIRING_LIST = LEVELS * SLOTS_PER_LEVEL; // the list of the effects firing this tick.
+        static const uint32_t NO_EFFECT = 0xFFFFFFFF;
+
+        struct Effect
+        {
+            EffectType type;
+            UnitHandle unit;
+            units_t value;
+            uint32_t repeats; // the number of times the effect still fires, this one included.
+            uint64_t period;
+            uint64_t due;
+            uint32_t generation;
+            uint32_t list; // the list holding the effect, NO_EFFECT if it is free or firing.
+            uint32_t previous;
+            uint32_t next;
+            uint32_t unit_previous;
+            uint32_t unit_next;
+        };
+
+        Game& game;
+        uint64_t now;
+        size_t size;
+        std::vector<Effect> effects;
+        std::vector<uint32_t> free_effects;
+        std::vector<uint32_t> lists; // the first effect of every slot, and of the firing list.
+        std::vector<uint32_t> unit_lists; // the first effect of every unit, by its handle's index.
+
+        public:
+            EffectScheduler() = delete;
+
+            /**
+             * EffectScheduler constructor: creates an empty scheduler at tick 0 and attaches it to a game,
+             * replacing its previous scheduler.
+             *
+             * @param game - the game whose characters the effects act on. it must outlive the scheduler.
+             */
+            explicit EffectScheduler(Game& game);
+
+            EffectScheduler(const EffectScheduler& other) = delete;
+            EffectScheduler& operator=(const EffectScheduler& other) = delete;
+
+            /**
+             * EffectScheduler destructor: detaches the scheduler from its game, if it is still attached.
+             */
+            ~EffectScheduler();
+
+            /**
+             * schedule: schedules an effect on a character.
+             *
+             * @param type    - the type of the effect.
+             * @param unit    - the handle of the character.
+             * @param delay   - the number of ticks until the effect first fires. must be positive.
+             * @param value   - the health the effect adds, for a HEALTH_EFFECT (ignored otherwise).
+             * @param repeats - the number of times the effect fires. must be positive.
+             * @param period  - the number of ticks between two firings. must be positive.
+             *
+             * @throw
+             *     IllegalArgument - if the handle is not valid in the game, or one of the numbers is non-positive.
+             *
+             * @return
+             *     the id of the effect.
+             */
+            EffectId schedule(EffectType type, UnitHandle unit, uint64_t delay, units_t value = 0,
+                              uint32_t repeats = 1, uint64_t period = 1);
+
+            /**
+             * scheduleCooldown, scheduleReload, scheduleHealthChange: schedule an effect of a type,
+             *                                                         as described in schedule.
+             */
+            EffectId scheduleCooldown(UnitHandle unit, uint64_t duration);
+            EffectId scheduleReload(UnitHandle unit, uint64_t delay);
+            EffectId scheduleHealthChange(UnitHandle unit, uint64_t delay, units_t value,
+                                          uint32_t repeats = 1, uint64_t period = 1);
+
+            /**
+             * cancel: cancels an effect, in O(1).
+             *
+             * @return
+             *     true if the effect was cancelled, false if the id is stale (it already fired or was cancelled).
+             */
+            bool cancel(EffectId effect);
+
+            /**
+             * cancelUnit: cancels all the effects of a character, in time proportional to their number.
+             * called by the game whenever it kills a character.
+             *
+             * @return
+             *     the number of effects cancelled.
+             */
+            size_t cancelUnit(UnitHandle unit);
+
+            /**
+             * isPending: true if an effect is still scheduled.
+             */
+            bool isPending(EffectId effect) const;
+
+            /**
+             * hasEffect: true if a character has a scheduled effect of a type (for example, if it is cooling down).
+             */
+            bool hasEffect(UnitHandle unit, EffectType type) const;
+
+            /**
+             * advance: moves the scheduler forward and fires the effects that become due, tick by tick.
+             * the effects due at the same tick fire in no particular order.
+             *
+             * @param ticks - the number of ticks to advance.
+             *
+             * @return
+             *     the number of effects fired.
+             */
+            size_t advance(uint64_t ticks = 1);
+
+            /**
+             * getTick: the current tick.
+             */
+            uint64_t getTick() const;
+
+            /**
+             * getSize: the number of scheduled effects.
+             */
+            size_t getSize() const;
+
+        private:
+            /**
+             * link: puts an effect in the slot of its due tick.
+             */
+            void link(uint32_t index);
+
+            /**
+             * unlink: removes an effect from the list holding it.
+             */
+            void unlink(uint32_t index);
+
+            /**
+             * release: removes an effect from its unit's list and frees it.
+             */
+            void release(uint32_t index);
+
+            /**
+             * cascade: moves the effects of a slot to the slots of the lower levels.
+             */
+            void cascade(uint32_t slot);
+
+            /**
+             * fire: fires the effects of a slot of level 0, all due at the current tick.
+             *
+             * @return
+             *     the number of effects fired.
+             */
+            size_t fire(uint32_t slot);
+
+            /**
+             * apply: applies an effect to the game.
+             */
+            void apply(const Effect& effect);
+    };
+}
+
+#endif
@@ -0,0 +1,343 @@
+#ifndef FIXED_GAME_H
+#define FIXED_GAME_H
+
+#include "GameEngine.h"
+#include "CompactUnit.h"
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * CellOffset - the offset of a cell from another one.
+     */
+    struct CellOffset
+    {
+        int row;
+        int col;
+    };
+
+    /**
+     * ManhattanTable - the offsets of every cell within MAX_RADIUS (Manhattan distance) of a cell, computed at
+     * compile time and sorted by distance: the diamond of radius r is the first getCount(r) offsets.
+     * Covers the movement of every built-in type and the splash of ranges up to MAX_RADIUS.
+     */
+    class ManhattanTable
+    {
+        public:
+            static constexpr int MAX_RADIUS = 8;
+
+            /**
+             * getCount: the number of cells within a radius (2r(r+1) + 1), at most MAX_RADIUS.
+             */
+            static constexpr int getCount(int radius)
+            {
+                return 2 * radius * (radius + 1) + 1;
+            }
+
+            /**
+             * OFFSETS: ring after ring, every ring in row order.
+             */
+            static constexpr std::array<CellOffset, size_t(2 * MAX_RADIUS * (MAX_RADIUS + 1) + 1)> OFFSETS = []() {
+                std::array<CellOffset, size_t(2 * MAX_RADIUS * (MAX_RADIUS + 1) + 1)> offsets{};
+                size_t index = 0;
+                for (int distance = 0; distance <= MAX_RADIUS; ++distance) {
+                    for (int row = -distance; row <= distance; ++row) {
+                        int col = distance - (row < 0 ? -row : row);
+                        offsets[index++] = CellOffset{row, -col};
+                        if (col != 0) {
+                            offsets[index++] = CellOffset{row, col};
+                        }
+                    }
+                }
+                return offsets;
+            }();
+    };
+
+    static_assert(ManhattanTable::OFFSETS.size() == size_t(ManhattanTable::getCount(ManhattanTable::MAX_RADIUS)),
+                  "every cell of the diamond is listed once");
+
+    /**
+     * FixedGame - an engine specialized for a board size known at compile time.
+     *
+     * The board is an std::array of CompactUnits (see CompactEngine.h), one per cell, so its size, the bounds
+     * checks and the cell indices are all constants, and the splash diamonds are walked through the compile-time
+     * ManhattanTable instead of row loops. The actions are evaluated by the same rule kernel as Game's
+     * characters (see UnitRule.h), in the same order of checks as Game, so a fixed game acts exactly as Game
+     * (up to the saturation of CompactUnit's stats).
+     *
+     * A fixed game is about 12 * HEIGHT * WIDTH bytes, so large boards should be allocated on the heap.
+     * Only the built-in types are supported.
+     *
+     * @tparam HEIGHT, WIDTH - the dimensions of the board. must be positive.
+     */
+    template <int HEIGHT, int WIDTH>
+    class FixedGame : public GameEngine
+    {
+        static_assert(HEIGHT > 0 && WIDTH > 0, "the board dimensions must be positive");
+
+        std::array<CompactUnit, size_t(HEIGHT) * size_t(WIDTH)> cells;
+
+        public:
+            FixedGame();
+
+            const char* getName() const override;
+
+            /**
+             * load: see GameEngine::load.
+             *
+             * @throw
+             *     IllegalArgument - if the dimensions differ from the template's, or a unit's stats are incorrect.
+             */
+            void load(int height, int width, const std::vector<UnitDescriptor>& units) override;
+
+            CommandStatus execute(const Command& command) override;
+            void getState(std::vector<UnitState>& state) const override;
+
+            /**
+             * isOutOfBound: checks if a cell is outside the board.
+             */
+            static constexpr bool isOutOfBound(int row, int col)
+            {
+                return (col < 0 || row < 0 || col >= WIDTH || row >= HEIGHT);
+            }
+
+            /**
+             * forEachMove: visits every cell the unit of a cell may move to (within its movement and empty),
+             * nearest first.
+             *
+             * @param coordinates - the cell of the unit. nothing is visited if it is empty or out of the board.
+             * @param visit       - a function object, called as visit(const GridPoint&). it must not change the game.
+             */
+            template <class Visitor>
+            void forEachMove(const GridPoint& coordinates, Visitor visit) const;
+
+        private:
+            static constexpr size_t getIndex(int row, int col)
+            {
+                return size_t(row) * size_t(WIDTH) + size_t(col);
+            }
+
+            CompactUnit& getCell(const GridPoint& coordinates);
+            const CompactUnit& getCell(const GridPoint& coordinates) const;
+
+            CommandStatus move(const GridPoint& src, const GridPoint& dst);
+            CommandStatus attack(const GridPoint& src, const GridPoint& dst);
+            CommandStatus reload(const GridPoint& coordinates);
+
+            /**
+             * splash: the splash damage of an attacker's attack to the units around the attacked cell.
+             */
+            void splash(const CompactUnit& attacker, const UnitRule& rule, const GridPoint& dst, int radius);
+
+            /**
+             * hitNearby: the splash damage to the unit of a cell, if there is one, removing it if it died.
+             */
+            void hitNearby(const CompactUnit& attacker, const UnitRule& rule, int row, int col);
+    };
+
+    template <int HEIGHT, int WIDTH>
+    FixedGame<HEIGHT, WIDTH>::FixedGame() :
+        cells()
+    {}
+
+    template <int HEIGHT, int WIDTH>
+    const char* FixedGame<HEIGHT, WIDTH>::getName() const
+    {
+        return "fixed";
+    }
+
+    template <int HEIGHT, int WIDTH>
+    void FixedGame<HEIGHT, WIDTH>::load(int height, int width, const std::vector<UnitDescriptor>& units)
+    {
+        if (height != HEIGHT || width != WIDTH) {
+            throw IllegalArgument();
+        }
+
+        cells.fill(CompactUnit());
+        for (const UnitDescriptor& unit : units) {
+            getCell(unit.coordinates) = CompactUnit(unit);
+        }
+    }
+
+    template <int HEIGHT, int WIDTH>
+    CommandStatus FixedGame<HEIGHT, WIDTH>::execute(const Command& command)
+    {
+        switch (command.type)
+        {
+            case MOVE_COMMAND:   return move(command.src, command.dst);
+            case ATTACK_COMMAND: return attack(command.src, command.dst);
+            case RELOAD_COMMAND: return reload(command.src);
+            default: return ILLEGAL_ARGUMENT;
+        }
+    }
+
+    template <int HEIGHT, int WIDTH>
+    void FixedGame<HEIGHT, WIDTH>::getState(std::vector<UnitState>& state) const
+    {
+        state.clear();
+        for (int row = 0; row < HEIGHT; ++row) {
+            for (int col = 0; col < WIDTH; ++col) {
+                const CompactUnit& unit = cells[getIndex(row, col)];
+                if (!unit.isAlive()) {
+                    continue;
+                }
+
+                const UnitRule& rule = CompactUnit::getBuiltinRule(unit.getType());
+                state.push_back(UnitState(GridPoint(row, col), unit.getSymbol(rule), unit.getHealth(),
+                                          unit.getAmmo(), rule.cadence_period > 0 ? unit.getAttackCounter() : 0));
+            }
+        }
+    }
+
+    template <int HEIGHT, int WIDTH>
+    template <class Visitor>
+    void FixedGame<HEIGHT, WIDTH>::forEachMove(const GridPoint& coordinates, Visitor visit) const
+    {
+        if (isOutOfBound(coordinates.row, coordinates.col) || !getCell(coordinates).isAlive()) {
+            return;
+        }
+
+        // the built-in movements are within the table, so the diamond is never walked by rows.
+        int movement = std::min(CompactUnit::getBuiltinRule(getCell(coordinates).getType()).movement,
+                                ManhattanTable::MAX_RADIUS);
+        for (int index = 1; index < ManhattanTable::getCount(movement); ++index) {
+            int row = coordinates.row + ManhattanTable::OFFSETS[size_t(index)].row;
+            int col = coordinates.col + ManhattanTable::OFFSETS[size_t(index)].col;
+            if (!isOutOfBound(row, col) && !cells[getIndex(row, col)].isAlive()) {
+                visit(GridPoint(row, col));
+            }
+        }
+    }
+
+    template <int HEIGHT, int WIDTH>
+    CompactUnit& FixedGame<HEIGHT, WIDTH>::getCell(const GridPoint& coordinates)
+    {
+        return cells[getIndex(coordinates.row, coordinates.col)];
+    }
+
+    template <int HEIGHT, int WIDTH>
+    const CompactUnit& FixedGame<HEIGHT, WIDTH>::getCell(const GridPoint& coordinates) const
+    {
+        return cells[getIndex(coordinates.row, coordinates.col)];
+    }
+
+    template <int HEIGHT, int WIDTH>
+    CommandStatus FixedGame<HEIGHT, WIDTH>::move(const GridPoint& src, const GridPoint& dst)
+    {
+        if (isOutOfBound(src.row, src.col) || isOutOfBound(dst.row, dst.col)) {
+            return ILLEGAL_CELL;
+        }
+        if (!getCell(src).isAlive()) {
+            return CELL_EMPTY;
+        }
+        if (GridPoint::distance(src, dst) > CompactUnit::getBuiltinRule(getCell(src).getType()).movement) {
+            return MOVE_TOO_FAR;
+        }
+        if (getCell(dst).isAlive()) {
+            return CELL_OCCUPIED;
+        }
+
+        getCell(dst) = getCell(src);
+        getCell(src) = CompactUnit();
+        return SUCCESS;
+    }
+
+    template <int HEIGHT, int WIDTH>
+    CommandStatus FixedGame<HEIGHT, WIDTH>::attack(const GridPoint& src, const GridPoint& dst)
+    {
+        if (isOutOfBound(src.row, src.col) || isOutOfBound(dst.row, dst.col)) {
+            return ILLEGAL_CELL;
+        }
+        if (!getCell(src).isAlive()) {
+            return CELL_EMPTY;
+        }
+
+        CompactUnit& attacker = getCell(src);
+        const UnitRule& rule = CompactUnit::getBuiltinRule(attacker.getType());
+        if (!attacker.isInAttackRange(rule, src, dst)) {
+            return OUT_OF_RANGE;
+        }
+
+        CompactUnit* target = getCell(dst).isAlive() ? &getCell(dst) : nullptr;
+        if (!attacker.hasAmmoToAttack(rule, target)) {
+            return OUT_OF_AMMO;
+        }
+        if (!attacker.isInAttackLine(rule, src, dst) || !attacker.attack(rule, target)) {
+            return ILLEGAL_TARGET;
+        }
+
+        // the splash is applied before the target is removed, as Game commits its kills last.
+        int radius = attacker.getSplashRadius(rule);
+        if (radius > 0) {
+            splash(attacker, rule, dst, radius);
+        }
+        if (target != nullptr && !(*target).isAlive()) {
+            *target = CompactUnit();
+        }
+        return SUCCESS;
+    }
+
+    template <int HEIGHT, int WIDTH>
+    CommandStatus FixedGame<HEIGHT, WIDTH>::reload(const GridPoint& coordinates)
+    {
+        if (isOutOfBound(coordinates.row, coordinates.col)) {
+            return ILLEGAL_CELL;
+        }
+        if (!getCell(coordinates).isAlive()) {
+            return CELL_EMPTY;
+        }
+
+        CompactUnit& unit = getCell(coordinates);
+        unit.reload(CompactUnit::getBuiltinRule(unit.getType()));
+        return SUCCESS;
+    }
+
+    template <int HEIGHT, int WIDTH>
+    void FixedGame<HEIGHT, WIDTH>::splash(const CompactUnit& attacker, const UnitRule& rule, const GridPoint& dst,
+                                          int radius)
+    {
+        if (radius <= ManhattanTable::MAX_RADIUS) {
+            for (int index = 1; index < ManhattanTable::getCount(radius); ++index) {
+                hitNearby(attacker, rule, dst.row + ManhattanTable::OFFSETS[size_t(index)].row,
+                          dst.col + ManhattanTable::OFFSETS[size_t(index)].col);
+            }
+            return;
+        }
+
+        // a splash beyond the table (a range above MAX_RADIUS) is walked row by row, clipped to the board.
+        int first_row = std::max(0, dst.row - radius);
+        int last_row  = std::min(HEIGHT - 1, dst.row + radius);
+        for (int row = first_row; row <= last_row; ++row) {
+            int span = radius - std::abs(row - dst.row);
+            int first_col = std::max(0, dst.col - span);
+            int last_col  = std::min(WIDTH - 1, dst.col + span);
+            for (int col = first_col; col <= last_col; ++col) {
+                if (row != dst.row || col != dst.col) {
+                    hitNearby(attacker, rule, row, col);
+                }
+            }
+        }
+    }
+
+    template <int HEIGHT, int WIDTH>
+    void FixedGame<HEIGHT, WIDTH>::hitNearby(const CompactUnit& attacker, const UnitRule& rule, int row, int col)
+    {
+        if (isOutOfBound(row, col)) {
+            return;
+        }
+        CompactUnit& unit = cells[getIndex(row, col)];
+        if (unit.isAlive()) {
+            attacker.attackNearbyUnit(rule, unit);
+            if (!unit.isAlive()) {
+                unit = CompactUnit();
+            }
+        }
+    }
+}
+
+#endif
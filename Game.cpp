@@ -2,35 +2,86 @@
 
 #include "Utilities.h" // also includes other utilities such as characters.
 #include "Exceptions.h"
+#include "EffectScheduler.h"
 
 #include <algorithm>
+#include <atomic>
+#include <initializer_list>
+#include <random>
 
 using std::shared_ptr;
 
 namespace mtm 
 {
+    const size_t Game::MIN_JOURNAL_SIZE;
+
+    /**
+     * makeJournalId: returns a new journal id, never 0.
+     * the ids are drawn from a random start, so ids of different processes are very unlikely to collide.
+     */
+    static uint64_t makeJournalId()
+    {
+        static const uint64_t start = (uint64_t(std::random_device()()) << 32) ^ uint64_t(std::random_device()());
+        static std::atomic<uint64_t> counter(0);
+
+        uint64_t id = Zobrist::mix(start + counter.fetch_add(1, std::memory_order_relaxed));
+        return id != 0 ? id : 1;
+    }
+
     Game::Game(int height, int width) :
         height(height),
         width(width),
-        board(BOARD_MAP()),
+        memory(),
+        units(&memory),
+        board(ComparePoints(), TrackingAllocator<BOARD_TILE>(&memory, BOARD_MEMORY)),
+        occupancy(height, width),
+        crossfitters_mask(height, width),
+        powerlifters_mask(height, width),
         crossfitters_count(0),
-        powerlifters_count(0)
+        powerlifters_count(0),
+        hash(0),
+        event_sink(nullptr),
+        effect_scheduler(nullptr),
+        attack_outcome(),
+        journal_id(makeJournalId()),
+        base_journal_id(0),
+        base_position(0),
+        journal(TrackingAllocator<GridPoint>(&memory, JOURNAL_MEMORY))
     {
         if (width < 1 || height < 1) {
             throw IllegalArgument();
         }
     }
 
+    Game::Game(int height, int width, const std::vector<UnitDescriptor>& units) :
+        Game(height, width)
+    {
+        loadUnits(units.data(), units.data() + units.size());
+    }
+
     Game::Game(const Game& other) :
         height(other.height),
         width(other.width),
+        memory(),
+        units(other.units, &memory),
+        board(other.board, TrackingAllocator<BOARD_TILE>(&memory, BOARD_MEMORY)),
+        occupancy(other.occupancy),
+        crossfitters_mask(other.crossfitters_mask),
+        powerlifters_mask(other.powerlifters_mask),
         crossfitters_count(other.crossfitters_count),
-        powerlifters_count(other.powerlifters_count)
+        powerlifters_count(other.powerlifters_count),
+        hash(other.hash),
+        event_sink(nullptr),
+        effect_scheduler(nullptr),
+        attack_outcome(),
+        journal_id(makeJournalId()),
+        base_journal_id(other.journal_id),
+        base_position(other.journal.size()),
+        journal(TrackingAllocator<GridPoint>(&memory, JOURNAL_MEMORY))
     {
         if (&other == nullptr) {
             throw IllegalArgument();
         }
-        copyBoard(other.board);
     }
 
     Game& Game::operator=(const Game& other)
@@ -45,34 +96,33 @@ namespace mtm
 
         height = other.height;
         width = other.width;
-        copyBoard(other.board);
+        units = other.units; // the cloned characters keep their slots, so the board's handles stay valid.
+        board = other.board;
+        occupancy = other.occupancy;
+        crossfitters_mask = other.crossfitters_mask;
+        powerlifters_mask = other.powerlifters_mask;
         crossfitters_count = other.crossfitters_count;
         powerlifters_count = other.powerlifters_count;
+        hash = other.hash;
+        resetJournal();
+        base_journal_id = other.journal_id;
+        base_position = other.journal.size();
 
         return *this;
     }
 
-    void Game::copyBoard(const BOARD_MAP& other)
-    {
-        board.clear();
-        for (BOARD_MAP::const_iterator iterator = other.begin(); iterator != other.end(); ++iterator) {
-            board.emplace(MAKE_TILE(GridPoint((*iterator).first),
-                                    std::shared_ptr<Character>((*(*iterator).second).clone())));
-        }
-    }
-
-    bool Game::isCellEmpty(const GridPoint& coordinates)
+    bool Game::isCellEmpty(const GridPoint& coordinates) const
     {
-        return board.find(coordinates) == board.end();
+        return !occupancy.test(coordinates);
     }
 
-    bool Game::isOutOfBound(const GridPoint& coordinates)
+    bool Game::isOutOfBound(const GridPoint& coordinates) const
     {
         return (coordinates.col < 0 || coordinates.row < 0 || 
                 coordinates.col >= width || coordinates.row >= height);
     }
 
-    void Game::addCharacter(const GridPoint& coordinates, shared_ptr<Character> character)
+    UnitHandle Game::addCharacter(const GridPoint& coordinates, shared_ptr<Character> character)
     {
         if (&coordinates == nullptr || character == nullptr) {
             throw IllegalArgument();
@@ -83,10 +133,141 @@ namespace mtm
         if (!isCellEmpty(coordinates)) {
             throw CellOccupied();
         }
-        board.emplace(MAKE_TILE(coordinates, character));
+        UnitHandle handle = units.insert(character, coordinates);
+        board.emplace(MAKE_TILE(coordinates, handle));
+        markCell(coordinates, (*character).getTeam());
+        recordChange(coordinates);
+        hash ^= Zobrist::getCharacterKey(coordinates, *character);
         (*character).getTeam() == CROSSFITTERS ? ++crossfitters_count : ++powerlifters_count;
+
+        if (event_sink != nullptr) {
+            (*event_sink).emit(GameEvent(UNIT_ADDED_EVENT, coordinates, coordinates,
+                                         (*character).getTeam(), (*character).getHealth()));
+        }
+        return handle;
     }
     
+    bool Game::hasValidStats(const UnitDescriptor& unit)
+    {
+        return (unit.health > 0 && unit.ammo >= 0 && unit.range >= 0 && unit.power >= 0 &&
+                (unit.type == SOLDIER || unit.type == MEDIC || unit.type == SNIPER));
+    }
+
+    size_t Game::findInvalidUnit(const UnitDescriptor* begin, const UnitDescriptor* end) const
+    {
+        for (const UnitDescriptor* unit = begin; unit != end; ++unit) {
+            if (!hasValidStats(*unit) || isOutOfBound((*unit).coordinates)) {
+                return size_t(unit - begin);
+            }
+        }
+        return size_t(end - begin);
+    }
+
+    size_t Game::findOccupiedUnit(const UnitDescriptor* begin, const UnitDescriptor* end,
+                                  std::vector<size_t, TrackingAllocator<size_t>>& order) const
+    {
+        size_t count = size_t(end - begin);
+        size_t first_occupied = count;
+        ComparePoints compare;
+
+        bool sorted = true;
+        for (size_t i = 0; i < count; ++i) {
+            if (!isCellEmpty(begin[i].coordinates)) {
+                first_occupied = std::min(first_occupied, i);
+            }
+            if (i > 0 && !compare(begin[i - 1].coordinates, begin[i].coordinates)) {
+                sorted = false;
+            }
+        }
+        if (sorted) {
+            return first_occupied; // strictly increasing coordinates can not repeat a cell.
+        }
+
+        order.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [begin, &compare](size_t first, size_t second) {
+            if (compare(begin[first].coordinates, begin[second].coordinates)) {
+                return true;
+            }
+            if (compare(begin[second].coordinates, begin[first].coordinates)) {
+                return false;
+            }
+            return first < second;
+        });
+
+        // within a group of units sharing a cell, every unit but the first one finds the cell occupied.
+        for (size_t i = 1; i < count; ++i) {
+            if (begin[order[i - 1]].coordinates == begin[order[i]].coordinates) {
+                first_occupied = std::min(first_occupied, order[i]);
+            }
+        }
+        return first_occupied;
+    }
+
+    void Game::loadUnits(const UnitDescriptor* begin, const UnitDescriptor* end)
+    {
+        if (begin == nullptr && end != nullptr) {
+            throw IllegalArgument();
+        }
+
+        // only the units before the first invalid one would have been added one by one,
+        // so only they can make an earlier CellOccupied.
+        size_t first_invalid = findInvalidUnit(begin, end);
+        std::vector<size_t, TrackingAllocator<size_t>> order(TrackingAllocator<size_t>(&memory, TEMPORARY_MEMORY));
+        if (findOccupiedUnit(begin, begin + first_invalid, order) < first_invalid) {
+            throw CellOccupied();
+        }
+        if (first_invalid < size_t(end - begin)) {
+            if (!hasValidStats(begin[first_invalid])) {
+                throw IllegalArgument(); // makeCharacter fails before addCharacter is called.
+            }
+            throw IllegalCell();
+        }
+
+        if (order.empty()) {
+            loadValidUnits(begin, end);
+            return;
+        }
+
+        std::vector<UnitDescriptor, TrackingAllocator<UnitDescriptor>> sorted_units(
+            TrackingAllocator<UnitDescriptor>(&memory, TEMPORARY_MEMORY));
+        sorted_units.reserve(order.size());
+        for (size_t index : order) {
+            sorted_units.push_back(begin[index]);
+        }
+        loadValidUnits(sorted_units.data(), sorted_units.data() + sorted_units.size());
+    }
+
+    void Game::loadValidUnits(const UnitDescriptor* begin, const UnitDescriptor* end)
+    {
+        ComparePoints compare;
+        BOARD_MAP::iterator hint = board.begin();
+
+        for (const UnitDescriptor* unit = begin; unit != end; ++unit) {
+            shared_ptr<Character> character = makeCharacter((*unit).type, (*unit).team, (*unit).health,
+                                                            (*unit).ammo, (*unit).range, (*unit).power,
+                                                            units.getAllocator());
+
+            // merge walk: for sorted input the hint only moves forward, so every insertion is amortized O(1).
+            while (hint != board.end() && compare((*hint).first, (*unit).coordinates)) {
+                ++hint;
+            }
+            UnitHandle handle = units.insert(character, (*unit).coordinates, true);
+            hint = board.emplace_hint(hint, MAKE_TILE((*unit).coordinates, handle));
+            ++hint;
+            markCell((*unit).coordinates, (*unit).team);
+            recordChange((*unit).coordinates);
+            hash ^= Zobrist::getCharacterKey((*unit).coordinates, *character);
+            if (event_sink != nullptr) {
+                (*event_sink).emit(GameEvent(UNIT_ADDED_EVENT, (*unit).coordinates, (*unit).coordinates,
+                                             (*unit).team, (*unit).health));
+            }
+            (*unit).team == CROSSFITTERS ? ++crossfitters_count : ++powerlifters_count;
+        }
+    }
+
     void Game::move(const GridPoint& src_coordinates, const GridPoint& dst_coordinates)
     {
         if (&src_coordinates == nullptr || &dst_coordinates == nullptr) {
@@ -99,7 +280,9 @@ namespace mtm
             throw CellEmpty();
         }
 
-        shared_ptr<Character> character_ptr = board[src_coordinates];
+        BOARD_MAP::iterator source = board.find(src_coordinates);
+        UnitHandle handle = (*source).second;
+        Character* character_ptr = &units[handle];
         if (GridPoint::distance(src_coordinates, dst_coordinates) > (*character_ptr).getTravelDistance()) {
             throw MoveTooFar();
         }
@@ -107,12 +290,58 @@ namespace mtm
             throw CellOccupied();
         }
 
-        board.erase(src_coordinates);
-        board.emplace(MAKE_TILE(dst_coordinates, character_ptr));
+        board.erase(source);
+        unmarkCell(src_coordinates);
+        board.emplace(MAKE_TILE(dst_coordinates, handle));
+        units.setCoordinates(handle, dst_coordinates);
+        markCell(dst_coordinates, (*character_ptr).getTeam());
+        recordChange(src_coordinates);
+        recordChange(dst_coordinates);
+        hash ^= Zobrist::getCharacterKey(src_coordinates, *character_ptr) ^
+                Zobrist::getCharacterKey(dst_coordinates, *character_ptr);
+
+        if (event_sink != nullptr) {
+            (*event_sink).emit(GameEvent(MOVED_EVENT, dst_coordinates, src_coordinates, (*character_ptr).getTeam(), 0));
+        }
     }
     
+    AttackOutcome::AttackOutcome() :
+        hash_delta(0),
+        changed(),
+        killed(),
+        events()
+    {}
+
+    void AttackOutcome::clear()
+    {
+        hash_delta = 0;
+        changed.clear();
+        killed.clear();
+        events.clear();
+    }
+
+    /**
+     * recordHealthChange: adds the damage or heal event of a character whose health changed to an outcome.
+     */
+    static void recordHealthChange(AttackOutcome& outcome, const GridPoint& coordinates, const GridPoint& source,
+                                   const Character& character, units_t old_health)
+    {
+        units_t change = character.getHealth() - old_health;
+        if (change != 0) {
+            outcome.events.push_back(GameEvent(change < 0 ? DAMAGED_EVENT : HEALED_EVENT, coordinates, source,
+                                               character.getTeam(), change < 0 ? -change : change));
+        }
+    }
+
     void Game::attack(const GridPoint& src_coordinates, const GridPoint& dst_coordinates)
     {
+        applyAttack(src_coordinates, dst_coordinates, attack_outcome);
+        commitAttack(attack_outcome);
+    }
+
+    void Game::applyAttack(const GridPoint& src_coordinates, const GridPoint& dst_coordinates, AttackOutcome& outcome)
+    {
+        outcome.clear();
         if (&src_coordinates == nullptr || &dst_coordinates == nullptr) {
             throw IllegalArgument();
         }
@@ -123,65 +352,227 @@ namespace mtm
             throw CellEmpty();
         }
 
-        Character& attacking_character = *board[src_coordinates];
+        // the board is only searched (never inserted into), so concurrent attacks do not race on its structure.
+        Character& attacking_character = units[(*board.find(src_coordinates)).second];
         if (!attacking_character.isInAttackRange(src_coordinates, dst_coordinates)) {
             throw OutOfRange();
         }
 
-        Character& attacked_character = *board[dst_coordinates]; // handle with care, might need by a nullptr.
-        if (!Character::exists(attacked_character)) {
-            board.erase(dst_coordinates);
-        }
+        BOARD_MAP::iterator target = board.find(dst_coordinates);
+        Character* attacked_character = target != board.end() ? &units[(*target).second] : nullptr;
         if (!attacking_character.hasAmmoToAttack(attacked_character)) {
             throw OutOfAmmo();
         }
+
+        // the keys of the attacker and of the target (unless the attacker attacks itself) before the attack.
+        bool is_attacked_other = attacked_character != nullptr && attacked_character != &attacking_character;
+        uint64_t old_keys = Zobrist::getCharacterKey(src_coordinates, attacking_character) ^
+                            (is_attacked_other ? Zobrist::getCharacterKey(dst_coordinates, *attacked_character) : 0);
+        units_t old_health = attacked_character != nullptr ? (*attacked_character).getHealth() : 0;
+
         if (!attacking_character.isInAttackRange2(src_coordinates, dst_coordinates)
           ||!attacking_character.attack(attacked_character)) {
             throw IllegalTarget();
         }
 
-        if (!Character::exists(attacked_character) || !attacked_character.isAlive()) {
-            kill(attacked_character);
-            board.erase(dst_coordinates);
+        outcome.hash_delta = old_keys;
+        outcome.changed.push_back(src_coordinates);
+        if (is_attacked_other) {
+            outcome.changed.push_back(dst_coordinates);
+        }
+        if (attacking_character.isAlive()) {
+            outcome.hash_delta ^= Zobrist::getCharacterKey(src_coordinates, attacking_character);
+        }
+        if (is_attacked_other && (*attacked_character).isAlive()) {
+            outcome.hash_delta ^= Zobrist::getCharacterKey(dst_coordinates, *attacked_character);
+        }
+
+        if (event_sink != nullptr && attacked_character != nullptr) {
+            recordHealthChange(outcome, dst_coordinates, src_coordinates, *attacked_character, old_health);
+        }
+        if (attacked_character != nullptr && !(*attacked_character).isAlive()) {
+            outcome.killed.push_back(dst_coordinates);
+        }
+        if (attacking_character.getSplashRadius() > 0) {
+            attackNearbyCharacters(attacking_character, dst_coordinates, outcome);
+        }
+    }
+
+    void Game::commitAttack(const AttackOutcome& outcome)
+    {
+        hash ^= outcome.hash_delta;
+        for (const GridPoint& coordinates : outcome.changed) {
+            recordChange(coordinates);
+        }
+        for (size_t index = 0; event_sink != nullptr && index < outcome.events.size(); ++index) {
+            (*event_sink).emit(outcome.events[index]);
+        }
+
+        for (const GridPoint& coordinates : outcome.killed) {
+            BOARD_MAP::iterator killed = board.find(coordinates);
+            UnitHandle handle = (*killed).second;
+            Team team = units[handle].getTeam();
+            kill(handle);
+            unmarkCell(coordinates);
+            board.erase(killed);
+            units.remove(handle);
+            if (event_sink != nullptr) {
+                (*event_sink).emit(GameEvent(KILLED_EVENT, coordinates, coordinates, team, 0));
+            }
         }
-        if (attacking_character.getType() == SOLDIER) {
-            attackNearbyCharacters(attacking_character, dst_coordinates);
+
+        Team winning_team;
+        if (event_sink != nullptr && !outcome.killed.empty() && isOver(&winning_team)) {
+            (*event_sink).emit(GameEvent(GAME_OVER_EVENT, GridPoint(0, 0), GridPoint(0, 0), winning_team, 0));
         }
     }
 
-    void Game::attackNearbyCharacters(const Character& soldier, const GridPoint& dst_coordinates)
+    void Game::attackNearbyCharacters(const Character& soldier, const GridPoint& dst_coordinates,
+                                      AttackOutcome& outcome) const
     {
-        IsInSoldierAttackRange predicate(soldier, dst_coordinates);
+        int radius = soldier.getSplashRadius();
+        const Bitboard& enemies = teamMask(soldier.getTeam() == CROSSFITTERS ? POWERLIFTERS : CROSSFITTERS);
 
-        for (BOARD_MAP::iterator iterator = std::find_if(board.begin(), board.end(), predicate);
-            iterator != board.end();
-            iterator = std::find_if(++iterator, board.end(), predicate))
+        int first_row = std::max(0, dst_coordinates.row - radius);
+        int last_row  = std::min(height - 1, dst_coordinates.row + radius);
+        for (int row = first_row; row <= last_row; ++row)
         {
-            BOARD_TILE other_attacked_pair = *iterator;
-            Character& other_attacked_character = *other_attacked_pair.second;
-            soldier.attackNearbyCharacter(other_attacked_character);
-            if (!other_attacked_character.isAlive())
+            // the splash area is a diamond, so every row covers a narrower span of columns.
+            int span = radius - std::abs(row - dst_coordinates.row);
+            int first_col = std::max(0, dst_coordinates.col - span);
+            int last_col  = std::min(width - 1, dst_coordinates.col + span);
+
+            for (int col = enemies.findNextInRow(row, first_col, last_col);
+                col != -1;
+                col = enemies.findNextInRow(row, col + 1, last_col))
             {
-                // nasty trinary operator to keep the iterator valid after delition.
-                BOARD_MAP::iterator* new_iterator = (iterator != board.begin() ? &(--iterator) : nullptr); 
-
-                // character's delition.
-                kill(other_attacked_character);
-                board.erase(other_attacked_pair.first);
-
-                // keeping the iterator valid (board.begin() if we deleted the first element, otherwise --iterator).
-                iterator = (new_iterator == nullptr) ? board.begin() : *new_iterator;
+                const GridPoint other_coordinates(row, col);
+                if (other_coordinates == dst_coordinates) {
+                    continue;
+                }
+
+                Character& other_attacked_character = units[board.find(other_coordinates)->second];
+                outcome.hash_delta ^= Zobrist::getCharacterKey(other_coordinates, other_attacked_character);
+                outcome.changed.push_back(other_coordinates);
+                units_t old_health = other_attacked_character.getHealth();
+                soldier.attackNearbyCharacter(other_attacked_character);
+                if (event_sink != nullptr) {
+                    recordHealthChange(outcome, other_coordinates, dst_coordinates, other_attacked_character, old_health);
+                }
+                if (other_attacked_character.isAlive()) {
+                    outcome.hash_delta ^= Zobrist::getCharacterKey(other_coordinates, other_attacked_character);
+                }
+                else {
+                    outcome.killed.push_back(other_coordinates);
+                }
             }
         }
     }
     
-    void Game::kill(const Character& character)
+    void Game::kill(UnitHandle unit)
     {
-        if (!Character::exists(character)) {
-            return;
+        units[unit].getTeam() == POWERLIFTERS ? --powerlifters_count : --crossfitters_count;
+        if (effect_scheduler != nullptr) {
+            (*effect_scheduler).cancelUnit(unit);
+        }
+    }
+    
+    Bitboard& Game::teamMask(Team team)
+    {
+        return team == CROSSFITTERS ? crossfitters_mask : powerlifters_mask;
+    }
+
+    const Bitboard& Game::teamMask(Team team) const
+    {
+        return team == CROSSFITTERS ? crossfitters_mask : powerlifters_mask;
+    }
+
+    void Game::markCell(const GridPoint& coordinates, Team team)
+    {
+        occupancy.set(coordinates);
+        teamMask(team).set(coordinates);
+    }
+
+    void Game::unmarkCell(const GridPoint& coordinates)
+    {
+        occupancy.reset(coordinates);
+        crossfitters_mask.reset(coordinates);
+        powerlifters_mask.reset(coordinates);
+    }
+
+    void Game::recordChange(const GridPoint& coordinates)
+    {
+        if (journal.size() >= std::max(MIN_JOURNAL_SIZE, 2 * size_t(crossfitters_count + powerlifters_count))) {
+            resetJournal();
         }
+        journal.push_back(coordinates);
+    }
+
+    void Game::resetJournal()
+    {
+        journal.clear();
+        journal_id = makeJournalId();
+        base_journal_id = 0;
+        base_position = 0;
+    }
+
+    UnitHandle Game::detachUnit(const GridPoint& coordinates)
+    {
+        BOARD_MAP::iterator tile = board.find(coordinates);
+        UnitHandle handle = (*tile).second;
+        hash ^= Zobrist::getCharacterKey(coordinates, units[handle]);
+        board.erase(tile);
+        unmarkCell(coordinates);
+        recordChange(coordinates);
+        return handle;
+    }
+
+    void Game::attachUnit(const GridPoint& src_coordinates, const GridPoint& dst_coordinates, UnitHandle unit)
+    {
+        const Character& character = units[unit];
+        board.emplace(MAKE_TILE(dst_coordinates, unit));
+        units.setCoordinates(unit, dst_coordinates);
+        markCell(dst_coordinates, character.getTeam());
+        hash ^= Zobrist::getCharacterKey(dst_coordinates, character);
+        recordChange(dst_coordinates);
 
-        character.getTeam() == POWERLIFTERS ? --powerlifters_count : --crossfitters_count;
+        if (event_sink != nullptr) {
+            (*event_sink).emit(GameEvent(MOVED_EVENT, dst_coordinates, src_coordinates, character.getTeam(), 0));
+        }
+    }
+
+    void Game::removeUnit(const GridPoint& coordinates)
+    {
+        UnitHandle handle = detachUnit(coordinates);
+        Team team = units[handle].getTeam();
+        kill(handle);
+        units.remove(handle);
+
+        if (event_sink != nullptr) {
+            (*event_sink).emit(GameEvent(KILLED_EVENT, coordinates, coordinates, team, 0));
+        }
+    }
+
+    void Game::restoreUnit(const GridPoint& coordinates, units_t health, units_t ammo, int counter)
+    {
+        Character& character = units[(*board.find(coordinates)).second];
+        units_t old_health = character.getHealth();
+        units_t old_ammo = character.getAmmo();
+        hash ^= Zobrist::getCharacterKey(coordinates, character);
+        character.restore(health, ammo);
+        character.setAttackCounter(counter);
+        hash ^= Zobrist::getCharacterKey(coordinates, character);
+        recordChange(coordinates);
+
+        if (event_sink != nullptr && health != old_health) {
+            (*event_sink).emit(GameEvent(health < old_health ? DAMAGED_EVENT : HEALED_EVENT, coordinates, coordinates,
+                                         character.getTeam(), health < old_health ? old_health - health
+                                                                                  : health - old_health));
+        }
+        if (event_sink != nullptr && ammo > old_ammo) {
+            (*event_sink).emit(GameEvent(RELOADED_EVENT, coordinates, coordinates, character.getTeam(),
+                                         ammo - old_ammo));
+        }
     }
     
     void Game::reload(const GridPoint& coordinates)
@@ -196,7 +587,17 @@ namespace mtm
             throw CellEmpty();
         }
 
-        (*board[coordinates]).reload();
+        Character& character = units[(*board.find(coordinates)).second];
+        units_t old_ammo = character.getAmmo();
+        hash ^= Zobrist::getCharacterKey(coordinates, character);
+        character.reload();
+        hash ^= Zobrist::getCharacterKey(coordinates, character);
+        recordChange(coordinates);
+
+        if (event_sink != nullptr) {
+            (*event_sink).emit(GameEvent(RELOADED_EVENT, coordinates, coordinates,
+                                         character.getTeam(), character.getAmmo() - old_ammo));
+        }
     }
 
     bool Game::isOver(Team* winningTeam) const
@@ -222,44 +623,330 @@ namespace mtm
         return false;
     }
 
-    std::ostream& operator<<(std::ostream& os, const Game& game)
+    bool Game::isEnemyCell(const GridPoint& coordinates, Team team) const
     {
-        if (&os == nullptr || &game == nullptr) {
+        if (&coordinates == nullptr) {
             throw IllegalArgument();
         }
+        if (isOutOfBound(coordinates)) {
+            throw IllegalCell();
+        }
 
-        int width = game.width;
-        int height = game.height;
-        int length = width * height;
+        return teamMask(team == CROSSFITTERS ? POWERLIFTERS : CROSSFITTERS).test(coordinates);
+    }
 
-        BOARD_MAP board = game.board;
-        char* board_char = new char[length];
+    const Character* Game::getCharacter(const GridPoint& coordinates) const
+    {
+        if (&coordinates == nullptr) {
+            throw IllegalArgument();
+        }
+        if (isOutOfBound(coordinates)) {
+            throw IllegalCell();
+        }
+        if (isCellEmpty(coordinates)) {
+            return nullptr;
+        }
 
-        BOARD_MAP::iterator iterator = board.begin();
+        return &units[(*board.find(coordinates)).second];
+    }
 
-        int i = 0;
-        for (; i < length && iterator != board.end(); ++i)
-        {
-            const GridPoint board_point = (*iterator).first;
-            if (board_point == GridPoint(i / width, i % width)) {
-                Character& character = *(*iterator).second;
-                board_char[i] = character.convertToChar();
-                ++iterator;
+    const Character* Game::getCharacter(UnitHandle unit) const
+    {
+        return units.get(unit);
+    }
+
+    UnitHandle Game::getHandle(const GridPoint& coordinates) const
+    {
+        if (&coordinates == nullptr) {
+            throw IllegalArgument();
+        }
+        if (isOutOfBound(coordinates)) {
+            throw IllegalCell();
+        }
+        if (isCellEmpty(coordinates)) {
+            return UnitHandle();
+        }
+
+        return (*board.find(coordinates)).second;
+    }
+
+    GridPoint Game::getCoordinates(UnitHandle unit) const
+    {
+        if (!units.isValid(unit)) {
+            throw IllegalArgument();
+        }
+        return units.getCoordinates(unit);
+    }
+
+    bool Game::isValid(UnitHandle unit) const
+    {
+        return units.isValid(unit);
+    }
+
+    void Game::move(UnitHandle unit, const GridPoint& dst_coordinates)
+    {
+        move(getCoordinates(unit), dst_coordinates);
+    }
+
+    void Game::attack(UnitHandle unit, const GridPoint& dst_coordinates)
+    {
+        attack(getCoordinates(unit), dst_coordinates);
+    }
+
+    void Game::reload(UnitHandle unit)
+    {
+        reload(getCoordinates(unit));
+    }
+
+    void Game::addHealth(UnitHandle unit, units_t value)
+    {
+        const GridPoint coordinates = getCoordinates(unit);
+        Character& character = units[unit];
+        units_t old_health = character.getHealth();
+
+        AttackOutcome& outcome = attack_outcome;
+        outcome.clear();
+        outcome.hash_delta = Zobrist::getCharacterKey(coordinates, character);
+        character.addHealth(value);
+        if (character.isAlive()) {
+            outcome.hash_delta ^= Zobrist::getCharacterKey(coordinates, character);
+        }
+        else {
+            outcome.killed.push_back(coordinates);
+        }
+        outcome.changed.push_back(coordinates);
+        if (event_sink != nullptr) {
+            recordHealthChange(outcome, coordinates, coordinates, character, old_health);
+        }
+
+        commitAttack(outcome);
+    }
+
+    bool Game::isLegalMove(const GridPoint& src_coordinates, const GridPoint& dst_coordinates) const
+    {
+        if (isOutOfBound(src_coordinates) || isOutOfBound(dst_coordinates) ||
+            isCellEmpty(src_coordinates) || !isCellEmpty(dst_coordinates)) {
+            return false;
+        }
+
+        const Character& character = units[(*board.find(src_coordinates)).second];
+        return GridPoint::distance(src_coordinates, dst_coordinates) <= character.getTravelDistance();
+    }
+
+    bool Game::isLegalAttack(const GridPoint& src_coordinates, const GridPoint& dst_coordinates) const
+    {
+        if (isOutOfBound(src_coordinates) || isOutOfBound(dst_coordinates) || isCellEmpty(src_coordinates)) {
+            return false;
+        }
+
+        Character& attacking_character = units[(*board.find(src_coordinates)).second];
+        const Character* attacked_character = isCellEmpty(dst_coordinates) ? nullptr :
+                                              &units[(*board.find(dst_coordinates)).second];
+
+        // same checks, in the same order, as in attack.
+        if (!attacking_character.isInAttackRange(src_coordinates, dst_coordinates)) {
+            return false;
+        }
+        if (!attacking_character.hasAmmoToAttack(attacked_character)) {
+            return false;
+        }
+        return (attacking_character.isInAttackRange2(src_coordinates, dst_coordinates) &&
+                attacking_character.isLegalTarget(attacked_character));
+    }
+
+    int Game::getHeight() const
+    {
+        return height;
+    }
+
+    int Game::getWidth() const
+    {
+        return width;
+    }
+
+    uint64_t Game::getHash() const
+    {
+        return hash;
+    }
+
+    void Game::setEventSink(GameEventSink* sink)
+    {
+        event_sink = sink;
+    }
+
+    GameEventSink* Game::getEventSink() const
+    {
+        return event_sink;
+    }
+
+    void Game::setEffectScheduler(EffectScheduler* scheduler)
+    {
+        effect_scheduler = scheduler;
+    }
+
+    EffectScheduler* Game::getEffectScheduler() const
+    {
+        return effect_scheduler;
+    }
+
+    uint64_t Game::computeHash() const
+    {
+        uint64_t full_hash = 0;
+        forEachCharacter([&full_hash](const GridPoint& coordinates, const Character& character) {
+            full_hash ^= Zobrist::getCharacterKey(coordinates, character);
+        });
+        return full_hash;
+    }
+
+    MemoryReport Game::getMemoryReport() const
+    {
+        MemoryReport report;
+        report.categories[BOARD_MEMORY] = memory.getUsage(BOARD_MEMORY);
+        report.categories[UNITS_MEMORY] = units.getMemoryUsage();
+        report.categories[JOURNAL_MEMORY] = memory.getUsage(JOURNAL_MEMORY);
+        report.categories[TEMPORARY_MEMORY] = memory.getUsage(TEMPORARY_MEMORY);
+
+        MemoryUsage& index = report.categories[INDEX_MEMORY];
+        for (const Bitboard* bitboard : {&occupancy, &crossfitters_mask, &powerlifters_mask}) {
+            index.bytes += (*bitboard).getMemoryUsage();
+            index.allocations += (*bitboard).getAllocationsCount();
+        }
+        index.peak_bytes = index.bytes;
+        index.total_allocations = index.allocations;
+
+        report.units_count = crossfitters_count + powerlifters_count;
+        return report;
+    }
+
+    MemoryTracker& Game::getMemoryTracker() const
+    {
+        return memory;
+    }
+
+    long long Game::countCharacters(Team team, const GridPoint& top_left, const GridPoint& bottom_right) const
+    {
+        if (&top_left == nullptr || &bottom_right == nullptr) {
+            throw IllegalArgument();
+        }
+        if (isOutOfBound(top_left) || isOutOfBound(bottom_right)) {
+            throw IllegalCell();
+        }
+        if (top_left.row > bottom_right.row || top_left.col > bottom_right.col) {
+            throw IllegalArgument();
+        }
+
+        return teamMask(team).countRegion(top_left, bottom_right);
+    }
+
+    std::ostream& Game::printViewport(std::ostream& os, const GridPoint& top_left, int rows, int cols) const
+    {
+        if (&os == nullptr || &top_left == nullptr || rows <= 0 || cols <= 0) {
+            throw IllegalArgument();
+        }
+        if (isOutOfBound(top_left)) {
+            throw IllegalCell();
+        }
+
+        rows = std::min(rows, height - top_left.row);
+        cols = std::min(cols, width - top_left.col);
+        int last_col = top_left.col + cols - 1;
+
+        std::vector<char, TrackingAllocator<char>> board_char(size_t(rows) * size_t(cols), ' ',
+                                                              TrackingAllocator<char>(&memory, TEMPORARY_MEMORY));
+
+        for (int i = 0; i < rows; ++i) {
+            int row = top_left.row + i;
+            if (occupancy.findNextInRow(row, top_left.col, last_col) < 0) {
+                continue;
             }
-            else {
-                board_char[i] = ' ';
+
+            char* row_char = board_char.data() + size_t(i) * size_t(cols);
+            BOARD_MAP::const_iterator iterator = board.lower_bound(GridPoint(row, top_left.col));
+            for (; iterator != board.end() && (*iterator).first.row == row && (*iterator).first.col <= last_col;
+                 ++iterator) {
+                row_char[(*iterator).first.col - top_left.col] = units[(*iterator).second].convertToChar();
             }
         }
-        for (; i < length; board_char[i++] = ' ');
 
-        printGameBoard(os, board_char, board_char + i, width);
-        delete[] board_char;
+        return printGameBoard(os, board_char.data(), board_char.data() + board_char.size(), cols);
+    }
+
+    std::ostream& Game::printOverview(std::ostream& os, const GridPoint& top_left, int rows, int cols,
+                                      int block_height, int block_width) const
+    {
+        static const int OVERVIEW_LEVELS = 9;
+
+        if (&os == nullptr || &top_left == nullptr || rows <= 0 || cols <= 0 || block_height <= 0 || block_width <= 0) {
+            throw IllegalArgument();
+        }
+        if (isOutOfBound(top_left)) {
+            throw IllegalCell();
+        }
+
+        rows = std::min(rows, height - top_left.row);
+        cols = std::min(cols, width - top_left.col);
+        int overview_rows = (rows - 1) / block_height + 1;
+        int overview_cols = (cols - 1) / block_width + 1;
+
+        std::vector<char, TrackingAllocator<char>> board_char(size_t(overview_rows) * size_t(overview_cols), ' ',
+                                                              TrackingAllocator<char>(&memory, TEMPORARY_MEMORY));
+
+        for (int i = 0; i < overview_rows; ++i) {
+            int first_row = top_left.row + i * block_height;
+            // the block's size is added last, as a block taller than the board would overflow first_row + size.
+            int last_row = first_row + std::min(block_height - 1, top_left.row + rows - 1 - first_row);
+            for (int j = 0; j < overview_cols; ++j) {
+                int first_col = top_left.col + j * block_width;
+                int last_col = first_col + std::min(block_width - 1, top_left.col + cols - 1 - first_col);
+
+                const GridPoint block_top_left(first_row, first_col);
+                const GridPoint block_bottom_right(last_row, last_col);
+                long long powerlifters = powerlifters_mask.countRegion(block_top_left, block_bottom_right);
+                long long crossfitters = crossfitters_mask.countRegion(block_top_left, block_bottom_right);
+                long long count = powerlifters + crossfitters;
+                if (count == 0) {
+                    continue;
+                }
+
+                long long area = (long long)(last_row - first_row + 1) * (last_col - first_col + 1);
+                int level = int((count * OVERVIEW_LEVELS + area - 1) / area);
+
+                char& block_char = board_char[size_t(i) * size_t(overview_cols) + size_t(j)];
+                if (powerlifters > crossfitters) {
+                    block_char = char('A' + level - 1);
+                }
+                else if (crossfitters > powerlifters) {
+                    block_char = char('a' + level - 1);
+                }
+                else {
+                    block_char = char('0' + level);
+                }
+            }
+        }
 
-        return os;
+        return printGameBoard(os, board_char.data(), board_char.data() + board_char.size(), overview_cols);
+    }
+
+    std::ostream& operator<<(std::ostream& os, const Game& game)
+    {
+        if (&os == nullptr || &game == nullptr) {
+            throw IllegalArgument();
+        }
+
+        return game.printViewport(os, GridPoint(0, 0), game.height, game.width);
     }
 
     shared_ptr<Character> Game::makeCharacter(CharacterType type, Team team,
                                             units_t health, units_t ammo, units_t range, units_t power)
+    {
+        // a character created outside a game is counted by no tracker.
+        TrackingAllocator<Character> allocator(nullptr, UNITS_MEMORY);
+        return makeCharacter(type, team, health, ammo, range, power, allocator);
+    }
+
+    shared_ptr<Character> Game::makeCharacter(CharacterType type, Team team,
+                                            units_t health, units_t ammo, units_t range, units_t power,
+                                            const TrackingAllocator<Character>& allocator)
     {
         if (health <= 0 || ammo < 0 || range < 0 || power < 0) {
             throw IllegalArgument();
@@ -272,5 +959,11 @@ namespace mtm
             case SNIPER:  return MAKE_CHARACTER(Sniper); 
             default: throw IllegalArgument();
         }
-    } 
+    }
+
+    shared_ptr<Character> Game::makeCharacter(const UnitTypeRegistry& registry, UnitTypeId type, Team team,
+                                            units_t health, units_t ammo, units_t range, units_t power)
+    {
+        return registry.makeCharacter(type, team, health, ammo, range, power);
+    }
 }
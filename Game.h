@@ -16,18 +16,68 @@
 #define _GAME_H
 
 #include "Utilities.h" // also includes other utilities such as characters.
+#include "Bitboard.h"
+#include "UnitTypeRegistry.h"
+#include "Zobrist.h"
+#include "GameEvent.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <vector>
 
 namespace mtm
 {    
+    class EffectScheduler;
+
+    /**
+     * AttackOutcome - the changes an applied attack leaves to commit (see Game::applyAttack):
+     * the change of the game's hash, the cells of the characters that changed and of those that were killed and,
+     * if the game has an event sink, the damage and heal events to emit.
+     */
+    struct AttackOutcome
+    {
+        uint64_t hash_delta;
+        std::vector<GridPoint> changed;
+        std::vector<GridPoint> killed;
+        std::vector<GameEvent> events;
+
+        /**
+         * AttackOutcome constructor: creates an empty outcome.
+         */
+        AttackOutcome();
+
+        /**
+         * clear: empties the outcome, keeping its memory.
+         */
+        void clear();
+    };
+
     class Game
     {
+        static const size_t MIN_JOURNAL_SIZE = 1024;
+
         int height;
         int width;
+        mutable MemoryTracker memory; // declared before the containers that count in it.
+        UnitTable units;
         BOARD_MAP board;
+        Bitboard occupancy;
+        Bitboard crossfitters_mask;
+        Bitboard powerlifters_mask;
 	    unsigned int crossfitters_count;
         unsigned int powerlifters_count;
+        uint64_t hash;
+        GameEventSink* event_sink;
+        EffectScheduler* effect_scheduler;
+        AttackOutcome attack_outcome; // the outcome of the serial attacks, reused so they keep its memory.
+
+        // the journal of the changed cells, used by GameDiff to diff games that share history.
+        // a copy remembers the journal of its origin and its length at the time of the copy.
+        uint64_t journal_id;
+        uint64_t base_journal_id;
+        size_t base_position;
+        std::vector<GridPoint, TrackingAllocator<GridPoint>> journal;
 
         public:
             /**
@@ -47,11 +97,25 @@ namespace mtm
              * @return
              *     a new Game object, with:
              *          - width and height as the given parameters.
-             *          - crossfitters_count and powerlifters_count = 0.
-             *          - an empty board (std::map).
+             *          - crossfitters_count and powerlifters_count = 0, and the hash of an empty board (0).
+             *          - no event sink and no effect scheduler.
+             *          - an empty board (std::map) and empty occupancy and team bitboards.
              */
             Game(int height, int width);
 
+            /**
+             * Game constructor: creates a new Game with a board of the given dimensions, holding the given units.
+             *
+             * @param height, width - as described in Game(int height, int width).
+             * @param units         - the characters of the game. see loadUnits.
+             * 
+             * @throw
+             *     IllegalArgument - if the width or height are non-positive, or a unit's stats are incorrect.
+             *     IllegalCell     - if a unit is not within the board's range.
+             *     CellOccupied    - if two units share a cell.
+             */
+            Game(int height, int width, const std::vector<UnitDescriptor>& units);
+
             /**
              * Game copy constructor: creates a new game based on an existing one.
              *
@@ -97,8 +161,45 @@ namespace mtm
              *      IllegalCell     - if "coordinates" is not within the board's range.
              *      CellOccupied    - if there's already another player in "coordinates".
              * 
+             * @return
+             *     the handle of the character (see UnitTable.h). it stays valid until the character is killed.
+             */
+            UnitHandle addCharacter(const GridPoint& coordinates, std::shared_ptr<Character> character);
+
+            /**
+             * loadUnits: add many characters to the game at once.
+             * the whole input is validated first (one pass, then a sort and a duplicates scan),
+             * and the board is then built in a single merge walk.
+             *
+             * @param begin - a pointer to the first unit descriptor.
+             * @param end   - a pointer past the last unit descriptor.
+             * 
+             * @throw
+             *      IllegalArgument - if begin is nullptr (and end is not), or if one of the units' stats is incorrect.
+             *      IllegalCell     - if one of the units is not within the board's range.
+             *      CellOccupied    - if a unit lands on an occupied cell, or two units share a cell.
+             * 
+             * NOTE: the exception is the one that adding the units one by one (makeCharacter and addCharacter)
+             *       would throw first. unlike adding one by one, no unit is added if the input is rejected.
+             */
+            void loadUnits(const UnitDescriptor* begin, const UnitDescriptor* end);
+
+            /**
+             * loadValidUnits: add many characters to the game at once, without any validation.
+             * each character is appended to the end of the board, so sorted input is loaded in O(n).
+             *
+             * @param begin - a pointer to the first unit descriptor.
+             * @param end   - a pointer past the last unit descriptor.
+             * 
+             * @throw
+             *      IllegalArgument - if one of the units' stats is incorrect (see makeCharacter).
+             * 
+             * NOTE: the caller guarantees the input is valid: every unit is within the board's range,
+             *       lands on an empty cell, and no two units share a cell.
+             *       the units should be sorted by ComparePoints and placed after all the existing characters.
+             *       unsorted input is still loaded correctly, though more slowly.
              */
-            void addCharacter(const GridPoint& coordinates, std::shared_ptr<Character> character);
+            void loadValidUnits(const UnitDescriptor* begin, const UnitDescriptor* end);
 
             /**
              * move: moves a character from src_coordinates to dst_coordinates.
@@ -135,6 +236,30 @@ namespace mtm
              */
             void attack(const GridPoint& src_coordinates, const GridPoint& dst_coordinates);
 
+            /**
+             * applyAttack: the first half of attack - make a character attack, without removing the killed characters.
+             * only the characters of the attack's footprint are changed: the attacker, the attacked character and
+             * (for a splash attack) the enemies in the splash diamond around the destination.
+             * the board, the team counts and the hash are left to commitAttack, so attacks with disjoint footprints
+             * may be applied concurrently, as long as nothing else changes the game meanwhile.
+             *
+             * @param src_coordinates - the coordinates of the attacker character.   Must be non-nullptr.
+             * @param dst_coordinates - the coordinates of the attacked destination. Must be non-nullptr.
+             * @param outcome         - the result keeper. its previous content is removed.
+             * 
+             * @throw
+             *      the exceptions of attack, in the same cases. the game and the outcome are left unchanged.
+             */
+            void applyAttack(const GridPoint& src_coordinates, const GridPoint& dst_coordinates, AttackOutcome& outcome);
+
+            /**
+             * commitAttack: the second half of attack - removes the killed characters and updates the hash.
+             *
+             * @param outcome - the outcome of applyAttack. every outcome must be committed once, before the game
+             *                  is changed in any other way.
+             */
+            void commitAttack(const AttackOutcome& outcome);
+
             /**
              * reload: make a character in coordinates reload ammo.
              *
@@ -148,6 +273,32 @@ namespace mtm
              */
             void reload(const GridPoint& coordinates);
 
+            /**
+             * move, attack, reload: the actions of a character given by its handle, as described above.
+             *
+             * @param unit - the handle of the acting character.
+             *
+             * @throw
+             *      IllegalArgument - if the handle is not valid (null, or of a killed character).
+             *      the exceptions of the actions above otherwise.
+             */
+            void move(UnitHandle unit, const GridPoint& dst_coordinates);
+            void attack(UnitHandle unit, const GridPoint& dst_coordinates);
+            void reload(UnitHandle unit);
+
+            /**
+             * addHealth: changes the health of a character given by its handle, as an attack would:
+             * the character is killed (and removed) if its health drops to 0 or below.
+             * used by timed effects, such as damage over time (see EffectScheduler.h).
+             *
+             * @param unit  - the handle of the character.
+             * @param value - the health to add. a negative value is damage.
+             *
+             * @throw
+             *      IllegalArgument - if the handle is not valid (null, or of a killed character).
+             */
+            void addHealth(UnitHandle unit, units_t value);
+
             /**
              * isOver: checks if the game is over.
              *
@@ -163,6 +314,274 @@ namespace mtm
              */
             bool isOver(Team* winningTeam = NULL) const;
 
+            /**
+             * isEnemyCell: checks if a cell is occupied by an enemy of the given team, in O(1).
+             *
+             * @param coordinates - the coordinates of the cell. Must be non-nullptr.
+             * @param team        - the team whose enemies we look for.
+             * 
+             * @throw
+             *      IllegalArgument - if the argument is nullptr.
+             *      IllegalCell     - if the coordinates are not within the board's range.
+             * 
+             * @return
+             *     true if the cell holds a character of the other team, false otherwise.
+             */
+            bool isEnemyCell(const GridPoint& coordinates, Team team) const;
+
+            /**
+             * getCharacter: returns the character in a cell, for read-only queries.
+             *
+             * @param coordinates - the coordinates of the cell. Must be non-nullptr.
+             * 
+             * @throw
+             *      IllegalArgument - if the argument is nullptr.
+             *      IllegalCell     - if the coordinates are not within the board's range.
+             * 
+             * @return
+             *     a pointer to the character in the cell, or nullptr if the cell is empty.
+             *     the pointer is valid until the character is moved or removed from the board.
+             */
+            const Character* getCharacter(const GridPoint& coordinates) const;
+
+            /**
+             * getCharacter: returns the character of a handle, for read-only queries.
+             *
+             * @param unit - the handle of the character.
+             *
+             * @return
+             *     a pointer to the character, or nullptr if the handle is not valid.
+             *     the pointer is valid until the character is removed from the board (moves included).
+             */
+            const Character* getCharacter(UnitHandle unit) const;
+
+            /**
+             * getHandle: returns the handle of the character in a cell.
+             *
+             * @param coordinates - the coordinates of the cell. Must be non-nullptr.
+             * 
+             * @throw
+             *      IllegalArgument - if the argument is nullptr.
+             *      IllegalCell     - if the coordinates are not within the board's range.
+             * 
+             * @return
+             *     the handle of the character, or a null handle if the cell is empty.
+             */
+            UnitHandle getHandle(const GridPoint& coordinates) const;
+
+            /**
+             * getCoordinates: returns the coordinates of a character given by its handle, in O(1).
+             *
+             * @param unit - the handle of the character.
+             * 
+             * @throw
+             *      IllegalArgument - if the handle is not valid.
+             */
+            GridPoint getCoordinates(UnitHandle unit) const;
+
+            /**
+             * isValid: returns true if a handle is of a character that is still on the board, false otherwise.
+             */
+            bool isValid(UnitHandle unit) const;
+
+            /**
+             * isLegalMove: checks if move(src_coordinates, dst_coordinates) would succeed, without changing the game.
+             *
+             * @return
+             *     true if the move would succeed, false if it would throw any exception.
+             * 
+             * NOTE: the function does not throw any exceptions.
+             */
+            bool isLegalMove(const GridPoint& src_coordinates, const GridPoint& dst_coordinates) const;
+
+            /**
+             * isLegalAttack: checks if attack(src_coordinates, dst_coordinates) would succeed, without changing the game.
+             *
+             * @return
+             *     true if the attack would succeed, false if it would throw any exception.
+             * 
+             * NOTE: the function does not throw any exceptions.
+             */
+            bool isLegalAttack(const GridPoint& src_coordinates, const GridPoint& dst_coordinates) const;
+
+            /**
+             * getHeight: returns the number of rows of the board.
+             */
+            int getHeight() const;
+
+            /**
+             * getWidth: returns the number of columns of the board.
+             */
+            int getWidth() const;
+
+            /**
+             * forEachCharacter: visits every character of the board, in the board's order (row by row).
+             *
+             * @param visit - a function object, called as visit(const GridPoint&, const Character&).
+             *                it must not change the game.
+             */
+            template <class Visitor>
+            void forEachCharacter(Visitor visit) const
+            {
+                for (BOARD_MAP::const_iterator iterator = board.begin(); iterator != board.end(); ++iterator) {
+                    visit((*iterator).first, units[(*iterator).second]);
+                }
+            }
+
+            /**
+             * forEachCellInRange: visits the board's cells within a Manhattan radius of a cell, row by row.
+             * the rows and the column spans are clipped to the board, so a large radius never costs more than the
+             * board, and no coordinate overflows.
+             *
+             * @param center - the cell the radius is measured from.
+             * @param radius - the radius. a negative radius visits nothing.
+             * @param visit  - a function object, called as visit(const GridPoint&).
+             */
+            template <class Visitor>
+            void forEachCellInRange(const GridPoint& center, int radius, Visitor visit) const
+            {
+                long long first_row = std::max(0LL, (long long)center.row - radius);
+                long long last_row = std::min((long long)height - 1, (long long)center.row + radius);
+                for (long long row = first_row; row <= last_row; ++row) {
+                    long long col_span = radius - std::llabs(row - center.row);
+                    long long first_col = std::max(0LL, center.col - col_span);
+                    long long last_col = std::min((long long)width - 1, center.col + col_span);
+                    for (long long col = first_col; col <= last_col; ++col) {
+                        visit(GridPoint(int(row), int(col)));
+                    }
+                }
+            }
+
+            /**
+             * countCharacters: counts the characters of a team inside a rectangular region,
+             * using row-wise popcounts over the team's bitboard.
+             *
+             * @param team         - the team whose characters are counted.
+             * @param top_left     - the top left corner of the region.     Must be non-nullptr.
+             * @param bottom_right - the bottom right corner of the region. Must be non-nullptr.
+             * 
+             * @throw
+             *      IllegalArgument - if one of the arguments is nullptr, or if top_left is below or right of bottom_right.
+             *      IllegalCell     - if one of the corners is not within the board's range.
+             * 
+             * @return
+             *     the number of the team's characters in the region (corners included).
+             */
+            long long countCharacters(Team team, const GridPoint& top_left, const GridPoint& bottom_right) const;
+
+            /**
+             * printViewport: prints a window of the board, in the format of operator<<.
+             * every row is found with one lookup in the board and skipped at once if its occupancy is empty,
+             * so the print costs time proportional to the window rather than to the board.
+             *
+             * @param os       - a reference the output stream.
+             * @param top_left - the top left cell of the window. Must be non-nullptr.
+             * @param rows     - the number of rows of the window. must be positive.
+             * @param cols     - the number of columns of the window. must be positive.
+             *
+             * @throw
+             *      IllegalArgument - if one of the arguments is nullptr, or rows or cols are non-positive.
+             *      IllegalCell     - if top_left is not within the board's range.
+             *
+             * @return
+             *     the output stream (os) after the print has been done.
+             *
+             * NOTE: the window is clipped to the board's range.
+             */
+            std::ostream& printViewport(std::ostream& os, const GridPoint& top_left, int rows, int cols) const;
+
+            /**
+             * printOverview: prints a downsampled window of the board, in the format of operator<<.
+             * the window is split into blocks, and every block is printed as a single character summarizing
+             * the density of the teams' characters in it, counted with row-wise popcounts over the team bitboards:
+             *      ' '                - an empty block.
+             *      'A' ... 'I'        - a block held by more powerlifters than crossfitters.
+             *      'a' ... 'i'        - a block held by more crossfitters than powerlifters.
+             *      '1' ... '9'        - a contested block, held by as many characters of each team.
+             * the level (A = 1 to I = 9) is the ceiling of 9 times the fraction of the block's cells that hold a character.
+             *
+             * @param os           - a reference the output stream.
+             * @param top_left     - the top left cell of the window. Must be non-nullptr.
+             * @param rows, cols   - the dimensions of the window, in cells. must be positive.
+             * @param block_height - the number of rows summarized by a character. must be positive.
+             * @param block_width  - the number of columns summarized by a character. must be positive.
+             *
+             * @throw
+             *      IllegalArgument - if one of the arguments is nullptr, or one of the dimensions is non-positive.
+             *      IllegalCell     - if top_left is not within the board's range.
+             *
+             * @return
+             *     the output stream (os) after the print has been done.
+             *
+             * NOTE: the window is clipped to the board's range, and so are the blocks of its last row and column.
+             */
+            std::ostream& printOverview(std::ostream& os, const GridPoint& top_left, int rows, int cols,
+                                        int block_height, int block_width) const;
+
+            /**
+             * getHash: returns the Zobrist hash of the game's state (see Zobrist.h).
+             * the hash is kept up to date incrementally by every change of the game.
+             *
+             * @return
+             *     the hash. equal states have equal hashes, whatever the way they were reached.
+             */
+            uint64_t getHash() const;
+
+            /**
+             * setEventSink: subscribes a sink to the game's events (see GameEvent.h), replacing the previous one.
+             * every change of the game is emitted right after it is made. without a sink, nothing is recorded.
+             *
+             * @param sink - the sink. nullptr unsubscribes. the sink must outlive its subscription.
+             *
+             * NOTE: the sink is not copied by the copy constructor, and is kept by the assignment operator.
+             */
+            void setEventSink(GameEventSink* sink);
+
+            /**
+             * getEventSink: returns the subscribed sink, nullptr if there is none.
+             */
+            GameEventSink* getEventSink() const;
+
+            /**
+             * setEffectScheduler: attaches the scheduler of the game's timed effects, replacing the previous one.
+             * whenever a character is killed, the scheduler cancels its effects.
+             *
+             * @param scheduler - the scheduler. nullptr detaches. the scheduler must outlive its attachment.
+             *
+             * NOTE: the scheduler is not copied by the copy constructor, and is kept by the assignment operator.
+             */
+            void setEffectScheduler(EffectScheduler* scheduler);
+
+            /**
+             * getEffectScheduler: returns the attached scheduler, nullptr if there is none.
+             */
+            EffectScheduler* getEffectScheduler() const;
+
+            /**
+             * computeHash: computes the Zobrist hash of the game's state from scratch, in O(n).
+             *
+             * @return
+             *     the hash. always equal to getHash().
+             */
+            uint64_t computeHash() const;
+
+            /**
+             * getMemoryReport: reports the memory the game's state uses, by category (see MemoryTracker.h).
+             * the board's nodes, the journal and the temporaries are counted by the game's tracker as they are
+             * allocated. the units and the bitboards are summed from their capacities when the report is made.
+             * the Game object itself (sizeof(Game)) is not included.
+             *
+             * @return
+             *     the report. its units_count is the number of characters.
+             */
+            MemoryReport getMemoryReport() const;
+
+            /**
+             * getMemoryTracker: returns the tracker of the game, so callers can count their own per-game
+             *                   containers with it through a TrackingAllocator.
+             */
+            MemoryTracker& getMemoryTracker() const;
+
 
             /**
              * operator<< overloading: prints the game to an output stream.
@@ -177,6 +596,8 @@ namespace mtm
              */
             friend std::ostream& operator<<(std::ostream& os, const Game& game);
 
+            friend class GameDiff;
+
             /**
              * makeCharacter: a static function that creates a new character.
              *
@@ -196,14 +617,66 @@ namespace mtm
             static std::shared_ptr<Character> makeCharacter(CharacterType type, Team team, units_t health,
                                                             units_t ammo, units_t range, units_t power);
 
+            /**
+             * makeCharacter: a static function that creates a new character of a type defined in a registry.
+             *
+             * @param registry - the registry that defines the type. must outlive the character.
+             * @param type     - the id of the type in the registry.
+             * @param team, health, ammo, range, power - as described above.
+             * 
+             * @throw
+             *     IllegalArgument - if the type is not defined in the registry, or one of the values is incorrect.
+             * 
+             * @return
+             *     a shared pointer to the newborn character.
+             */
+            static std::shared_ptr<Character> makeCharacter(const UnitTypeRegistry& registry, UnitTypeId type,
+                                                            Team team, units_t health,
+                                                            units_t ammo, units_t range, units_t power);
+
         /** NOTE: private functions do not throw exceptions. */
         private:
             /**
-             * copyBoard: copies another board's data.
+             * makeCharacter: creates a new character, allocated with its control block by an allocator.
+             *
+             * @throw
+             *     IllegalArgument - if one of the values is incorrect (see the public makeCharacter).
+             */
+            static std::shared_ptr<Character> makeCharacter(CharacterType type, Team team, units_t health,
+                                                            units_t ammo, units_t range, units_t power,
+                                                            const TrackingAllocator<Character>& allocator);
+
+            /**
+             * hasValidStats: checks if a unit's type and stats are accepted by makeCharacter.
+             *
+             * @param unit - a reference to the unit descriptor.
+             */
+            static bool hasValidStats(const UnitDescriptor& unit);
+
+            /**
+             * findInvalidUnit: finds the first unit whose stats are incorrect or which is not within the board's range.
+             *
+             * @param begin - a pointer to the first unit descriptor.
+             * @param end   - a pointer past the last unit descriptor.
+             * 
+             * @return
+             *      the index of the first invalid unit, or end - begin if all the units are valid.
+             */
+            size_t findInvalidUnit(const UnitDescriptor* begin, const UnitDescriptor* end) const;
+
+            /**
+             * findOccupiedUnit: finds the first unit which lands on an occupied cell or on a cell of a previous unit.
              *
-             * @param other - a reference to the board we want to copy.
+             * @param begin - a pointer to the first unit descriptor. all the units must be within the board's range.
+             * @param end   - a pointer past the last unit descriptor.
+             * @param order - the result keeper: the indices of the units, sorted by their coordinates.
+             *                left empty if the units are already sorted.
+             * 
+             * @return
+             *      the index of the first such unit, or end - begin if there is none.
              */
-            void copyBoard(const BOARD_MAP& other);
+            size_t findOccupiedUnit(const UnitDescriptor* begin, const UnitDescriptor* end,
+                                    std::vector<size_t, TrackingAllocator<size_t>>& order) const;
 
             /**
              * isCellEmpty: checks if a cell empty.
@@ -212,8 +685,10 @@ namespace mtm
              * 
              * @return
              *      true if the cell is not exists in the board, false otherwise.
+             * 
+             * NOTE: the check is a single bit test in the occupancy bitboard.
              */
-            bool isCellEmpty(const GridPoint& coordinates);
+            bool isCellEmpty(const GridPoint& coordinates) const;
 
             /**
              * isOutOfBound: checks if a cell is within the board's range.
@@ -224,23 +699,99 @@ namespace mtm
              *      true if the cell's x and y coordinates are greater than 0
              *      and lesser than the board's width and height (respectively), false otherwise.
              */
-            bool isOutOfBound(const GridPoint& coordinates);
+            bool isOutOfBound(const GridPoint& coordinates) const;
 
             /**
-             * attackNearbyCharacters: make a soldier character attack all nearby coordinates of a requested attack.
-             * if an attacked characters is not alive anymore - remove it from the board.
+             * attackNearbyCharacters: make a character with a splash attack all nearby coordinates of a requested attack.
+             * the attacked characters that are not alive anymore are added to the outcome, to be removed on commit.
+             * only the enemy cells of the splash diamond are visited, using the enemy team's bitboard.
              *
-             * @param soldier         - a reference to the attacking character. must be an instance of a soldier.
+             * @param soldier         - a reference to the attacking character. its splash radius must be positive.
              * @param dst_coordinates - a reference to the attacked cell coordinates.
+             * @param outcome         - the outcome of the attack.
+             */
+            void attackNearbyCharacters(const Character& soldier, const GridPoint& dst_coordinates,
+                                        AttackOutcome& outcome) const;
+
+            /**
+             * kill: reduces the crossfitters_count or powerlifters_count when a character is killed,
+             *       and cancels its timed effects. called before the character is removed from the units.
+             *
+             * @param unit - the handle of the killed character.
+             */
+            void kill(UnitHandle unit);
+
+            /**
+             * teamMask: returns the bitboard of a team's characters.
+             *
+             * @param team - the requested team.
+             */
+            Bitboard& teamMask(Team team);
+            const Bitboard& teamMask(Team team) const;
+
+            /**
+             * markCell: marks a cell as occupied by a character of the given team in the bitboards.
+             *
+             * @param coordinates - a reference to a valid cell coordinates (within the board's range).
+             * @param team        - the team of the character in the cell.
+             */
+            void markCell(const GridPoint& coordinates, Team team);
+
+            /**
+             * unmarkCell: marks a cell as empty in all of the bitboards.
+             *
+             * @param coordinates - a reference to a valid cell coordinates (within the board's range).
+             */
+            void unmarkCell(const GridPoint& coordinates);
+
+            /**
+             * recordChange: adds a cell whose contents changed to the journal.
+             * a journal longer than twice the number of characters is reset, since diffing it would cost more
+             * than walking the boards.
+             *
+             * @param coordinates - a reference to a valid cell coordinates (within the board's range).
+             */
+            void recordChange(const GridPoint& coordinates);
+
+            /**
+             * resetJournal: empties the journal and gives it a new id, so games diffed against its old content
+             *               fall back to walking the boards.
+             */
+            void resetJournal();
+
+            /**
+             * detachUnit: removes the character of an occupied cell from the board, keeping it in the units table.
+             *
+             * @param coordinates - a reference to a valid occupied cell coordinates.
+             *
+             * @return
+             *      the handle of the character.
+             */
+            UnitHandle detachUnit(const GridPoint& coordinates);
+
+            /**
+             * attachUnit: puts a detached character in an empty cell, reporting it as moved from its old cell.
+             *
+             * @param src_coordinates - a reference to the cell the character was detached from.
+             * @param dst_coordinates - a reference to a valid empty cell coordinates.
+             * @param unit            - the handle of the detached character.
+             */
+            void attachUnit(const GridPoint& src_coordinates, const GridPoint& dst_coordinates, UnitHandle unit);
+
+            /**
+             * removeUnit: removes the character of an occupied cell from the game, as if it was killed.
+             *
+             * @param coordinates - a reference to a valid occupied cell coordinates.
              */
-            void attackNearbyCharacters(const Character& soldier, const GridPoint& dst_coordinates);
+            void removeUnit(const GridPoint& coordinates);
 
             /**
-             * kill: reduces the crossfitters_count or powerlifters_count when a character is killed.
+             * restoreUnit: overwrites the changing stats of the character of an occupied cell.
              *
-             * @param character - a reference to the killed character.
+             * @param coordinates - a reference to a valid occupied cell coordinates.
+             * @param health, ammo, counter - the new stats (see Character::restore and Character::setAttackCounter).
              */
-            void kill(const Character& character);
+            void restoreUnit(const GridPoint& coordinates, units_t health, units_t ammo, int counter);
     };
 }
 
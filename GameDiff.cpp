@@ -0,0 +1,440 @@
+#include "GameDiff.h"
+
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+namespace mtm {
+
+    const uint8_t GameDiff::MAGIC[4] = {'M', 'T', 'M', 'P'};
+
+    static void writeVarint(uint64_t value, std::vector<uint8_t>& output)
+    {
+        while (value >= 0x80) {
+            output.push_back(uint8_t(value | 0x80));
+            value >>= 7;
+        }
+        output.push_back(uint8_t(value));
+    }
+
+    static void writeSigned(int64_t value, std::vector<uint8_t>& output)
+    {
+        writeVarint((uint64_t(value) << 1) ^ uint64_t(value >> 63), output);
+    }
+
+    static void writePoint(const GridPoint& coordinates, std::vector<uint8_t>& output)
+    {
+        writeVarint(uint64_t(coordinates.row), output);
+        writeVarint(uint64_t(coordinates.col), output);
+    }
+
+    static uint64_t readVarint(const uint8_t*& cursor, const uint8_t* end)
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (cursor == end) {
+                throw IllegalArgument();
+            }
+            uint8_t byte = *cursor++;
+            value |= uint64_t(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw IllegalArgument();
+    }
+
+    static int readInt(const uint8_t*& cursor, const uint8_t* end)
+    {
+        uint64_t value = readVarint(cursor, end);
+        if (value > uint64_t(INT32_MAX)) {
+            throw IllegalArgument();
+        }
+        return int(value);
+    }
+
+    static int readSigned(const uint8_t*& cursor, const uint8_t* end)
+    {
+        uint64_t value = readVarint(cursor, end);
+        int64_t decoded = int64_t(value >> 1) ^ -int64_t(value & 1);
+        if (decoded < INT32_MIN || decoded > INT32_MAX) {
+            throw IllegalArgument();
+        }
+        return int(decoded);
+    }
+
+    static GridPoint readPoint(const uint8_t*& cursor, const uint8_t* end)
+    {
+        int row = readInt(cursor, end);
+        return GridPoint(row, readInt(cursor, end));
+    }
+
+    static uint64_t getHandleKey(UnitHandle unit)
+    {
+        return (uint64_t(unit.index) << 32) | uint64_t(unit.generation);
+    }
+
+    GameDiff::UnitRecord::UnitRecord(const GridPoint& coordinates, const Character& character) :
+        coordinates(coordinates),
+        type(character.getTypeId()),
+        team(character.getTeam()),
+        health(character.getHealth()),
+        ammo(character.getAmmo()),
+        range(character.getAttackRange()),
+        power(character.getPower()),
+        counter(character.getAttackCounter())
+    {}
+
+    GameDiff::UnitRecord::UnitRecord(const GridPoint& coordinates, UnitTypeId type, Team team,
+                                     units_t health, units_t ammo, units_t range, units_t power, int counter) :
+        coordinates(coordinates),
+        type(type),
+        team(team),
+        health(health),
+        ammo(ammo),
+        range(range),
+        power(power),
+        counter(counter)
+    {}
+
+    void GameDiff::diff(const Game& from, const Game& to, std::vector<uint8_t>& patch)
+    {
+        if (from.height != to.height || from.width != to.width) {
+            throw IllegalArgument();
+        }
+
+        Changes changes;
+        std::vector<UnitHandle> removed_units;
+        std::vector<UnitHandle> added_units;
+
+        if (sharesHistory(from, to)) {
+            std::vector<GridPoint> cells;
+            collectJournalCells(from, to, cells);
+            for (const GridPoint& coordinates : cells) {
+                compareCells(coordinates, from, from.getHandle(coordinates), to, to.getHandle(coordinates),
+                             changes, removed_units, added_units);
+            }
+        }
+        else {
+            // merge walk: both boards are ordered by ComparePoints, so every cell is visited once.
+            ComparePoints compare;
+            BOARD_MAP::const_iterator from_tile = from.board.begin();
+            BOARD_MAP::const_iterator to_tile = to.board.begin();
+            while (from_tile != from.board.end() || to_tile != to.board.end()) {
+                bool is_from_first = to_tile == to.board.end() ||
+                                     (from_tile != from.board.end() && compare((*from_tile).first, (*to_tile).first));
+                bool is_to_first = from_tile == from.board.end() ||
+                                   (to_tile != to.board.end() && compare((*to_tile).first, (*from_tile).first));
+
+                const GridPoint& coordinates = is_to_first ? (*to_tile).first : (*from_tile).first;
+                UnitHandle from_unit = is_to_first ? UnitHandle() : (*from_tile).second;
+                UnitHandle to_unit = is_from_first ? UnitHandle() : (*to_tile).second;
+                compareCells(coordinates, from, from_unit, to, to_unit, changes, removed_units, added_units);
+
+                if (!is_to_first) {
+                    ++from_tile;
+                }
+                if (!is_from_first) {
+                    ++to_tile;
+                }
+            }
+        }
+
+        pairMoves(from, to, changes, removed_units, added_units);
+
+        // an added character is rebuilt by its type alone, which only the built-in types are.
+        for (const UnitRecord& unit : changes.added) {
+            if (unit.type != SOLDIER && unit.type != MEDIC && unit.type != SNIPER) {
+                throw IllegalArgument();
+            }
+        }
+        write(to, changes, patch);
+    }
+
+    void GameDiff::apply(Game& game, const uint8_t* patch, size_t size)
+    {
+        if (patch == nullptr && size != 0) {
+            throw IllegalArgument();
+        }
+
+        int height = 0, width = 0;
+        uint64_t source_id = 0, source_position = 0;
+        Changes changes;
+        read(patch, size, height, width, source_id, source_position, changes);
+        if (height != game.height || width != game.width) {
+            throw IllegalArgument();
+        }
+
+        // the added characters are checked and created before the game changes, so an incorrect one leaves it as is.
+        std::vector<std::shared_ptr<Character>> added_characters;
+        for (const UnitRecord& unit : changes.added) {
+            if (game.isOutOfBound(unit.coordinates)) {
+                throw IllegalArgument();
+            }
+            added_characters.push_back(Game::makeCharacter(CharacterType(unit.type), unit.team, unit.health,
+                                                           unit.ammo, unit.range, unit.power));
+        }
+
+        for (const GridPoint& coordinates : changes.removed) {
+            if (game.isOutOfBound(coordinates) || game.isCellEmpty(coordinates)) {
+                throw IllegalArgument();
+            }
+            game.removeUnit(coordinates);
+        }
+
+        // every moving character is detached before any is attached, since a character may move
+        // to the cell another one leaves.
+        std::vector<UnitHandle> moving_units;
+        for (const MoveRecord& move : changes.moved) {
+            if (game.isOutOfBound(move.src) || game.isCellEmpty(move.src)) {
+                throw IllegalArgument();
+            }
+            moving_units.push_back(game.detachUnit(move.src));
+        }
+        for (size_t index = 0; index < changes.moved.size(); ++index) {
+            const MoveRecord& move = changes.moved[index];
+            if (game.isOutOfBound(move.dst) || !game.isCellEmpty(move.dst)) {
+                throw IllegalArgument();
+            }
+            game.attachUnit(move.src, move.dst, moving_units[index]);
+        }
+
+        for (size_t index = 0; index < changes.added.size(); ++index) {
+            const UnitRecord& unit = changes.added[index];
+            if (!game.isCellEmpty(unit.coordinates)) {
+                throw IllegalArgument();
+            }
+            game.addCharacter(unit.coordinates, added_characters[index]);
+            if (unit.counter != 0) {
+                game.restoreUnit(unit.coordinates, unit.health, unit.ammo, unit.counter);
+            }
+        }
+
+        for (const UnitRecord& unit : changes.restored) {
+            if (game.isOutOfBound(unit.coordinates) || game.isCellEmpty(unit.coordinates)) {
+                throw IllegalArgument();
+            }
+            game.restoreUnit(unit.coordinates, unit.health, unit.ammo, unit.counter);
+        }
+
+        // the game now equals the source of the patch, so the next diff against the source can use its journal.
+        game.resetJournal();
+        game.base_journal_id = source_id;
+        game.base_position = size_t(source_position);
+    }
+
+    void GameDiff::apply(Game& game, const std::vector<uint8_t>& patch)
+    {
+        apply(game, patch.data(), patch.size());
+    }
+
+    bool GameDiff::sharesHistory(const Game& from, const Game& to)
+    {
+        return (from.journal_id == to.journal_id) ||
+               (to.base_journal_id == from.journal_id && to.base_position <= from.journal.size()) ||
+               (from.base_journal_id == to.journal_id && from.base_position <= to.journal.size());
+    }
+
+    void GameDiff::collectJournalCells(const Game& from, const Game& to, std::vector<GridPoint>& cells)
+    {
+        if (from.journal_id == to.journal_id) {
+            return; // the same game.
+        }
+
+        const Game& origin = to.base_journal_id == from.journal_id ? from : to;
+        const Game& copy = to.base_journal_id == from.journal_id ? to : from;
+        cells.assign(origin.journal.begin() + std::ptrdiff_t(copy.base_position), origin.journal.end());
+        cells.insert(cells.end(), copy.journal.begin(), copy.journal.end());
+
+        ComparePoints compare;
+        std::sort(cells.begin(), cells.end(), compare);
+        cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+    }
+
+    void GameDiff::compareCells(const GridPoint& coordinates, const Game& from, UnitHandle from_unit,
+                                const Game& to, UnitHandle to_unit, Changes& changes,
+                                std::vector<UnitHandle>& removed_units, std::vector<UnitHandle>& added_units)
+    {
+        const Character* from_character = from_unit.isNull() ? nullptr : &from.units[from_unit];
+        const Character* to_character = to_unit.isNull() ? nullptr : &to.units[to_unit];
+
+        if (from_character != nullptr && to_character != nullptr && from_unit == to_unit &&
+            isSameCharacter(*from_character, *to_character)) {
+            UnitRecord from_record(coordinates, *from_character);
+            UnitRecord to_record(coordinates, *to_character);
+            if (from_record.health != to_record.health || from_record.ammo != to_record.ammo ||
+                from_record.counter != to_record.counter) {
+                changes.restored.push_back(to_record);
+            }
+            return;
+        }
+
+        if (from_character != nullptr) {
+            changes.removed.push_back(coordinates);
+            removed_units.push_back(from_unit);
+        }
+        if (to_character != nullptr) {
+            changes.added.push_back(UnitRecord(coordinates, *to_character));
+            added_units.push_back(to_unit);
+        }
+    }
+
+    void GameDiff::pairMoves(const Game& from, const Game& to, Changes& changes,
+                             const std::vector<UnitHandle>& removed_units,
+                             const std::vector<UnitHandle>& added_units)
+    {
+        if (removed_units.empty() || added_units.empty()) {
+            return;
+        }
+
+        std::unordered_map<uint64_t, size_t> removed_indices;
+        for (size_t index = 0; index < removed_units.size(); ++index) {
+            removed_indices.emplace(getHandleKey(removed_units[index]), index);
+        }
+
+        // a handle may be reused by unrelated characters of the two games, so only equal characters are paired.
+        std::vector<bool> is_moved(removed_units.size(), false);
+        std::vector<UnitRecord> added;
+        for (size_t index = 0; index < added_units.size(); ++index) {
+            std::unordered_map<uint64_t, size_t>::const_iterator removed =
+                removed_indices.find(getHandleKey(added_units[index]));
+            const UnitRecord& unit = changes.added[index];
+            if (removed == removed_indices.end() ||
+                !isSameCharacter(from.units[removed_units[(*removed).second]], to.units[added_units[index]])) {
+                added.push_back(unit);
+                continue;
+            }
+
+            const GridPoint& src = changes.removed[(*removed).second];
+            UnitRecord old_unit(src, from.units[removed_units[(*removed).second]]);
+            is_moved[(*removed).second] = true;
+            changes.moved.push_back(MoveRecord{src, unit.coordinates});
+            if (old_unit.health != unit.health || old_unit.ammo != unit.ammo || old_unit.counter != unit.counter) {
+                changes.restored.push_back(unit);
+            }
+        }
+
+        std::vector<GridPoint> removed;
+        for (size_t index = 0; index < changes.removed.size(); ++index) {
+            if (!is_moved[index]) {
+                removed.push_back(changes.removed[index]);
+            }
+        }
+        changes.removed.swap(removed);
+        changes.added.swap(added);
+    }
+
+    void GameDiff::write(const Game& to, const Changes& changes, std::vector<uint8_t>& patch)
+    {
+        patch.assign(MAGIC, MAGIC + sizeof(MAGIC));
+        writeVarint(uint64_t(to.height), patch);
+        writeVarint(uint64_t(to.width), patch);
+        for (int i = 0; i < 8; ++i) {
+            patch.push_back(uint8_t(to.journal_id >> (8 * i)));
+        }
+        writeVarint(uint64_t(to.journal.size()), patch);
+
+        writeVarint(changes.removed.size(), patch);
+        writeVarint(changes.moved.size(), patch);
+        writeVarint(changes.added.size(), patch);
+        writeVarint(changes.restored.size(), patch);
+
+        for (const GridPoint& coordinates : changes.removed) {
+            writePoint(coordinates, patch);
+        }
+        for (const MoveRecord& move : changes.moved) {
+            writePoint(move.src, patch);
+            writePoint(move.dst, patch);
+        }
+        for (const UnitRecord& unit : changes.added) {
+            writePoint(unit.coordinates, patch);
+            patch.push_back(uint8_t(unit.type));
+            patch.push_back(uint8_t(unit.team));
+            writeSigned(unit.health, patch);
+            writeSigned(unit.ammo, patch);
+            writeSigned(unit.range, patch);
+            writeSigned(unit.power, patch);
+            writeSigned(unit.counter, patch);
+        }
+        for (const UnitRecord& unit : changes.restored) {
+            writePoint(unit.coordinates, patch);
+            writeSigned(unit.health, patch);
+            writeSigned(unit.ammo, patch);
+            writeSigned(unit.counter, patch);
+        }
+    }
+
+    void GameDiff::read(const uint8_t* patch, size_t size, int& height, int& width, uint64_t& source_id,
+                        uint64_t& source_position, Changes& changes)
+    {
+        const uint8_t* cursor = patch;
+        const uint8_t* end = patch + size;
+        if (size < sizeof(MAGIC) + 8 || !std::equal(MAGIC, MAGIC + sizeof(MAGIC), cursor)) {
+            throw IllegalArgument();
+        }
+        cursor += sizeof(MAGIC);
+
+        height = readInt(cursor, end);
+        width = readInt(cursor, end);
+        if (end - cursor < 8) {
+            throw IllegalArgument();
+        }
+        source_id = 0;
+        for (int i = 0; i < 8; ++i) {
+            source_id |= uint64_t(*cursor++) << (8 * i);
+        }
+        source_position = readVarint(cursor, end);
+
+        // every record takes at least 2 bytes, so larger counts are malformed (and must not be allocated).
+        uint64_t counts[4];
+        for (uint64_t& count : counts) {
+            count = readVarint(cursor, end);
+            if (count > size) {
+                throw IllegalArgument();
+            }
+        }
+
+        for (uint64_t index = 0; index < counts[0]; ++index) {
+            changes.removed.push_back(readPoint(cursor, end));
+        }
+        for (uint64_t index = 0; index < counts[1]; ++index) {
+            GridPoint src = readPoint(cursor, end);
+            changes.moved.push_back(MoveRecord{src, readPoint(cursor, end)});
+        }
+        for (uint64_t index = 0; index < counts[2]; ++index) {
+            GridPoint coordinates = readPoint(cursor, end);
+            if (end - cursor < 2 || cursor[0] > SNIPER || cursor[1] > CROSSFITTERS) {
+                throw IllegalArgument();
+            }
+            UnitTypeId type = UnitTypeId(*cursor++);
+            Team team = Team(*cursor++);
+            units_t health = readSigned(cursor, end);
+            units_t ammo = readSigned(cursor, end);
+            units_t range = readSigned(cursor, end);
+            units_t power = readSigned(cursor, end);
+            int counter = readSigned(cursor, end);
+
+            changes.added.push_back(UnitRecord(coordinates, type, team, health, ammo, range, power, counter));
+        }
+        for (uint64_t index = 0; index < counts[3]; ++index) {
+            GridPoint coordinates = readPoint(cursor, end);
+            units_t health = readSigned(cursor, end);
+            units_t ammo = readSigned(cursor, end);
+            int counter = readSigned(cursor, end);
+            changes.restored.push_back(UnitRecord(coordinates, SOLDIER, POWERLIFTERS, health, ammo, 0, 0, counter));
+        }
+
+        if (cursor != end) {
+            throw IllegalArgument();
+        }
+    }
+
+    bool GameDiff::isSameCharacter(const Character& first, const Character& second)
+    {
+        return first.getType() == second.getType() && first.getTeam() == second.getTeam() &&
+               first.convertToChar() == second.convertToChar() &&
+               first.getAttackRange() == second.getAttackRange() && first.getPower() == second.getPower();
+    }
+}
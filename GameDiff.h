@@ -0,0 +1,146 @@
+#ifndef GAME_DIFF_H
+#define GAME_DIFF_H
+
+#include "Game.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * GameDiff - compact binary patches between two states of a game, for keeping mirrored games in sync.
+     *
+     * A patch turns one game ("from") into another ("to"): it removes, moves, adds and restores the stats of
+     * characters. When the games share history - one of them is a copy of the other (or was patched to equal it),
+     * and both changed since - only the cells in their journals are compared, so diffing costs O(k log k) for k
+     * changes. Otherwise, both boards are walked in their order, in O(n).
+     *
+     * A typical spectator loop keeps a mirror of the spectator's state:
+     *
+     *      Game mirror(game);
+     *      ...
+     *      GameDiff::diff(mirror, game, patch); // O(changes since the last frame)
+     *      GameDiff::apply(mirror, patch);      // the mirror equals the game again
+     *      send(patch);                         // the spectator applies it to its own copy
+     *
+     * Patch format - a "MTMP" magic, then unsigned LEB128 varints (zigzag encoded for stats):
+     *
+     *      height width <source journal id: 8 bytes> <source journal position>
+     *      <removed count> <moved count> <added count> <restored count>
+     *      removed:  row col
+     *      moved:    src_row src_col dst_row dst_col
+     *      added:    row col <type: 1 byte> <team: 1 byte> health ammo range power counter
+     *      restored: row col health ammo counter
+     *
+     * NOTE: an added character is written by its built-in type, and rebuilt as that type. a character of a type
+     *       a registry defines on top of a built-in one (see Character::getTypeId) can be moved and restored by a
+     *       patch, but not added, since it would lose its rules.
+     */
+    class GameDiff
+    {
+        static const uint8_t MAGIC[4];
+
+        /**
+         * UnitRecord - the stats of a character in a patch.
+         */
+        struct UnitRecord
+        {
+            GridPoint coordinates;
+            UnitTypeId type;
+            Team team;
+            units_t health, ammo, range, power;
+            int counter;
+
+            UnitRecord(const GridPoint& coordinates, const Character& character);
+            UnitRecord(const GridPoint& coordinates, UnitTypeId type, Team team,
+                       units_t health, units_t ammo, units_t range, units_t power, int counter);
+        };
+
+        /**
+         * MoveRecord - a character that moved between two cells.
+         */
+        struct MoveRecord
+        {
+            GridPoint src;
+            GridPoint dst;
+        };
+
+        /**
+         * Changes - the changes a patch is made of, in the order they are applied.
+         */
+        struct Changes
+        {
+            std::vector<GridPoint> removed;
+            std::vector<MoveRecord> moved;
+            std::vector<UnitRecord> added;
+            std::vector<UnitRecord> restored;
+        };
+
+        public:
+            /**
+             * diff: computes the patch that turns one game into another.
+             *
+             * @param from  - the game the patch is applied to.
+             * @param to    - the game the patch leads to.
+             * @param patch - the result keeper. its previous content is removed.
+             *
+             * @throw
+             *     IllegalArgument - if the games' boards have different dimensions, or the patch would have to add
+             *                       a character of a type that is not built-in.
+             */
+            static void diff(const Game& from, const Game& to, std::vector<uint8_t>& patch);
+
+            /**
+             * apply: applies a patch in place. the game's event sink receives the changes as the game's own events.
+             *
+             * @param game  - the game. must equal the "from" game of the patch.
+             * @param patch - a pointer to the patch.
+             * @param size  - the size of the patch in bytes.
+             *
+             * @throw
+             *     IllegalArgument - if the patch is malformed or one of its added characters is incorrect
+             *                       (the game is left unchanged), or if it does not match the game
+             *                       (the game is left partially patched).
+             */
+            static void apply(Game& game, const uint8_t* patch, size_t size);
+            static void apply(Game& game, const std::vector<uint8_t>& patch);
+
+            /**
+             * sharesHistory: checks if two games can be diffed through their journals, without walking the boards.
+             */
+            static bool sharesHistory(const Game& from, const Game& to);
+
+        private:
+            /**
+             * collectJournalCells: lists the cells that may differ between two games that share history, sorted.
+             */
+            static void collectJournalCells(const Game& from, const Game& to, std::vector<GridPoint>& cells);
+
+            /**
+             * compareCells: adds the changes of a single cell - a removed, added or restored character,
+             * or a removed character and an added one when the cell holds another character.
+             * removed characters are kept with their handles, to be paired with the added ones as moves.
+             */
+            static void compareCells(const GridPoint& coordinates, const Game& from, UnitHandle from_unit,
+                                     const Game& to, UnitHandle to_unit, Changes& changes,
+                                     std::vector<UnitHandle>& removed_units, std::vector<UnitHandle>& added_units);
+
+            /**
+             * pairMoves: turns every removed character whose handle was added elsewhere into a move.
+             */
+            static void pairMoves(const Game& from, const Game& to, Changes& changes,
+                                  const std::vector<UnitHandle>& removed_units,
+                                  const std::vector<UnitHandle>& added_units);
+
+            static void write(const Game& to, const Changes& changes, std::vector<uint8_t>& patch);
+
+            static void read(const uint8_t* patch, size_t size, int& height, int& width, uint64_t& source_id,
+                             uint64_t& source_position, Changes& changes);
+
+            static bool isSameCharacter(const Character& first, const Character& second);
+    };
+}
+
+#endif
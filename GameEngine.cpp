@@ -0,0 +1,62 @@
+#include "GameEngine.h"
+
+#include "Exceptions.h"
+
+namespace mtm {
+
+    UnitState::UnitState(const GridPoint& coordinates, char symbol, units_t health, units_t ammo, int counter) :
+        coordinates(coordinates),
+        symbol(symbol),
+        health(health),
+        ammo(ammo),
+        counter(counter)
+    {}
+
+    bool UnitState::operator==(const UnitState& other) const
+    {
+        return coordinates == other.coordinates && symbol == other.symbol && health == other.health &&
+               ammo == other.ammo && counter == other.counter;
+    }
+
+    bool UnitState::operator!=(const UnitState& other) const
+    {
+        return !(*this == other);
+    }
+
+    ReferenceEngine::ReferenceEngine() :
+        game()
+    {}
+
+    const char* ReferenceEngine::getName() const
+    {
+        return "reference";
+    }
+
+    void ReferenceEngine::load(int height, int width, const std::vector<UnitDescriptor>& units)
+    {
+        game.reset(new Game(height, width));
+        (*game).loadUnits(units.data(), units.data() + units.size());
+    }
+
+    CommandStatus ReferenceEngine::execute(const Command& command)
+    {
+        return executeCommand(*game, command);
+    }
+
+    void ReferenceEngine::getState(std::vector<UnitState>& state) const
+    {
+        state.clear();
+        (*game).forEachCharacter([&state](const GridPoint& coordinates, const Character& character) {
+            state.push_back(UnitState(coordinates, character.convertToChar(), character.getHealth(),
+                                      character.getAmmo(), character.getAttackCounter()));
+        });
+    }
+
+    const Game& ReferenceEngine::getGame() const
+    {
+        if (game == nullptr) {
+            throw IllegalArgument();
+        }
+        return *game;
+    }
+}
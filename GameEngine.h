@@ -0,0 +1,93 @@
+#ifndef GAME_ENGINE_H
+#define GAME_ENGINE_H
+
+#include "Game.h"
+#include "Command.h"
+
+#include <memory>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * UnitState - the observable state of a character, as engines are compared by (see DifferentialHarness.h).
+     * counter is the hits counter of the character's cadence, 0 if it has none.
+     */
+    struct UnitState
+    {
+        GridPoint coordinates;
+        char symbol;
+        units_t health;
+        units_t ammo;
+        int counter;
+
+        UnitState(const GridPoint& coordinates, char symbol, units_t health, units_t ammo, int counter);
+
+        bool operator==(const UnitState& other) const;
+        bool operator!=(const UnitState& other) const;
+    };
+
+    /**
+     * GameEngine - the interface of a backend that executes the game's commands, such as an optimized board
+     * representation, so it can be run in lockstep with Game and compared to it.
+     *
+     * An engine must reproduce Game's semantics exactly: the same state after every command, and the same
+     * status (the exception Game would throw) for every failing command.
+     */
+    class GameEngine
+    {
+        public:
+            virtual ~GameEngine() = default;
+
+            /**
+             * getName: the name the engine is reported by.
+             */
+            virtual const char* getName() const = 0;
+
+            /**
+             * load: resets the engine to a new board holding the given units.
+             *
+             * @param height, width - the dimensions of the board. must be positive.
+             * @param units         - valid units of the built-in types, in distinct cells within the board.
+             */
+            virtual void load(int height, int width, const std::vector<UnitDescriptor>& units) = 0;
+
+            /**
+             * execute: performs a command, as executeCommand does on a game.
+             *
+             * @return
+             *     SUCCESS, or the status matching the exception Game would throw.
+             */
+            virtual CommandStatus execute(const Command& command) = 0;
+
+            /**
+             * getState: lists the state of every character, in the board's order (row by row).
+             *
+             * @param state - the result keeper. its previous content is removed.
+             */
+            virtual void getState(std::vector<UnitState>& state) const = 0;
+    };
+
+    /**
+     * ReferenceEngine - the engine of Game itself, the reference every other engine is compared to.
+     */
+    class ReferenceEngine : public GameEngine
+    {
+        std::unique_ptr<Game> game;
+
+        public:
+            ReferenceEngine();
+
+            const char* getName() const override;
+            void load(int height, int width, const std::vector<UnitDescriptor>& units) override;
+            CommandStatus execute(const Command& command) override;
+            void getState(std::vector<UnitState>& state) const override;
+
+            /**
+             * getGame: returns the game of the engine. must be loaded first.
+             */
+            const Game& getGame() const;
+    };
+}
+
+#endif
@@ -0,0 +1,76 @@
+#include "GameEvent.h"
+
+#include "Exceptions.h"
+
+namespace mtm {
+
+    GameEvent::GameEvent() :
+        type(GAME_OVER_EVENT),
+        coordinates(0, 0),
+        source(0, 0),
+        team(POWERLIFTERS),
+        value(0)
+    {}
+
+    GameEvent::GameEvent(GameEventType type, const GridPoint& coordinates, const GridPoint& source,
+                         Team team, units_t value) :
+        type(type),
+        coordinates(coordinates),
+        source(source),
+        team(team),
+        value(value)
+    {}
+
+    GameEventRing::GameEventRing(size_t capacity) :
+        events(),
+        mask(0),
+        head(0),
+        tail(0),
+        lost(0)
+    {
+        if (capacity == 0) {
+            throw IllegalArgument();
+        }
+
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        events.resize(size);
+        mask = size - 1;
+    }
+
+    void GameEventRing::emit(const GameEvent& event)
+    {
+        if (head - tail == events.size()) {
+            ++tail;
+            ++lost;
+        }
+        events[size_t(head) & mask] = event;
+        ++head;
+    }
+
+    size_t GameEventRing::drain(GameEvent* output, size_t max_count)
+    {
+        size_t count = 0;
+        for (; tail != head && count < max_count; ++tail, ++count) {
+            output[count] = events[size_t(tail) & mask];
+        }
+        return count;
+    }
+
+    size_t GameEventRing::getSize() const
+    {
+        return size_t(head - tail);
+    }
+
+    size_t GameEventRing::getCapacity() const
+    {
+        return events.size();
+    }
+
+    uint64_t GameEventRing::getLostCount() const
+    {
+        return lost;
+    }
+}
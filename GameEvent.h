@@ -0,0 +1,150 @@
+#ifndef GAME_EVENT_H
+#define GAME_EVENT_H
+
+#include "Auxiliaries.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * GameEventType - the kinds of changes a game reports:
+     *      UNIT_ADDED_EVENT - a character was added.     value is its health.
+     *      MOVED_EVENT      - a character moved.         source is its old cell.
+     *      DAMAGED_EVENT    - a character lost health.   source is the attacker's cell (the attacked cell, for a
+     *                                                    splash hit), value is the damage.
+     *      HEALED_EVENT     - a character gained health. source is the medic's cell, value is the heal.
+     *      KILLED_EVENT     - a character died and was removed (reported after its DAMAGED_EVENT).
+     *      RELOADED_EVENT   - a character reloaded.      value is the ammo gained.
+     *      GAME_OVER_EVENT  - the last character of a team was killed. team is the winning team.
+     */
+    enum GameEventType
+    {
+        UNIT_ADDED_EVENT,
+        MOVED_EVENT,
+        DAMAGED_EVENT,
+        HEALED_EVENT,
+        KILLED_EVENT,
+        RELOADED_EVENT,
+        GAME_OVER_EVENT
+    };
+
+    /**
+     * GameEvent - a single change of a game.
+     *
+     * coordinates is the cell of the changed character (its new cell for a move), and team is its team.
+     * source and value are detailed per type above (source equals coordinates when unused, value is 0).
+     */
+    struct GameEvent
+    {
+        GameEventType type;
+        GridPoint coordinates;
+        GridPoint source;
+        Team team;
+        units_t value;
+
+        /**
+         * GameEvent constructor: creates a game over event of the cell (0, 0).
+         * exists so events can be stored in preallocated buffers.
+         */
+        GameEvent();
+
+        /**
+         * GameEvent constructor: creates a new event.
+         */
+        GameEvent(GameEventType type, const GridPoint& coordinates, const GridPoint& source, Team team, units_t value);
+    };
+
+    /**
+     * GameEventSink - the interface of an event subscriber of a game (see Game::setEventSink).
+     */
+    class GameEventSink
+    {
+        public:
+            virtual ~GameEventSink() = default;
+
+            /**
+             * emit: receives an event, right after the game changed.
+             * NOTE: the game must not be changed from this function.
+             */
+            virtual void emit(const GameEvent& event) = 0;
+    };
+
+    /**
+     * GameEventRing - a preallocated ring buffer of events, drained by its consumers in batches.
+     *
+     * Emitting never allocates. When the ring is full the oldest event is overwritten and counted as lost,
+     * so a slow consumer can tell it has to resynchronize from the board.
+     */
+    class GameEventRing : public GameEventSink
+    {
+        std::vector<GameEvent> events;
+        size_t mask;
+        uint64_t head; // the number of events emitted.
+        uint64_t tail; // the number of events drained or lost.
+        uint64_t lost;
+
+        public:
+            GameEventRing() = delete;
+
+            /**
+             * GameEventRing constructor: creates an empty ring.
+             *
+             * @param capacity - the number of events the ring holds. rounded up to a power of 2.
+             *
+             * @throw
+             *     IllegalArgument - if the capacity is 0.
+             */
+            explicit GameEventRing(size_t capacity);
+
+            void emit(const GameEvent& event) override;
+
+            /**
+             * drain: moves the oldest events out of the ring.
+             *
+             * @param output    - the output buffer.
+             * @param max_count - the number of events the buffer holds.
+             *
+             * @return
+             *     the number of events written.
+             */
+            size_t drain(GameEvent* output, size_t max_count);
+
+            /**
+             * drain: visits all the events of the ring from the oldest and removes them.
+             *
+             * @param visit - a function object, called as visit(const GameEvent&).
+             *
+             * @return
+             *     the number of events visited.
+             */
+            template <class Visitor>
+            size_t drain(Visitor visit)
+            {
+                size_t count = size_t(head - tail);
+                for (; tail != head; ++tail) {
+                    visit(events[size_t(tail) & mask]);
+                }
+                return count;
+            }
+
+            /**
+             * getSize: the number of events waiting in the ring.
+             */
+            size_t getSize() const;
+
+            /**
+             * getCapacity: the number of events the ring holds.
+             */
+            size_t getCapacity() const;
+
+            /**
+             * getLostCount: the number of events overwritten before they were drained.
+             */
+            uint64_t getLostCount() const;
+    };
+}
+
+#endif
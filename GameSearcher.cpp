@@ -0,0 +1,237 @@
+#include "GameSearcher.h"
+
+#include "Exceptions.h"
+#include "Zobrist.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace mtm {
+
+    SearchConfig::SearchConfig() :
+        depth(4),
+        mode(ALPHA_BETA_SEARCH),
+        max_branching(64),
+        threads(1)
+    {}
+
+    GameSearcher::GameSearcher(TranspositionTable& table, const SearchConfig& config) :
+        table(table),
+        config(config)
+    {
+        if (config.depth < 1 || config.depth > 64 || config.max_branching <= 0 || config.threads == 0) {
+            throw IllegalArgument();
+        }
+    }
+
+    Team GameSearcher::getOpponent(Team team)
+    {
+        return team == CROSSFITTERS ? POWERLIFTERS : CROSSFITTERS;
+    }
+
+    uint64_t GameSearcher::getKey(const Game& game, Team team, Team root_team) const
+    {
+        uint64_t key = game.getHash() ^ Zobrist::getTeamKey(team);
+        if (config.mode == EXPECTIMAX_SEARCH) {
+            // the value of an expectimax position depends on which team is the random one.
+            key ^= Zobrist::mix(Zobrist::getTeamKey(root_team));
+        }
+        return key;
+    }
+
+    int GameSearcher::evaluate(const Game& game, Team team)
+    {
+        long long own_count = 0, enemy_count = 0;
+        long long score = 0; // a sum of many characters may exceed int, so it is clamped only at the end.
+        game.forEachCharacter([&](const GridPoint&, const Character& character) {
+            long long value = UNIT_VALUE + std::min(character.getHealth(), WIN_SCORE / 1024);
+            if (character.getTeam() == team) {
+                score += value;
+                ++own_count;
+            }
+            else {
+                score -= value;
+                ++enemy_count;
+            }
+        });
+
+        if (own_count > 0 && enemy_count == 0) {
+            return WIN_SCORE;
+        }
+        if (own_count == 0 && enemy_count > 0) {
+            return -WIN_SCORE;
+        }
+        return int(std::max((long long)-WIN_SCORE + 1, std::min((long long)WIN_SCORE - 1, score)));
+    }
+
+    void GameSearcher::generateCommands(const Game& game, Team team, int max_branching,
+                                        std::vector<Command>& commands)
+    {
+        std::vector<Command> moves;
+        std::vector<Command> reloads;
+        commands.clear();
+
+        game.forEachCharacter([&](const GridPoint& src, const Character& character) {
+            if (character.getTeam() != team) {
+                return;
+            }
+
+            game.forEachCellInRange(src, character.getAttackRange(), [&](const GridPoint& dst) {
+                if (game.isLegalAttack(src, dst) && game.getCharacter(dst) != nullptr) {
+                    commands.push_back(Command(ATTACK_COMMAND, src, dst));
+                }
+            });
+
+            game.forEachCellInRange(src, character.getTravelDistance(), [&](const GridPoint& dst) {
+                if (game.isLegalMove(src, dst)) {
+                    moves.push_back(Command(MOVE_COMMAND, src, dst));
+                }
+            });
+
+            reloads.push_back(Command(RELOAD_COMMAND, src, src));
+        });
+
+        commands.insert(commands.end(), moves.begin(), moves.end());
+        commands.insert(commands.end(), reloads.begin(), reloads.end());
+        if (commands.size() > size_t(max_branching)) {
+            commands.resize(size_t(max_branching));
+        }
+    }
+
+    int GameSearcher::searchNode(const Game& game, Team team, int depth, int alpha, int beta,
+                                 SearchContext& context, int rotation, int* best_move)
+    {
+        ++context.nodes;
+        if (depth == 0 || game.isOver()) {
+            return evaluate(game, team);
+        }
+
+        uint64_t key = getKey(game, team, context.root_team);
+        int hint = -1;
+        TranspositionEntry entry;
+        if (table.probe(key, entry)) {
+            ++context.table_hits;
+            hint = entry.best_move;
+            bool is_usable = entry.depth >= depth && best_move == nullptr &&
+                             (entry.bound == EXACT_BOUND ||
+                             (entry.bound == LOWER_BOUND && entry.score >= beta) ||
+                             (entry.bound == UPPER_BOUND && entry.score <= alpha));
+            if (is_usable) {
+                return entry.score;
+            }
+        }
+
+        std::vector<Command> commands;
+        generateCommands(game, team, config.max_branching, commands);
+        if (commands.empty()) {
+            return evaluate(game, team);
+        }
+
+        // the order of the commands: the table's best command first, then the generation order, rotated.
+        std::vector<int> order(commands.size());
+        for (size_t index = 0; index < order.size(); ++index) {
+            order[index] = int((index + size_t(rotation)) % order.size());
+        }
+        if (hint >= 0 && hint < int(commands.size())) {
+            std::rotate(order.begin(), std::find(order.begin(), order.end(), hint), order.end());
+        }
+
+        bool is_chance = config.mode == EXPECTIMAX_SEARCH && team != context.root_team;
+        int original_alpha = alpha;
+        int best_score = -WIN_SCORE - 1;
+        int best_index = -1;
+        long long sum = 0;
+        int count = 0;
+        for (size_t position = 0; position < order.size(); ++position)
+        {
+            Game child(game);
+            if (executeCommand(child, commands[order[position]]) != SUCCESS) {
+                continue;
+            }
+
+            int score = is_chance ? -searchNode(child, getOpponent(team), depth - 1,
+                                                -WIN_SCORE - 1, WIN_SCORE + 1, context, 0, nullptr)
+                                  : -searchNode(child, getOpponent(team), depth - 1,
+                                                -beta, -alpha, context, 0, nullptr);
+            if (is_chance) {
+                sum += score;
+                ++count;
+                continue;
+            }
+            if (score > best_score) {
+                best_score = score;
+                best_index = order[position];
+            }
+            if (best_score > alpha) {
+                alpha = best_score;
+            }
+            if (alpha >= beta) {
+                break;
+            }
+        }
+
+        Bound bound = EXACT_BOUND;
+        if (is_chance) {
+            best_score = count > 0 ? int(sum / count) : evaluate(game, team);
+        }
+        else if (best_score <= original_alpha) {
+            bound = UPPER_BOUND;
+        }
+        else if (best_score >= beta) {
+            bound = LOWER_BOUND;
+        }
+
+        TranspositionEntry result = {best_score, depth, bound, best_index};
+        table.store(key, result);
+        if (best_move != nullptr) {
+            *best_move = best_index;
+        }
+        return best_score;
+    }
+
+    SearchResult GameSearcher::search(const Game& game, Team team)
+    {
+        SearchResult result;
+        result.found = false;
+        result.best_command = Command();
+        result.score = evaluate(game, team);
+        result.nodes = 0;
+        result.table_hits = 0;
+
+        std::vector<Command> commands;
+        generateCommands(game, team, config.max_branching, commands);
+        if (commands.empty()) {
+            return result;
+        }
+
+        std::vector<SearchContext> contexts(config.threads, SearchContext{team, 0, 0});
+        std::vector<int> best_moves(config.threads, -1);
+        std::vector<int> scores(config.threads, 0);
+        auto deepen = [&](unsigned int thread) {
+            for (int depth = 1; depth <= config.depth; ++depth) {
+                scores[thread] = searchNode(game, team, depth, -WIN_SCORE - 1, WIN_SCORE + 1,
+                                            contexts[thread], int(thread), &best_moves[thread]);
+            }
+        };
+
+        std::vector<std::thread> helpers;
+        for (unsigned int thread = 1; thread < config.threads; ++thread) {
+            helpers.emplace_back(deepen, thread);
+        }
+        deepen(0);
+        for (std::thread& helper : helpers) {
+            helper.join();
+        }
+
+        for (const SearchContext& context : contexts) {
+            result.nodes += context.nodes;
+            result.table_hits += context.table_hits;
+        }
+        if (best_moves[0] >= 0) {
+            result.found = true;
+            result.best_command = commands[best_moves[0]];
+            result.score = scores[0];
+        }
+        return result;
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef GAME_SEARCHER_H
+#define GAME_SEARCHER_H
+
+#include "Game.h"
+#include "Command.h"
+#include "TranspositionTable.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * SearchMode - how the searcher models the opponent.
+     *
+     * ALPHA_BETA_SEARCH - the opponent plays its best reply (minimax with alpha-beta pruning).
+     * EXPECTIMAX_SEARCH - the opponent plays a uniformly random reply (its nodes average their children).
+     */
+    enum SearchMode { ALPHA_BETA_SEARCH, EXPECTIMAX_SEARCH };
+
+    /**
+     * SearchConfig - the parameters of a search.
+     *
+     * depth is the number of plies (single commands, the teams alternating) to look ahead, in [1, 64].
+     * max_branching caps the number of commands tried in every position (attacks are tried first,
+     * then moves, then reloads). threads is the number of threads searching the same position.
+     */
+    struct SearchConfig
+    {
+        int depth;
+        SearchMode mode;
+        int max_branching;
+        unsigned int threads;
+
+        /**
+         * SearchConfig constructor: 4 plies of alpha-beta, up to 64 commands per position, a single thread.
+         */
+        SearchConfig();
+    };
+
+    /**
+     * SearchResult - the outcome of a search.
+     *
+     * found is false if the team had no command to play (best_command is left default).
+     * score is from the searching team's point of view.
+     */
+    struct SearchResult
+    {
+        bool found;
+        Command best_command;
+        int score;
+        uint64_t nodes;
+        uint64_t table_hits;
+    };
+
+    /**
+     * GameSearcher - a deterministic game-tree searcher for the bots.
+     *
+     * The searcher runs an iterative-deepening negamax over copies of the game, keyed in a transposition
+     * table by the game's Zobrist hash (see Game::getHash), so positions repeated in the tree or between
+     * searches are evaluated once.
+     * With more than one thread, the helper threads search the same position with a rotated root order and
+     * share their results only through the table ("lazy SMP"); the result is the main thread's.
+     * NOTE: a single-thread search is deterministic. a multi-thread search is only deterministic in its score
+     *       (within the table's size) and may pick another command of the same score.
+     */
+    class GameSearcher
+    {
+        static const int WIN_SCORE = 1000000;
+        static const int UNIT_VALUE = 32;
+
+        struct SearchContext
+        {
+            Team root_team;
+            uint64_t nodes;
+            uint64_t table_hits;
+        };
+
+        TranspositionTable& table;
+        SearchConfig config;
+
+        public:
+            GameSearcher() = delete;
+
+            /**
+             * GameSearcher constructor: creates a searcher.
+             *
+             * @param table  - the transposition table. may be shared by several searchers and kept between searches.
+             * @param config - the parameters of the searches.
+             *
+             * @throw
+             *     IllegalArgument - if the depth is not in [1, 64], or max_branching or threads is not positive.
+             */
+            GameSearcher(TranspositionTable& table, const SearchConfig& config);
+
+            /**
+             * search: finds the best command of a team.
+             *
+             * @param game - the position. the game is not changed.
+             * @param team - the team to play.
+             */
+            SearchResult search(const Game& game, Team team);
+
+            /**
+             * evaluate: the static score of a position from a team's point of view:
+             * every character is worth UNIT_VALUE and its health, and a won game is worth WIN_SCORE.
+             */
+            static int evaluate(const Game& game, Team team);
+
+            /**
+             * generateCommands: lists the legal commands of a team, attacks of non-empty cells first,
+             * then moves, then reloads.
+             *
+             * @param game          - the position.
+             * @param team          - the team to play.
+             * @param max_branching - the maximal number of commands to list.
+             * @param commands      - the result keeper. its previous content is removed.
+             */
+            static void generateCommands(const Game& game, Team team, int max_branching,
+                                         std::vector<Command>& commands);
+
+        private:
+            /**
+             * searchNode: the negamax search of a position, from the point of view of the team to play.
+             *
+             * @param rotation  - the rotation of the command order (used at the root of the helper threads).
+             * @param best_move - if not nullptr, the index of the best command is returned through it.
+             */
+            int searchNode(const Game& game, Team team, int depth, int alpha, int beta,
+                           SearchContext& context, int rotation, int* best_move);
+
+            uint64_t getKey(const Game& game, Team team, Team root_team) const;
+
+            static Team getOpponent(Team team);
+    };
+}
+
+#endif
@@ -0,0 +1,109 @@
+#include "GenericCharacter.h"
+
+namespace mtm {
+
+    GenericCharacter::GenericCharacter(const UnitRule& rule, Team team, units_t health, units_t ammo,
+                                       units_t range, units_t power) :
+        Character(team, health, ammo, range, power, rule.reload_value,
+                  rule.attack_cost, rule.movement, rule.kind, rule.symbol),
+        rule(&rule),
+        number_of_attacks(1)
+    {}
+
+    Character* GenericCharacter::clone()
+    {
+        return new GenericCharacter(*this);
+    }
+
+    std::shared_ptr<Character> GenericCharacter::cloneShared(const TrackingAllocator<Character>& allocator) const
+    {
+        return std::allocate_shared<GenericCharacter>(allocator, *this);
+    }
+
+    size_t GenericCharacter::getObjectSize() const
+    {
+        return sizeof(GenericCharacter);
+    }
+
+    const UnitRule& GenericCharacter::getRule() const
+    {
+        return *rule;
+    }
+
+    UnitTypeId GenericCharacter::getTypeId() const
+    {
+        return (*rule).id;
+    }
+
+    bool GenericCharacter::canAttackEmptyCell()
+    {
+        return (*rule).can_attack_empty;
+    }
+
+    bool GenericCharacter::isInAttackRange(const GridPoint& src, const GridPoint& dst)
+    {
+        return isInRuleRange(*rule, range, src, dst);
+    }
+
+    bool GenericCharacter::isInAttackRange2(const GridPoint& src, const GridPoint& dst)
+    {
+        return isInRuleLine(*rule, src, dst);
+    }
+
+    bool GenericCharacter::hasAmmoToAttack(const Character* other)
+    {
+        return hasRuleAmmo(*rule, ammo, other != nullptr, other != nullptr && team == (*other).getTeam());
+    }
+
+    bool GenericCharacter::isLegalTarget(const Character* other) const
+    {
+        return isRuleTarget(*rule, other != nullptr, other == this, other != nullptr && team == (*other).getTeam());
+    }
+
+    bool GenericCharacter::attack(Character* other)
+    {
+        bool exists = (other != nullptr);
+        if (!isLegalTarget(other)) {
+            return false;
+        }
+
+        bool same_team = exists && team == (*other).getTeam();
+        if (exists && !same_team) {
+            (*other).addHealth(-getRuleHitDamage(*rule, power, number_of_attacks));
+        }
+        else if (same_team && (*rule).ally_effect == ALLY_HEAL) {
+            (*other).addHealth(power);
+        }
+
+        if (getRuleSpendsAmmo(*rule, exists, same_team)) {
+            ammo -= attack_cost;
+        }
+        return true;
+    }
+
+    void GenericCharacter::attackNearbyCharacter(Character& other) const
+    {
+        if (team == other.getTeam()) {
+            return;
+        }
+
+        other.addHealth(-getRuleSplashDamage(*rule, power));
+    }
+
+    int GenericCharacter::getAttackCounter() const
+    {
+        return (*rule).cadence_period > 0 ? number_of_attacks : 0;
+    }
+
+    void GenericCharacter::setAttackCounter(int counter)
+    {
+        if ((*rule).cadence_period > 0) {
+            number_of_attacks = counter;
+        }
+    }
+
+    int GenericCharacter::getSplashRadius() const
+    {
+        return getRuleSplashRadius(*rule, range);
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef GENERIC_CHARACTER_H
+#define GENERIC_CHARACTER_H
+
+#include "Character.h"
+#include "UnitRule.h"
+
+namespace mtm {
+
+    /**
+     * GenericCharacter - a character whose rules come from a UnitRule record instead of its class.
+     *
+     * Every type defined in a UnitTypeRegistry is played by this class, through the rule kernel of UnitRule.h.
+     * The rule is not owned, so the registry that defined it must outlive the character.
+     */
+    class GenericCharacter : public Character
+    {
+        const UnitRule* rule;
+        int number_of_attacks;
+
+        public:
+            GenericCharacter() = delete;
+
+            /**
+            * GenericCharacter constructor: creates a new character of a registered type.
+            *
+            * @param rule   - a reference to the rule of the type.
+            * @param team   - the team of the character, crossfitters or powerlifters.
+            * @param health - the amount of health units.
+            * @param ammo   - the amount of ammo units.
+            * @param range  - the attacking range of the character.
+            * @param power  - the power of the character.
+            * 
+            * @return
+            *     a new character with the rule's kind, symbol, reload, attack_cost and max_movements_units.
+            */
+            GenericCharacter(const UnitRule& rule, Team team, units_t health, units_t ammo, units_t range, units_t power);
+
+            /**
+            * clone: create a clone of the current character
+            *
+            * @return
+            *     a pointer to the new created character, sharing the same rule.
+            */
+            Character* clone() override;
+
+            /**
+            * cloneShared: create a clone of the current character and its control block in a single allocation.
+            *
+            * @param allocator - the allocator of the clone.
+            *
+            * @return
+            *     a shared pointer to the new created character.
+            */
+            std::shared_ptr<Character> cloneShared(const TrackingAllocator<Character>& allocator) const override;
+
+            /**
+            * getObjectSize: the size of the current character's object.
+            * NOTE: overrides the "getObjectSize" method of class 'character'.
+            */
+            size_t getObjectSize() const override;
+
+            /**
+            * getRule: the rule of the character's type.
+            */
+            const UnitRule& getRule() const;
+
+            /**
+            * getTypeId: returns the rule's id, so the character's registry type is told apart from its kind.
+            * NOTE: overrides the "getTypeId" method of class 'character'.
+            */
+            UnitTypeId getTypeId() const override;
+
+            /** 
+            * attack: attacks (or heals) a character according to the rule's ally effect and cadence.
+            * NOTE: overrides the "attack" method of class 'character'.
+            */
+            bool attack(Character* other) override;
+
+            /** 
+            * canAttackEmptyCell: returns the rule's can_attack_empty.
+            */
+            bool canAttackEmptyCell() override;
+
+            /** 
+            * isInAttackRange: checks the attacked cell against the rule's range shape.
+            * NOTE: overrides the "isInAttackRange" method of class 'character'.
+            */
+            bool isInAttackRange(const GridPoint& src, const GridPoint& dst) override;
+
+            /** 
+            * isInAttackRange2: checks the attacked cell against the rule's line restriction.
+            * NOTE: overrides the "isInAttackRange2" method of class 'character'.
+            */
+            bool isInAttackRange2(const GridPoint& src, const GridPoint& dst) override;
+
+            /** 
+            * hasAmmoToAttack: checks the character's ammo according to the rule's ally effect.
+            * NOTE: overrides the "hasAmmoToAttack" method of class 'character'.
+            */
+            bool hasAmmoToAttack(const Character* other) override;
+
+            /** 
+            * isLegalTarget: checks the target according to the rule.
+            * NOTE: overrides the "isLegalTarget" method of class 'character'.
+            */
+            bool isLegalTarget(const Character* other) const override;
+
+            /** 
+            * attackNearbyCharacter: deals the rule's splash damage to an enemy near the attacked cell.
+            * NOTE: overrides the "attackNearbyCharacter" method of class 'character'.
+            */
+            void attackNearbyCharacter(Character& other) const override;
+
+            /** 
+            * getSplashRadius: returns the rule's splash radius for the character's range.
+            * NOTE: overrides the "getSplashRadius" method of class 'character'.
+            */
+            int getSplashRadius() const override;
+
+            /** 
+            * getAttackCounter: returns the cadence's hits counter, or 0 if the rule has no cadence.
+            * NOTE: overrides the "getAttackCounter" method of class 'character'.
+            */
+            int getAttackCounter() const override;
+
+            /** 
+            * setAttackCounter: overwrites the cadence's hits counter. does nothing if the rule has no cadence.
+            * NOTE: overrides the "setAttackCounter" method of class 'character'.
+            */
+            void setAttackCounter(int counter) override;
+    };
+}
+
+#endif
@@ -0,0 +1,72 @@
+#include "LoadTest.h"
+
+#include "ActionSampler.h"
+#include "Command.h"
+
+#include <chrono>
+
+namespace mtm {
+
+    typedef std::chrono::steady_clock LoadClock;
+
+    double LoadTestResult::getActionsPerSecond() const
+    {
+        return run_seconds > 0 ? double(actions) / run_seconds : 0;
+    }
+
+    LoadTestResult LoadTest::run(const ScenarioConfig& config, uint64_t actions)
+    {
+        LoadTestResult result;
+        result.height = config.height;
+        result.width = config.width;
+
+        LoadClock::time_point start = LoadClock::now();
+        std::vector<UnitDescriptor> units = ScenarioGenerator::generate(config);
+        Game game(config.height, config.width);
+        game.loadValidUnits(units.data(), units.data() + units.size());
+        result.load_seconds = std::chrono::duration<double>(LoadClock::now() - start).count();
+        result.units = units.size();
+
+        ActionSampler sampler(game, config.seed ^ 0x9E3779B97F4A7C15ULL);
+        Command command;
+        result.actions = 0;
+        result.applied = 0;
+
+        start = LoadClock::now();
+        for (; result.actions < actions && sampler.next(game, command); ++result.actions) {
+            CommandStatus status = executeCommand(game, command);
+            sampler.update(command, status);
+            result.applied += (status == SUCCESS);
+        }
+        result.run_seconds = std::chrono::duration<double>(LoadClock::now() - start).count();
+
+        return result;
+    }
+
+    std::vector<LoadTestResult> LoadTest::sweep(const std::vector<int>& board_sizes,
+                                                const std::vector<double>& densities,
+                                                uint64_t actions, uint64_t seed)
+    {
+        std::vector<LoadTestResult> results;
+        for (int size : board_sizes) {
+            for (double density : densities) {
+                ScenarioConfig config(size, size);
+                config.density = density;
+                config.seed = seed++;
+                results.push_back(run(config, actions));
+            }
+        }
+        return results;
+    }
+
+    std::ostream& LoadTest::printReport(std::ostream& os, const std::vector<LoadTestResult>& results)
+    {
+        os << "height,width,units,load_seconds,actions,applied,run_seconds,actions_per_second" << std::endl;
+        for (const LoadTestResult& result : results) {
+            os << result.height << ',' << result.width << ',' << result.units << ','
+               << result.load_seconds << ',' << result.actions << ',' << result.applied << ','
+               << result.run_seconds << ',' << result.getActionsPerSecond() << std::endl;
+        }
+        return os;
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef LOAD_TEST_H
+#define LOAD_TEST_H
+
+#include "ScenarioGenerator.h"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * LoadTestResult - the measurements of a single load test run.
+     *
+     * load_seconds is the time of generating and loading the scenario,
+     * run_seconds is the time of picking and executing the actions.
+     */
+    struct LoadTestResult
+    {
+        int height;
+        int width;
+        size_t units;
+        double load_seconds;
+        uint64_t actions;
+        uint64_t applied;
+        double run_seconds;
+
+        /**
+         * getActionsPerSecond: the throughput of the run.
+         */
+        double getActionsPerSecond() const;
+    };
+
+    /**
+     * LoadTest - a load-test driver running random legal actions against generated scenarios.
+     */
+    class LoadTest
+    {
+        public:
+            /**
+             * run: generates a scenario and runs random legal actions against it.
+             *
+             * @param config  - the parameters of the scenario.
+             * @param actions - the number of actions to run. the run stops early if no characters are left.
+             *
+             * @throw
+             *     IllegalArgument - if one of the scenario's parameters is incorrect.
+             */
+            static LoadTestResult run(const ScenarioConfig& config, uint64_t actions);
+
+            /**
+             * sweep: runs a load test for every combination of a (square) board size and a density,
+             * giving throughput curves versus the board size and the number of units.
+             *
+             * @param board_sizes - the side lengths of the boards.
+             * @param densities   - the densities of the scenarios.
+             * @param actions     - the number of actions of every run.
+             * @param seed        - the seed of the scenarios and the actions.
+             */
+            static std::vector<LoadTestResult> sweep(const std::vector<int>& board_sizes,
+                                                     const std::vector<double>& densities,
+                                                     uint64_t actions, uint64_t seed);
+
+            /**
+             * printReport: prints the results as CSV, one line per run.
+             */
+            static std::ostream& printReport(std::ostream& os, const std::vector<LoadTestResult>& results);
+    };
+}
+
+#endif
@@ -0,0 +1,203 @@
+#include "MatchHost.h"
+
+#include "Exceptions.h"
+
+namespace mtm {
+
+    void LocalTransport::send(CommandBatch batch)
+    {
+        batch.submitted = HostClock::now();
+        std::lock_guard<std::mutex> lock(mutex);
+        inbound.push_back(std::move(batch));
+    }
+
+    bool LocalTransport::receive(CommandBatch& batch)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (inbound.empty()) {
+            return false;
+        }
+        batch = std::move(inbound.front());
+        inbound.pop_front();
+        return true;
+    }
+
+    void LocalTransport::reply(BatchResult result)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        outbound.push_back(std::move(result));
+    }
+
+    bool LocalTransport::poll(BatchResult& result)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (outbound.empty()) {
+            return false;
+        }
+        result = std::move(outbound.front());
+        outbound.pop_front();
+        return true;
+    }
+
+    LatencyHistogram::LatencyHistogram() :
+        buckets(),
+        count(0)
+    {}
+
+    int LatencyHistogram::getBucket(uint64_t nanoseconds)
+    {
+        if (nanoseconds < uint64_t(LINEAR_LIMIT)) {
+            return int(nanoseconds);
+        }
+        int exponent = 63 - __builtin_clzll(nanoseconds);
+        int sub_bucket = int(nanoseconds >> (exponent - SUB_BUCKETS_BITS)) & (SUB_BUCKETS - 1);
+        return LINEAR_LIMIT + (exponent - SUB_BUCKETS_BITS - 1) * SUB_BUCKETS + sub_bucket;
+    }
+
+    uint64_t LatencyHistogram::getBucketUpperBound(int bucket)
+    {
+        if (bucket < LINEAR_LIMIT) {
+            return uint64_t(bucket);
+        }
+        int exponent = (bucket - LINEAR_LIMIT) / SUB_BUCKETS + SUB_BUCKETS_BITS + 1;
+        int sub_bucket = (bucket - LINEAR_LIMIT) % SUB_BUCKETS;
+        return ((uint64_t(SUB_BUCKETS + sub_bucket + 1)) << (exponent - SUB_BUCKETS_BITS)) - 1;
+    }
+
+    void LatencyHistogram::record(uint64_t nanoseconds)
+    {
+        ++buckets[getBucket(nanoseconds)];
+        ++count;
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram& other)
+    {
+        for (int i = 0; i < BUCKETS_COUNT; ++i) {
+            buckets[i] += other.buckets[i];
+        }
+        count += other.count;
+    }
+
+    uint64_t LatencyHistogram::getCount() const
+    {
+        return count;
+    }
+
+    uint64_t LatencyHistogram::getPercentile(double percentile) const
+    {
+        if (count == 0) {
+            return 0;
+        }
+
+        uint64_t rank = uint64_t(percentile / 100 * (count - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS_COUNT; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return getBucketUpperBound(i);
+            }
+        }
+        return getBucketUpperBound(BUCKETS_COUNT - 1);
+    }
+
+    MatchHost::Match::Match(const Game& game) :
+        game(game),
+        latency()
+    {}
+
+    MatchHost::MatchHost(LocalTransport& transport, unsigned int workers) :
+        transport(transport),
+        matches(),
+        pool(workers)
+    {}
+
+    unsigned int MatchHost::addMatch(const Game& initial_state)
+    {
+        matches.emplace_back(new Match(initial_state));
+        return (unsigned int)matches.size() - 1;
+    }
+
+    unsigned int MatchHost::getMatchesCount() const
+    {
+        return (unsigned int)matches.size();
+    }
+
+    const Game& MatchHost::getGame(unsigned int match_id) const
+    {
+        if (match_id >= matches.size()) {
+            throw IllegalArgument();
+        }
+        return matches[match_id]->game;
+    }
+
+    unsigned int MatchHost::pump()
+    {
+        unsigned int received = 0;
+        CommandBatch batch;
+        while (transport.receive(batch))
+        {
+            ++received;
+            if (batch.match_id >= matches.size()) {
+                BatchResult result;
+                result.match_id = batch.match_id;
+                result.statuses.assign(batch.commands.size(), ILLEGAL_ARGUMENT);
+                result.over = false;
+                result.winner = CROSSFITTERS;
+                transport.reply(std::move(result));
+                continue;
+            }
+
+            Match* match = matches[batch.match_id].get();
+            std::shared_ptr<CommandBatch> shared_batch = std::make_shared<CommandBatch>(std::move(batch));
+            pool.submit(shared_batch->match_id, [this, match, shared_batch]() { runBatch(*match, *shared_batch); });
+        }
+        return received;
+    }
+
+    void MatchHost::wait()
+    {
+        pool.wait();
+    }
+
+    void MatchHost::runBatch(Match& match, const CommandBatch& batch)
+    {
+        BatchResult result;
+        result.match_id = batch.match_id;
+        result.statuses.reserve(batch.commands.size());
+        for (const Command& command : batch.commands) {
+            result.statuses.push_back(executeCommand(match.game, command));
+        }
+        result.winner = CROSSFITTERS;
+        result.over = match.game.isOver(&result.winner);
+
+        std::chrono::nanoseconds elapsed = HostClock::now() - batch.submitted;
+        match.latency.record(uint64_t(elapsed.count()));
+        transport.reply(std::move(result));
+    }
+
+    LatencyReport MatchHost::makeReport(const LatencyHistogram& histogram)
+    {
+        LatencyReport report;
+        report.batches = histogram.getCount();
+        report.p50_microseconds = histogram.getPercentile(50) / 1000.0;
+        report.p99_microseconds = histogram.getPercentile(99) / 1000.0;
+        return report;
+    }
+
+    LatencyReport MatchHost::getLatencyReport(unsigned int match_id) const
+    {
+        if (match_id >= matches.size()) {
+            throw IllegalArgument();
+        }
+        return makeReport(matches[match_id]->latency);
+    }
+
+    LatencyReport MatchHost::getTotalLatencyReport() const
+    {
+        LatencyHistogram total;
+        for (const std::unique_ptr<Match>& match : matches) {
+            total.merge(match->latency);
+        }
+        return makeReport(total);
+    }
+}
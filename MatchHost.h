@@ -0,0 +1,247 @@
+#ifndef MATCH_HOST_H
+#define MATCH_HOST_H
+
+#include "Game.h"
+#include "Command.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mtm {
+
+    typedef std::chrono::steady_clock HostClock;
+
+    /**
+     * CommandBatch - a group of commands sent by a client to one match.
+     */
+    struct CommandBatch
+    {
+        unsigned int match_id;
+        std::vector<Command> commands;
+        HostClock::time_point submitted; // stamped by the transport when the batch is sent.
+    };
+
+    /**
+     * BatchResult - the reply of the host to a CommandBatch.
+     *
+     * statuses[i] is the result of commands[i] of the batch.
+     * winner is meaningful only if over is true.
+     */
+    struct BatchResult
+    {
+        unsigned int match_id;
+        std::vector<CommandStatus> statuses;
+        bool over;
+        Team winner;
+    };
+
+    /**
+     * LocalTransport - an in-process stand-in for the network between clients and a MatchHost.
+     *
+     * Clients send batches and poll results, the host receives batches and replies.
+     * Every method is thread safe.
+     */
+    class LocalTransport
+    {
+        std::mutex mutex;
+        std::deque<CommandBatch> inbound;
+        std::deque<BatchResult> outbound;
+
+        public:
+            /**
+             * send: (client side) sends a batch to the host, and stamps its submission time.
+             */
+            void send(CommandBatch batch);
+
+            /**
+             * receive: (host side) takes the oldest batch that was sent.
+             *
+             * @return
+             *     true if a batch was taken, false if there was none.
+             */
+            bool receive(CommandBatch& batch);
+
+            /**
+             * reply: (host side) sends a result back to the clients.
+             */
+            void reply(BatchResult result);
+
+            /**
+             * poll: (client side) takes the oldest result that was replied.
+             *
+             * @return
+             *     true if a result was taken, false if there was none.
+             */
+            bool poll(BatchResult& result);
+    };
+
+    /**
+     * LatencyHistogram - a fixed-size log-linear histogram of durations in nanoseconds.
+     *
+     * Every power of two is split into 8 buckets, so percentiles are reported with
+     * an error of at most 12.5%, using a constant amount of memory.
+     */
+    class LatencyHistogram
+    {
+        static const int SUB_BUCKETS_BITS = 3;
+        static const int SUB_BUCKETS = 1 << SUB_BUCKETS_BITS;
+        static const int LINEAR_LIMIT = 2 * SUB_BUCKETS;
+        static const int BUCKETS_COUNT = LINEAR_LIMIT + (64 - SUB_BUCKETS_BITS - 1) * SUB_BUCKETS;
+
+        uint64_t buckets[BUCKETS_COUNT];
+        uint64_t count;
+
+        public:
+            /**
+             * LatencyHistogram constructor: creates an empty histogram.
+             */
+            LatencyHistogram();
+
+            /**
+             * record: adds a sample to the histogram.
+             *
+             * @param nanoseconds - the duration of the sample.
+             */
+            void record(uint64_t nanoseconds);
+
+            /**
+             * merge: adds all the samples of another histogram to the current one.
+             */
+            void merge(const LatencyHistogram& other);
+
+            /**
+             * getCount: the number of recorded samples.
+             */
+            uint64_t getCount() const;
+
+            /**
+             * getPercentile: returns an upper bound of a percentile of the samples.
+             *
+             * @param percentile - the requested percentile, between 0 and 100.
+             *
+             * @return
+             *     the upper bound of the bucket holding the percentile, in nanoseconds. 0 if there are no samples.
+             */
+            uint64_t getPercentile(double percentile) const;
+
+        private:
+            static int getBucket(uint64_t nanoseconds);
+            static uint64_t getBucketUpperBound(int bucket);
+    };
+
+    /**
+     * LatencyReport - the p50/p99 latency of the batches of a match, from sending to replying.
+     */
+    struct LatencyReport
+    {
+        uint64_t batches;
+        double p50_microseconds;
+        double p99_microseconds;
+    };
+
+    /**
+     * MatchHost - owns many Game instances and runs the batches sent to them on a thread pool.
+     *
+     * Every match is owned by one worker (match_id modulo the number of workers),
+     * so the batches of a match run in the order they were sent and the games need no locking.
+     */
+    class MatchHost
+    {
+        struct Match
+        {
+            Game game;
+            LatencyHistogram latency;
+
+            explicit Match(const Game& game);
+        };
+
+        LocalTransport& transport;
+        std::vector<std::unique_ptr<Match>> matches;
+        ThreadPool pool;
+
+        public:
+            /**
+             * MatchHost constructor: creates a host with no matches.
+             *
+             * @param transport - the transport the host receives batches from and replies to.
+             * @param workers   - the number of worker threads. 0 means one per hardware thread.
+             */
+            MatchHost(LocalTransport& transport, unsigned int workers = 0);
+
+            MatchHost(const MatchHost& other) = delete;
+            MatchHost& operator=(const MatchHost& other) = delete;
+
+            /**
+             * addMatch: adds a new match to the host.
+             *
+             * @param initial_state - the game the match starts from. the host keeps its own copy.
+             *
+             * @return
+             *     the id of the new match, used by CommandBatch::match_id.
+             *
+             * NOTE: matches must not be added while batches are running.
+             */
+            unsigned int addMatch(const Game& initial_state);
+
+            /**
+             * getMatchesCount: the number of matches hosted.
+             */
+            unsigned int getMatchesCount() const;
+
+            /**
+             * getGame: returns the current state of a match.
+             *
+             * @throw
+             *     IllegalArgument - if there is no match with the given id.
+             *
+             * NOTE: the state may be read only while no batches are running (see wait).
+             */
+            const Game& getGame(unsigned int match_id) const;
+
+            /**
+             * pump: receives every batch waiting in the transport and dispatches it to the match's worker.
+             * batches of unknown matches are replied immediately with ILLEGAL_ARGUMENT statuses.
+             *
+             * @return
+             *     the number of batches received.
+             */
+            unsigned int pump();
+
+            /**
+             * wait: blocks until every dispatched batch has been run and replied.
+             */
+            void wait();
+
+            /**
+             * getLatencyReport: the latency of the batches of a match.
+             *
+             * @throw
+             *     IllegalArgument - if there is no match with the given id.
+             *
+             * NOTE: the report may be read only while no batches are running (see wait).
+             */
+            LatencyReport getLatencyReport(unsigned int match_id) const;
+
+            /**
+             * getTotalLatencyReport: the latency of the batches of all the matches together.
+             *
+             * NOTE: the report may be read only while no batches are running (see wait).
+             */
+            LatencyReport getTotalLatencyReport() const;
+
+        private:
+            /**
+             * runBatch: runs a batch on its match, records its latency and replies its result.
+             */
+            void runBatch(Match& match, const CommandBatch& batch);
+
+            static LatencyReport makeReport(const LatencyHistogram& histogram);
+    };
+}
+
+#endif
@@ -12,6 +12,16 @@ namespace mtm {
         return new Medic(*this);
     }
 
+    std::shared_ptr<Character> Medic::cloneShared(const TrackingAllocator<Character>& allocator) const
+    {
+        return std::allocate_shared<Medic>(allocator, *this);
+    }
+
+    size_t Medic::getObjectSize() const
+    {
+        return sizeof(Medic);
+    }
+
     bool Medic::canAttackEmptyCell()
     {
         return false;
@@ -22,27 +32,32 @@ namespace mtm {
         return (GridPoint::distance(src, dst) <= range);
     }
 
-    bool Medic::hasAmmoToAttack(const Character& other)
+    bool Medic::hasAmmoToAttack(const Character* other)
     {
-        if (Character::exists(other)) {
-            return (team == other.getTeam() || ammo >= attack_cost);
+        if (other != nullptr) {
+            return (team == (*other).getTeam() || ammo >= attack_cost);
         }
         else {
             return ammo > 0;
         }
     }
 
-    bool Medic::attack(Character& other)
+    bool Medic::isLegalTarget(const Character* other) const
+    {
+        return (other != nullptr && other != this);
+    }
+
+    bool Medic::attack(Character* other)
     {
-        if (!Character::exists(other) || this == &other)  {
+        if (!isLegalTarget(other))  {
             return false;
         }
 
-        if (team == other.getTeam())  {
-            other.addHealth(power);
+        if (team == (*other).getTeam())  {
+            (*other).addHealth(power);
         }
         else {
-            other.addHealth(-power);
+            (*other).addHealth(-power);
             --ammo; 
         }
         return true;
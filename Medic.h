@@ -7,12 +7,12 @@ namespace mtm {
 
     class Medic : public Character
     {
-        static const char MEDIC_SYMBOL = 'M';
-        static const units_t MEDIC_RELOAD_VALUE = 5;
-        static const units_t MEDIC_ATTACK_COST = 1; 
-        static const int MEDIC_MAX_MOVEMENT_UNITS = 5;
-
         public: 
+            static const char MEDIC_SYMBOL = 'M';
+            static const units_t MEDIC_RELOAD_VALUE = 5;
+            static const units_t MEDIC_ATTACK_COST = 1; 
+            static const int MEDIC_MAX_MOVEMENT_UNITS = 5;
+
             Medic() = delete;
 
             /**
@@ -38,6 +38,22 @@ namespace mtm {
             */
             Character* clone() override;
 
+            /**
+            * cloneShared: create a clone of the current medic and its control block in a single allocation.
+            *
+            * @param allocator - the allocator of the clone.
+            *
+            * @return
+            *     a shared pointer to the new created character.
+            */
+            std::shared_ptr<Character> cloneShared(const TrackingAllocator<Character>& allocator) const override;
+
+            /**
+            * getObjectSize: the size of the current medic's object.
+            * NOTE: overrides the "getObjectSize" method of class 'character'.
+            */
+            size_t getObjectSize() const override;
+
 
             /** 
             * attack: gets a reference to a slot on the board,
@@ -51,7 +67,7 @@ namespace mtm {
             *         false if trying to attack the current medic or an empty cell, 
             *         true if the attack was successful.
             */
-            bool attack(Character& other) override;
+            bool attack(Character* other) override;
             
             /** 
             * canAttackEmptyCell: medic can't attack an empty cell, therefore this method returns false.
@@ -74,7 +90,14 @@ namespace mtm {
             *
             * NOTE: overrides the "hasAmmoToAttack" method of class 'character'.
             */
-            bool hasAmmoToAttack(const Character& other) override;
+            bool hasAmmoToAttack(const Character* other) override;
+
+            /** 
+            * isLegalTarget: a medic can attack (or heal) any character but itself. an empty cell is not a legal target.
+            *
+            * NOTE: overrides the "isLegalTarget" method of class 'character'.
+            */
+            bool isLegalTarget(const Character* other) const override;
     };
 }
 
@@ -0,0 +1,86 @@
+#include "MemoryTracker.h"
+
+namespace mtm {
+
+    MemoryUsage::MemoryUsage() :
+        bytes(0),
+        peak_bytes(0),
+        allocations(0),
+        total_allocations(0)
+    {}
+
+    void MemoryUsage::add(const MemoryUsage& other)
+    {
+        bytes += other.bytes;
+        peak_bytes += other.peak_bytes;
+        allocations += other.allocations;
+        total_allocations += other.total_allocations;
+    }
+
+    MemoryReport::MemoryReport() :
+        categories(),
+        units_count(0)
+    {}
+
+    MemoryUsage MemoryReport::getTotal() const
+    {
+        MemoryUsage total;
+        for (const MemoryUsage& usage : categories) {
+            total.add(usage);
+        }
+        return total;
+    }
+
+    double MemoryReport::getBytesPerUnit() const
+    {
+        if (units_count == 0) {
+            return 0;
+        }
+        return double(getTotal().bytes - categories[TEMPORARY_MEMORY].bytes) / double(units_count);
+    }
+
+    MemoryTracker::MemoryTracker()
+    {
+        for (int category = 0; category < MEMORY_CATEGORIES_COUNT; ++category) {
+            bytes[category].store(0, std::memory_order_relaxed);
+            peak_bytes[category].store(0, std::memory_order_relaxed);
+            allocations[category].store(0, std::memory_order_relaxed);
+            total_allocations[category].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void MemoryTracker::recordAllocation(MemoryCategory category, size_t size)
+    {
+        size_t current = bytes[category].fetch_add(size, std::memory_order_relaxed) + size;
+        allocations[category].fetch_add(1, std::memory_order_relaxed);
+        total_allocations[category].fetch_add(1, std::memory_order_relaxed);
+
+        size_t peak = peak_bytes[category].load(std::memory_order_relaxed);
+        while (current > peak &&
+               !peak_bytes[category].compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+        }
+    }
+
+    void MemoryTracker::recordDeallocation(MemoryCategory category, size_t size)
+    {
+        bytes[category].fetch_sub(size, std::memory_order_relaxed);
+        allocations[category].fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    MemoryUsage MemoryTracker::getUsage(MemoryCategory category) const
+    {
+        MemoryUsage usage;
+        usage.bytes = bytes[category].load(std::memory_order_relaxed);
+        usage.peak_bytes = peak_bytes[category].load(std::memory_order_relaxed);
+        usage.allocations = allocations[category].load(std::memory_order_relaxed);
+        usage.total_allocations = total_allocations[category].load(std::memory_order_relaxed);
+        return usage;
+    }
+
+    void MemoryTracker::resetPeaks()
+    {
+        for (int category = 0; category < MEMORY_CATEGORIES_COUNT; ++category) {
+            peak_bytes[category].store(bytes[category].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,194 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace mtm {
+
+    /**
+     * MemoryCategory - the parts of a game its memory is reported by (see Game::getMemoryReport):
+     *      BOARD_MEMORY     - the nodes of the board's map.
+     *      UNITS_MEMORY     - the units table and the characters, with their shared_ptr control blocks.
+     *      INDEX_MEMORY     - the bitboards of the occupied cells and of the teams.
+     *      JOURNAL_MEMORY   - the journal of the changed cells (see GameDiff.h).
+     *      TEMPORARY_MEMORY - the buffers a single call allocates and frees (printing, bulk loading).
+     */
+    enum MemoryCategory
+    {
+        BOARD_MEMORY,
+        UNITS_MEMORY,
+        INDEX_MEMORY,
+        JOURNAL_MEMORY,
+        TEMPORARY_MEMORY,
+        MEMORY_CATEGORIES_COUNT
+    };
+
+    /**
+     * MemoryUsage - the memory of a single category.
+     *
+     * bytes             - the bytes allocated right now.
+     * peak_bytes        - the largest value bytes reached.
+     * allocations       - the allocations alive right now.
+     * total_allocations - the allocations made so far, freed ones included.
+     */
+    struct MemoryUsage
+    {
+        size_t bytes;
+        size_t peak_bytes;
+        size_t allocations;
+        uint64_t total_allocations;
+
+        /**
+         * MemoryUsage constructor: creates an empty usage.
+         */
+        MemoryUsage();
+
+        /**
+         * add: adds another usage to this one (the peaks are added too, so a sum of peaks is an upper bound).
+         */
+        void add(const MemoryUsage& other);
+    };
+
+    /**
+     * MemoryReport - the memory of a game, by category.
+     */
+    struct MemoryReport
+    {
+        MemoryUsage categories[MEMORY_CATEGORIES_COUNT];
+        size_t units_count;
+
+        /**
+         * MemoryReport constructor: creates an empty report.
+         */
+        MemoryReport();
+
+        /**
+         * getTotal: the sum of all the categories.
+         */
+        MemoryUsage getTotal() const;
+
+        /**
+         * getBytesPerUnit: the bytes of all the categories but TEMPORARY_MEMORY, divided by the number of units.
+         * 0 if there are no units.
+         */
+        double getBytesPerUnit() const;
+    };
+
+    /**
+     * MemoryTracker - counts the allocations of a TrackingAllocator, by category.
+     *
+     * The counters are atomic, so containers of many threads may share a tracker.
+     * Only the bytes requested from the allocator are counted, not the heap's own overhead.
+     */
+    class MemoryTracker
+    {
+        std::atomic<size_t> bytes[MEMORY_CATEGORIES_COUNT];
+        std::atomic<size_t> peak_bytes[MEMORY_CATEGORIES_COUNT];
+        std::atomic<size_t> allocations[MEMORY_CATEGORIES_COUNT];
+        std::atomic<uint64_t> total_allocations[MEMORY_CATEGORIES_COUNT];
+
+        public:
+            /**
+             * MemoryTracker constructor: creates a tracker with no allocations.
+             */
+            MemoryTracker();
+
+            MemoryTracker(const MemoryTracker& other) = delete;
+            MemoryTracker& operator=(const MemoryTracker& other) = delete;
+
+            /**
+             * recordAllocation: counts an allocation of a category.
+             */
+            void recordAllocation(MemoryCategory category, size_t size);
+
+            /**
+             * recordDeallocation: counts the release of an allocation of a category.
+             */
+            void recordDeallocation(MemoryCategory category, size_t size);
+
+            /**
+             * getUsage: returns the memory of a category.
+             */
+            MemoryUsage getUsage(MemoryCategory category) const;
+
+            /**
+             * resetPeaks: sets the peak of every category to its current bytes.
+             */
+            void resetPeaks();
+    };
+
+    /**
+     * TrackingAllocator - a standard allocator that counts its allocations in a tracker, under a category.
+     *
+     * It allocates from the global operator new, and may be plugged into any standard container.
+     * A null tracker counts nothing. Allocators compare equal if they count in the same tracker and category.
+     * Containers keep their own allocator when they are copy-assigned, so copying a container never moves
+     * its allocations to another tracker.
+     */
+    template <class T>
+    class TrackingAllocator
+    {
+        template <class U> friend class TrackingAllocator;
+
+        MemoryTracker* tracker;
+        MemoryCategory category;
+
+        public:
+            typedef T value_type;
+
+            TrackingAllocator(MemoryTracker* tracker, MemoryCategory category) :
+                tracker(tracker),
+                category(category)
+            {}
+
+            template <class U>
+            TrackingAllocator(const TrackingAllocator<U>& other) :
+                tracker(other.tracker),
+                category(other.category)
+            {}
+
+            T* allocate(size_t count)
+            {
+                T* result = static_cast<T*>(::operator new(count * sizeof(T)));
+                if (tracker != nullptr) {
+                    (*tracker).recordAllocation(category, count * sizeof(T));
+                }
+                return result;
+            }
+
+            void deallocate(T* pointer, size_t count)
+            {
+                if (tracker != nullptr) {
+                    (*tracker).recordDeallocation(category, count * sizeof(T));
+                }
+                ::operator delete(pointer);
+            }
+
+            MemoryTracker* getTracker() const
+            {
+                return tracker;
+            }
+
+            MemoryCategory getCategory() const
+            {
+                return category;
+            }
+
+            template <class U>
+            bool operator==(const TrackingAllocator<U>& other) const
+            {
+                return tracker == other.tracker && category == other.category;
+            }
+
+            template <class U>
+            bool operator!=(const TrackingAllocator<U>& other) const
+            {
+                return !(*this == other);
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,103 @@
+#include "Policy.h"
+
+#include "GameSearcher.h"
+
+namespace mtm {
+
+    uint64_t Policy::getUnitKey(UnitHandle unit)
+    {
+        return (uint64_t(unit.index) << 32) | uint64_t(unit.generation);
+    }
+
+    uint64_t Policy::getTeamKey(Team team)
+    {
+        // the generation of a valid handle is never 0, so this key never equals a character's key.
+        return uint64_t(team == CROSSFITTERS ? 1 : 2) << 32;
+    }
+
+    void Policy::listCommands(const Game& game, const GridPoint& src, std::vector<Command>& commands)
+    {
+        const Character& character = *game.getCharacter(src);
+
+        game.forEachCellInRange(src, character.getAttackRange(), [&](const GridPoint& dst) {
+            if (game.isLegalAttack(src, dst) && game.getCharacter(dst) != nullptr) {
+                commands.push_back(Command(ATTACK_COMMAND, src, dst));
+            }
+        });
+
+        game.forEachCellInRange(src, character.getTravelDistance(), [&](const GridPoint& dst) {
+            if (game.isLegalMove(src, dst)) {
+                commands.push_back(Command(MOVE_COMMAND, src, dst));
+            }
+        });
+
+        commands.push_back(Command(RELOAD_COMMAND, src, src));
+    }
+
+    RandomPolicy::RandomPolicy(uint64_t game_id) :
+        game_id(game_id)
+    {}
+
+    bool RandomPolicy::choose(const Game& game, Team team, uint64_t turn, Command& command) const
+    {
+        std::vector<GridPoint> units;
+        game.forEachCharacter([&](const GridPoint& coordinates, const Character& character) {
+            if (character.getTeam() == team) {
+                units.push_back(coordinates);
+            }
+        });
+        if (units.empty()) {
+            return false;
+        }
+
+        const GridPoint& src = units[CounterRng(game_id, turn, getTeamKey(team)).nextBelow(units.size())];
+        std::vector<Command> commands;
+        listCommands(game, src, commands);
+
+        // the reload is always legal, so the list is never empty.
+        CounterRng generator(game_id, turn, getUnitKey(game.getHandle(src)));
+        command = commands[generator.nextBelow(commands.size())];
+        return true;
+    }
+
+    GreedyPolicy::GreedyPolicy(uint64_t game_id) :
+        game_id(game_id)
+    {}
+
+    bool GreedyPolicy::choose(const Game& game, Team team, uint64_t turn, Command& command) const
+    {
+        std::vector<Command> commands;
+        game.forEachCharacter([&](const GridPoint& coordinates, const Character& character) {
+            if (character.getTeam() == team) {
+                listCommands(game, coordinates, commands);
+            }
+        });
+        if (commands.empty()) {
+            return false;
+        }
+
+        // only an attack changes the score, the other commands keep the current one.
+        int base_score = GameSearcher::evaluate(game, team);
+        int best_score = base_score;
+        std::vector<size_t> best;
+        for (size_t index = 0; index < commands.size(); ++index) {
+            int score = base_score;
+            if (commands[index].type == ATTACK_COMMAND) {
+                Game child(game);
+                score = executeCommand(child, commands[index]) == SUCCESS ? GameSearcher::evaluate(child, team)
+                                                                          : base_score;
+            }
+
+            if (best.empty() || score > best_score) {
+                best.clear();
+                best_score = score;
+            }
+            if (score == best_score) {
+                best.push_back(index);
+            }
+        }
+
+        command = commands[best[CounterRng(game_id, turn, getTeamKey(team)).nextBelow(best.size())]];
+        return true;
+    }
+}
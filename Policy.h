@@ -0,0 +1,103 @@
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "Game.h"
+#include "Command.h"
+#include "CounterRng.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * Policy - the interface of a player that chooses a team's command every turn.
+     *
+     * The built-in policies draw their random numbers from CounterRng streams keyed on (game id, turn, unit),
+     * so the command they choose is a pure function of the game's position, the team, the turn and the game id:
+     * games played by many threads at once choose bit-identical commands whatever the threads' scheduling.
+     */
+    class Policy
+    {
+        public:
+            virtual ~Policy() = default;
+
+            /**
+             * choose: chooses a legal command for one of a team's characters.
+             *
+             * @param game    - the position.
+             * @param team    - the team to play.
+             * @param turn    - the index of the turn in the game.
+             * @param command - the result keeper.
+             *
+             * @return
+             *     true if a command was chosen, false if the team has no characters left.
+             *
+             * NOTE: the function must be safe to call from many threads at once.
+             */
+            virtual bool choose(const Game& game, Team team, uint64_t turn, Command& command) const = 0;
+
+            /**
+             * getUnitKey: the unit id of a character's random stream.
+             */
+            static uint64_t getUnitKey(UnitHandle unit);
+
+            /**
+             * getTeamKey: the unit id of a team's random stream (it never equals the id of a character).
+             */
+            static uint64_t getTeamKey(Team team);
+
+            /**
+             * listCommands: lists the legal commands of a single character: its attacks of non-empty cells,
+             * then its moves, then its reload.
+             *
+             * @param game     - the position.
+             * @param src      - the coordinates of the character.
+             * @param commands - the result keeper. the commands are appended to its content.
+             */
+            static void listCommands(const Game& game, const GridPoint& src, std::vector<Command>& commands);
+    };
+
+    /**
+     * RandomPolicy - chooses one of the team's characters uniformly, then one of its legal commands uniformly.
+     */
+    class RandomPolicy : public Policy
+    {
+        uint64_t game_id;
+
+        public:
+            /**
+             * RandomPolicy constructor: creates a random policy.
+             *
+             * @param game_id - the id of the game the policy plays (for example, the game's seed).
+             */
+            explicit RandomPolicy(uint64_t game_id);
+
+            bool choose(const Game& game, Team team, uint64_t turn, Command& command) const override;
+    };
+
+    /**
+     * GreedyPolicy - chooses the command of the best one-ply score (see GameSearcher::evaluate).
+     * the ties are broken uniformly, so with no useful attack it plays like a random policy over all the commands.
+     *
+     * NOTE: every legal attack is scored on a copy of the game. a copy costs O(characters) plus its three bitboards,
+     *       which are dense arrays of H * W / 64 words up to Bitboard::DENSE_WORDS_LIMIT and sparse beyond it,
+     *       so a turn costs O(attacks * (characters + min(H * W / 64, DENSE_WORDS_LIMIT))).
+     */
+    class GreedyPolicy : public Policy
+    {
+        uint64_t game_id;
+
+        public:
+            /**
+             * GreedyPolicy constructor: creates a greedy policy.
+             *
+             * @param game_id - the id of the game the policy plays (for example, the game's seed).
+             */
+            explicit GreedyPolicy(uint64_t game_id);
+
+            bool choose(const Game& game, Team team, uint64_t turn, Command& command) const override;
+    };
+}
+
+#endif
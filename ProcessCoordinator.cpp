@@ -0,0 +1,440 @@
+#include "ProcessCoordinator.h"
+
+#include "Exceptions.h"
+#include "Zobrist.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <poll.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace mtm {
+
+    typedef std::chrono::steady_clock CoordinatorClock;
+
+    const uint64_t ProcessCoordinator::STOP_POINT;
+
+    // the number of node directories looked for in /sys/devices/system/node.
+    static const int MAX_NUMA_NODES = 64;
+
+    /**
+     * PointRequest, PointReply - the messages of the coordinator and of a worker. both ends run the same binary
+     * on the same machine, so the messages are sent as they are laid out in memory.
+     */
+    struct PointRequest
+    {
+        uint64_t point_index;
+        uint64_t attempt;
+    };
+
+    struct PointReply
+    {
+        uint64_t point_index;
+        int64_t matches;
+        int64_t crossfitters_wins;
+        int64_t powerlifters_wins;
+        int64_t draws;
+        double score;
+        double half_width;
+        double mean_actions;
+    };
+
+    /**
+     * WorkerProcess - the coordinator's side of a worker: its process, its socket and the point it plays.
+     */
+    struct WorkerProcess
+    {
+        pid_t pid;
+        int socket;
+        size_t node;
+        bool is_busy;
+        uint64_t point_index;
+    };
+
+    CoordinatorConfig::CoordinatorConfig(const SweepConfig& sweep) :
+        sweep(sweep),
+        processes(0),
+        pin_workers(true),
+        max_restarts(16),
+        max_attempts(3),
+        failure_rate(0)
+    {}
+
+    CoordinatorResult::CoordinatorResult() :
+        records(),
+        failed_points(),
+        matches(0),
+        crossfitters_wins(0),
+        powerlifters_wins(0),
+        draws(0),
+        processes(0),
+        failed_workers(0),
+        restarts(0),
+        seconds(0)
+    {}
+
+    double CoordinatorResult::getMatchesPerSecond() const
+    {
+        return seconds > 0 ? double(matches) / seconds : 0;
+    }
+
+    /**
+     * writeAll, readAll: send or receive a whole message, retrying on partial transfers and interrupts.
+     *
+     * @return
+     *     true on success, false if the socket was closed or failed.
+     */
+    static bool writeAll(int socket, const void* data, size_t size)
+    {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t written = send(socket, bytes, size, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return false;
+            }
+            bytes += written;
+            size -= size_t(written);
+        }
+        return true;
+    }
+
+    static bool readAll(int socket, void* data, size_t size)
+    {
+        char* bytes = static_cast<char*>(data);
+        while (size > 0) {
+            ssize_t count = recv(socket, bytes, size, 0);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                return false;
+            }
+            bytes += count;
+            size -= size_t(count);
+        }
+        return true;
+    }
+
+    /**
+     * pinToCpus: restricts the calling process to a set of CPUs. does nothing outside Linux.
+     */
+    static void pinToCpus(const std::vector<int>& cpus)
+    {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        sched_setaffinity(0, sizeof(set), &set);
+#else
+        (void)cpus;
+#endif
+    }
+
+    /**
+     * startWorker: forks a worker process, connected to the coordinator by a new socket pair.
+     *
+     * @param workers - the other workers, whose sockets the new process closes.
+     *
+     * @throw
+     *     IllegalArgument - if the socket pair or the process can't be created.
+     */
+    static WorkerProcess startWorker(const CoordinatorConfig& config, const std::vector<std::vector<int>>& nodes,
+                                     size_t node, const std::vector<WorkerProcess>& workers,
+                                     void (*run)(int, const CoordinatorConfig&))
+    {
+        int sockets[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+            throw IllegalArgument();
+        }
+
+        std::cout.flush();
+        std::cerr.flush();
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(sockets[0]);
+            close(sockets[1]);
+            throw IllegalArgument();
+        }
+
+        if (pid == 0) {
+            close(sockets[0]);
+            for (const WorkerProcess& worker : workers) {
+                close(worker.socket);
+            }
+            if (config.pin_workers && node < nodes.size()) {
+                pinToCpus(nodes[node]);
+            }
+            run(sockets[1], config);
+        }
+
+        close(sockets[1]);
+        return WorkerProcess{pid, sockets[0], node, false, 0};
+    }
+
+    /**
+     * stopWorker: closes the socket of a worker and reaps its process.
+     */
+    static void stopWorker(const WorkerProcess& worker)
+    {
+        close(worker.socket);
+        int status;
+        while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR);
+    }
+
+    CoordinatorResult ProcessCoordinator::run(const CoordinatorConfig& config)
+    {
+        BalanceSweep::validateConfig(config.sweep);
+        if (config.max_attempts == 0 || !(config.failure_rate >= 0 && config.failure_rate <= 1)) {
+            throw IllegalArgument();
+        }
+
+        CoordinatorResult result;
+        size_t points_count = config.sweep.grid.getSize();
+        unsigned int processes = config.processes > 0 ? config.processes
+                                                      : std::max(1u, std::thread::hardware_concurrency());
+        processes = unsigned(std::max<size_t>(1, std::min<size_t>(processes, points_count)));
+        result.processes = processes;
+
+        std::vector<std::vector<int>> nodes;
+        readNumaNodes(nodes);
+
+        CoordinatorClock::time_point start = CoordinatorClock::now();
+        std::deque<uint64_t> queue;
+        for (uint64_t index = 0; index < points_count; ++index) {
+            queue.push_back(index);
+        }
+        std::vector<unsigned int> attempts(points_count, 0);
+        std::vector<bool> is_done(points_count, false);
+
+        std::vector<WorkerProcess> workers;
+        for (unsigned int i = 0; i < processes && points_count > 0; ++i) {
+            workers.push_back(startWorker(config, nodes, nodes.empty() ? 0 : i % nodes.size(), workers, runWorker));
+        }
+
+        // a failed worker's point is queued again (or given up), and the worker is replaced while restarts are left.
+        auto fail = [&](size_t index) {
+            WorkerProcess worker = workers[index];
+            workers.erase(workers.begin() + index);
+            stopWorker(worker);
+            ++result.failed_workers;
+
+            if (attempts[worker.point_index] >= config.max_attempts) {
+                result.failed_points.push_back(worker.point_index);
+            }
+            else {
+                queue.push_front(worker.point_index);
+            }
+            if (result.restarts < config.max_restarts) {
+                workers.push_back(startWorker(config, nodes, worker.node, workers, runWorker));
+                ++result.restarts;
+            }
+        };
+
+        std::vector<pollfd> polled;
+        while (!workers.empty()) {
+            for (size_t i = 0; i < workers.size() && !queue.empty(); ++i) {
+                if (workers[i].is_busy) {
+                    continue;
+                }
+
+                PointRequest request{queue.front(), attempts[queue.front()]++};
+                queue.pop_front();
+                workers[i].is_busy = true;
+                workers[i].point_index = request.point_index;
+                if (!writeAll(workers[i].socket, &request, sizeof(request))) {
+                    fail(i--);
+                }
+            }
+
+            polled.clear();
+            for (const WorkerProcess& worker : workers) {
+                if (worker.is_busy) {
+                    polled.push_back(pollfd{worker.socket, POLLIN, 0});
+                }
+            }
+            if (polled.empty()) {
+                break; // nothing left to play.
+            }
+            if (poll(polled.data(), polled.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw IllegalArgument();
+            }
+
+            for (const pollfd& entry : polled) {
+                if (entry.revents == 0) {
+                    continue;
+                }
+
+                size_t index = 0;
+                while (workers[index].socket != entry.fd) {
+                    ++index;
+                }
+                PointReply reply;
+                if (!readAll(entry.fd, &reply, sizeof(reply)) || reply.point_index != workers[index].point_index) {
+                    fail(index);
+                    continue;
+                }
+
+                workers[index].is_busy = false;
+                if (is_done[reply.point_index]) {
+                    continue;
+                }
+                is_done[reply.point_index] = true;
+
+                SweepRecord record;
+                record.point_index = reply.point_index;
+                record.point = config.sweep.grid.getPoint(size_t(reply.point_index));
+                record.matches = int(reply.matches);
+                record.crossfitters_wins = int(reply.crossfitters_wins);
+                record.powerlifters_wins = int(reply.powerlifters_wins);
+                record.draws = int(reply.draws);
+                record.score = reply.score;
+                record.half_width = reply.half_width;
+                record.mean_actions = reply.mean_actions;
+                result.records.push_back(record);
+
+                result.matches += uint64_t(reply.matches);
+                result.crossfitters_wins += uint64_t(reply.crossfitters_wins);
+                result.powerlifters_wins += uint64_t(reply.powerlifters_wins);
+                result.draws += uint64_t(reply.draws);
+            }
+        }
+
+        for (const WorkerProcess& worker : workers) {
+            PointRequest request{STOP_POINT, 0};
+            writeAll(worker.socket, &request, sizeof(request));
+            stopWorker(worker);
+        }
+
+        // the points left when no worker is left are given up too.
+        for (uint64_t index : queue) {
+            result.failed_points.push_back(index);
+        }
+        std::sort(result.failed_points.begin(), result.failed_points.end());
+        std::sort(result.records.begin(), result.records.end(), [](const SweepRecord& a, const SweepRecord& b) {
+            return a.point_index < b.point_index;
+        });
+
+        result.seconds = std::chrono::duration<double>(CoordinatorClock::now() - start).count();
+        return result;
+    }
+
+    std::vector<ScalingSample> ProcessCoordinator::measureScaling(const CoordinatorConfig& config,
+                                                                  unsigned int max_processes)
+    {
+        if (max_processes == 0) {
+            max_processes = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        std::vector<ScalingSample> samples;
+        CoordinatorConfig run_config = config;
+        for (unsigned int processes = 1; processes <= max_processes; ++processes) {
+            run_config.processes = processes;
+            CoordinatorResult result = run(run_config);
+
+            ScalingSample sample;
+            sample.processes = result.processes;
+            sample.seconds = result.seconds;
+            sample.matches_per_second = result.getMatchesPerSecond();
+            sample.speedup = result.seconds > 0 && !samples.empty() ? samples[0].seconds / result.seconds : 1;
+            samples.push_back(sample);
+        }
+        return samples;
+    }
+
+    std::ostream& ProcessCoordinator::printScaling(std::ostream& os, const std::vector<ScalingSample>& samples)
+    {
+        os << "processes,seconds,matches_per_second,speedup" << std::endl;
+        for (const ScalingSample& sample : samples) {
+            os << sample.processes << ',' << sample.seconds << ',' << sample.matches_per_second << ','
+               << sample.speedup << std::endl;
+        }
+        return os;
+    }
+
+    void ProcessCoordinator::readNumaNodes(std::vector<std::vector<int>>& nodes)
+    {
+        nodes.clear();
+        for (int node = 0; node < MAX_NUMA_NODES; ++node) {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            std::string list;
+            if (!file || !std::getline(file, list)) {
+                continue;
+            }
+
+            // the list is made of comma separated CPUs and inclusive ranges, such as "0-3,8-11".
+            std::vector<int> cpus;
+            std::istringstream ranges(list);
+            std::string range;
+            while (std::getline(ranges, range, ',')) {
+                int first = 0, last = 0;
+                char dash = 0;
+                std::istringstream bounds(range);
+                if (!(bounds >> first)) {
+                    continue;
+                }
+                last = (bounds >> dash >> last) ? last : first;
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+            if (!cpus.empty()) {
+                nodes.push_back(cpus);
+            }
+        }
+    }
+
+    void ProcessCoordinator::runWorker(int socket, const CoordinatorConfig& config)
+    {
+        PointRequest request;
+        while (readAll(socket, &request, sizeof(request)) && request.point_index != STOP_POINT) {
+            if (isInjectedFailure(config, request.point_index, request.attempt)) {
+                _exit(2);
+            }
+
+            SweepRecord record;
+            try {
+                record = BalanceSweep::runPoint(config.sweep, size_t(request.point_index));
+            }
+            catch (...) {
+                _exit(1);
+            }
+
+            PointReply reply{request.point_index, record.matches, record.crossfitters_wins, record.powerlifters_wins,
+                             record.draws, record.score, record.half_width, record.mean_actions};
+            if (!writeAll(socket, &reply, sizeof(reply))) {
+                break;
+            }
+        }
+        _exit(0);
+    }
+
+    bool ProcessCoordinator::isInjectedFailure(const CoordinatorConfig& config, uint64_t point_index, uint64_t attempt)
+    {
+        if (config.failure_rate <= 0) {
+            return false;
+        }
+        uint64_t bits = Zobrist::mix(config.sweep.seed ^ Zobrist::mix(point_index ^ Zobrist::mix(attempt + 1)));
+        return double(bits >> 11) * (1.0 / 9007199254740992.0) < config.failure_rate;
+    }
+}
@@ -0,0 +1,147 @@
+#ifndef PROCESS_COORDINATOR_H
+#define PROCESS_COORDINATOR_H
+
+#include "BalanceSweep.h"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * CoordinatorConfig - the parameters of a multi-process run.
+     *
+     * sweep        - the grid points to play and their matches (see BalanceSweep.h). its threads are not used:
+     *                every worker process plays a single point at a time.
+     * processes    - the number of worker processes. 0 means one process per hardware thread.
+     * pin_workers  - pin every worker to the CPUs of a NUMA node, the workers spread over the nodes in turn.
+     * max_restarts - the number of failed workers replaced by new ones before the run goes on with fewer workers.
+     * max_attempts - the number of times a point is sent to a worker before it is given up as failed.
+     * failure_rate - the probability that a worker aborts when it gets a point, for testing the failure tolerance.
+     *                the aborts depend only on the point and its attempt, so they are reproducible. 0 in production.
+     */
+    struct CoordinatorConfig
+    {
+        SweepConfig sweep;
+        unsigned int processes;
+        bool pin_workers;
+        unsigned int max_restarts;
+        unsigned int max_attempts;
+        double failure_rate;
+
+        /**
+         * CoordinatorConfig constructor: creates a config of a sweep, with a process per hardware thread
+         * pinned to the NUMA nodes, up to 16 restarts, 3 attempts per point and no injected failures.
+         */
+        explicit CoordinatorConfig(const SweepConfig& sweep);
+    };
+
+    /**
+     * CoordinatorResult - the merged results of a multi-process run.
+     *
+     * records         - the record of every completed point, sorted by point index. every point is merged once,
+     *                   even if it was played again after a failure.
+     * failed_points   - the points given up after max_attempts failed attempts.
+     * *_wins, draws   - the per-team totals of the completed points' matches.
+     * failed_workers  - the number of worker processes that died while playing a point.
+     * restarts        - the number of workers started to replace the failed ones.
+     */
+    struct CoordinatorResult
+    {
+        std::vector<SweepRecord> records;
+        std::vector<uint64_t> failed_points;
+        uint64_t matches;
+        uint64_t crossfitters_wins;
+        uint64_t powerlifters_wins;
+        uint64_t draws;
+        unsigned int processes;
+        unsigned int failed_workers;
+        unsigned int restarts;
+        double seconds;
+
+        CoordinatorResult();
+
+        /**
+         * getMatchesPerSecond: the throughput of the run.
+         */
+        double getMatchesPerSecond() const;
+    };
+
+    /**
+     * ScalingSample - the throughput of a run with a number of worker processes.
+     */
+    struct ScalingSample
+    {
+        unsigned int processes;
+        double seconds;
+        double matches_per_second;
+        double speedup; // relative to the single process run.
+    };
+
+    /**
+     * ProcessCoordinator - plays the grid points of a balance sweep in worker processes on one machine.
+     *
+     * Every worker is forked from the coordinator, so each one has its own heap, and the allocations of its
+     * characters never contend with the other workers' (unlike BalanceSweep's threads). A worker is connected to
+     * the coordinator by a Unix socket pair, a stand-in for a cluster transport: it receives a point index and an
+     * attempt number (16 bytes) and answers with the point's record (64 bytes), until it receives STOP_POINT.
+     *
+     * The points are seeded (see BalanceSweep::runPoint), so a point played again gives the same record.
+     * A worker that dies or closes its socket while playing a point is reaped, its point is queued again and
+     * the worker is replaced (up to max_restarts). The run goes on as long as a worker is left.
+     *
+     * NOTE: POSIX only (fork, socketpair, poll). the NUMA nodes are read from /sys/devices/system/node,
+     *       and the pinning is done on Linux only. the coordinator must be called from a single-threaded process.
+     */
+    class ProcessCoordinator
+    {
+        public:
+            static const uint64_t STOP_POINT = ~uint64_t(0);
+
+            /**
+             * run: plays all the grid points of a sweep in worker processes.
+             *
+             * @param config - the parameters of the run.
+             *
+             * @throw
+             *     IllegalArgument - if a parameter is incorrect, or the workers can't be started.
+             */
+            static CoordinatorResult run(const CoordinatorConfig& config);
+
+            /**
+             * measureScaling: plays the same sweep with 1 to max_processes worker processes.
+             *
+             * @param config        - the parameters of the runs. its processes is ignored.
+             * @param max_processes - the largest number of processes. 0 means one per hardware thread.
+             */
+            static std::vector<ScalingSample> measureScaling(const CoordinatorConfig& config,
+                                                             unsigned int max_processes);
+
+            /**
+             * printScaling: prints scaling samples as CSV, one line per number of processes.
+             */
+            static std::ostream& printScaling(std::ostream& os, const std::vector<ScalingSample>& samples);
+
+            /**
+             * readNumaNodes: reads the CPUs of every NUMA node of the machine.
+             *
+             * @param nodes - the result keeper: the CPUs of every node. its previous content is removed.
+             *                left empty if the machine does not report its nodes.
+             */
+            static void readNumaNodes(std::vector<std::vector<int>>& nodes);
+
+        private:
+            /**
+             * runWorker: the loop of a worker process. never returns.
+             */
+            static void runWorker(int socket, const CoordinatorConfig& config);
+
+            /**
+             * isInjectedFailure: true if a worker aborts on an attempt of a point (see failure_rate).
+             */
+            static bool isInjectedFailure(const CoordinatorConfig& config, uint64_t point_index, uint64_t attempt);
+    };
+}
+
+#endif
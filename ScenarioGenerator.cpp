@@ -0,0 +1,215 @@
+#include "ScenarioGenerator.h"
+
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mtm {
+
+    StatRange::StatRange(units_t min, units_t max) :
+        min(min),
+        max(max)
+    {}
+
+    ScenarioConfig::ScenarioConfig(int height, int width) :
+        height(height),
+        width(width),
+        density(0.1),
+        crossfitters_ratio(0.5),
+        soldier_weight(1),
+        medic_weight(1),
+        sniper_weight(1),
+        health(1, 10),
+        ammo(0, 5),
+        range(1, 6),
+        power(1, 5),
+        seed(0)
+    {}
+
+    uint64_t ScenarioGenerator::randomBelow(std::mt19937_64& generator, uint64_t bound)
+    {
+        if (bound <= 1) {
+            return 0;
+        }
+
+        // values below the threshold would make the low residues more likely, so they are drawn again.
+        // (std::uniform_int_distribution would do as well, but its results differ between standard libraries.)
+        uint64_t threshold = (0 - bound) % bound;
+        uint64_t value = generator();
+        while (value < threshold) {
+            value = generator();
+        }
+        return value % bound;
+    }
+
+    units_t ScenarioGenerator::randomInt(std::mt19937_64& generator, units_t min, units_t max)
+    {
+        uint64_t span = uint64_t(int64_t(max) - int64_t(min)) + 1;
+        return units_t(int64_t(min) + int64_t(randomBelow(generator, span)));
+    }
+
+    double ScenarioGenerator::randomReal(std::mt19937_64& generator)
+    {
+        return (generator() >> 11) * (1.0 / 9007199254740992.0); // 53 random bits.
+    }
+
+    /**
+     * randomPositive: draws a real number uniformly from (0, 1], whose logarithm is finite.
+     */
+    static double randomPositive(std::mt19937_64& generator)
+    {
+        return 1.0 - ScenarioGenerator::randomReal(generator);
+    }
+
+    /**
+     * sampleCells: Vitter's sequential random sampling ("An Efficient Algorithm for Sequential Random Sampling",
+     * 1987). visits "needed" distinct cells of [0, cells) in increasing order, every subset being equally likely.
+     *
+     * Instead of rolling every cell, the number of cells skipped before the next chosen one is drawn directly
+     * (Algorithm D), so the cost is O(needed) whatever the board's size. Once the remaining sample is dense
+     * (needed * DENSE_SAMPLE_RATIO >= cells), the skips are drawn by walking the cells (Algorithm A), which costs
+     * at most DENSE_SAMPLE_RATIO cells per chosen one.
+     */
+    template <class Visitor>
+    static void sampleCells(std::mt19937_64& generator, uint64_t needed, uint64_t cells, Visitor visit)
+    {
+        static const uint64_t DENSE_SAMPLE_RATIO = 13;
+
+        uint64_t cell = 0;
+        if (needed == 0) {
+            return;
+        }
+
+        double vprime = std::exp(std::log(randomPositive(generator)) / double(needed));
+        while (needed > 1 && needed * DENSE_SAMPLE_RATIO < cells)
+        {
+            double n = double(needed);
+            double total = double(cells);
+            uint64_t quota = cells - needed + 1; // the skip must leave a cell for every other needed one.
+            double quota_real = double(quota);
+            uint64_t skip = 0;
+
+            while (true)
+            {
+                double x = 0;
+                while (true) {
+                    x = total * (1 - vprime);
+                    skip = uint64_t(x);
+                    if (skip < quota) {
+                        break;
+                    }
+                    vprime = std::exp(std::log(randomPositive(generator)) / n);
+                }
+
+                double y1 = std::exp(std::log(randomPositive(generator) * total / quota_real) / (n - 1));
+                vprime = y1 * (1 - x / total) * (quota_real / (quota_real - double(skip)));
+                if (vprime <= 1) {
+                    break; // accepted by the squeeze test.
+                }
+
+                double y2 = 1;
+                double top = total - 1;
+                double bottom = needed - 1 > skip ? total - n : total - 1 - double(skip);
+                uint64_t limit = needed - 1 > skip ? cells - skip : quota;
+                for (uint64_t index = cells - 1; index >= limit; --index) {
+                    y2 = y2 * top / bottom;
+                    top -= 1;
+                    bottom -= 1;
+                }
+                if (total / (total - x) >= y1 * std::exp(std::log(y2) / (n - 1))) {
+                    vprime = std::exp(std::log(randomPositive(generator)) / (n - 1));
+                    break; // accepted by the exact test.
+                }
+                vprime = std::exp(std::log(randomPositive(generator)) / n);
+            }
+
+            visit(cell + skip);
+            cell += skip + 1;
+            cells -= skip + 1;
+            --needed;
+        }
+
+        while (needed > 1)
+        {
+            double roll = ScenarioGenerator::randomReal(generator);
+            double top = double(cells - needed);
+            double total = double(cells);
+            double quotient = top / total;
+            uint64_t skip = 0;
+            while (quotient > roll) {
+                ++skip;
+                top -= 1;
+                total -= 1;
+                quotient = quotient * top / total;
+            }
+
+            visit(cell + skip);
+            cell += skip + 1;
+            cells -= skip + 1;
+            --needed;
+        }
+
+        if (needed == 1) {
+            visit(cell + std::min(cells - 1, uint64_t(double(cells) * ScenarioGenerator::randomReal(generator))));
+        }
+    }
+
+    void ScenarioGenerator::validateConfig(const ScenarioConfig& config)
+    {
+        const StatRange* ranges[] = { &config.health, &config.ammo, &config.range, &config.power };
+        for (const StatRange* range : ranges) {
+            if ((*range).min > (*range).max) {
+                throw IllegalArgument();
+            }
+        }
+
+        if (config.height < 1 || config.width < 1 ||
+            !(config.density >= 0 && config.density <= 1) ||
+            !(config.crossfitters_ratio >= 0 && config.crossfitters_ratio <= 1) ||
+            config.soldier_weight < 0 || config.medic_weight < 0 || config.sniper_weight < 0 ||
+            config.soldier_weight + config.medic_weight + config.sniper_weight <= 0 ||
+            config.health.min <= 0 || config.ammo.min < 0 || config.range.min < 0 || config.power.min < 0) {
+            throw IllegalArgument();
+        }
+    }
+
+    std::vector<UnitDescriptor> ScenarioGenerator::generate(const ScenarioConfig& config)
+    {
+        validateConfig(config);
+
+        std::mt19937_64 generator(config.seed);
+        uint64_t cells = uint64_t(config.height) * uint64_t(config.width);
+        uint64_t needed = uint64_t(std::llround(config.density * double(cells)));
+        double total_weight = config.soldier_weight + config.medic_weight + config.sniper_weight;
+
+        std::vector<UnitDescriptor> units;
+        units.reserve(needed);
+
+        sampleCells(generator, needed, cells, [&](uint64_t cell) {
+            double type_roll = randomReal(generator) * total_weight;
+            CharacterType type = type_roll < config.soldier_weight                       ? SOLDIER :
+                                 type_roll < config.soldier_weight + config.medic_weight ? MEDIC   : SNIPER;
+            Team team = randomReal(generator) < config.crossfitters_ratio ? CROSSFITTERS : POWERLIFTERS;
+
+            units_t health = randomInt(generator, config.health.min, config.health.max);
+            units_t ammo   = randomInt(generator, config.ammo.min,   config.ammo.max);
+            units_t range  = randomInt(generator, config.range.min,  config.range.max);
+            units_t power  = randomInt(generator, config.power.min,  config.power.max);
+
+            units.push_back(UnitDescriptor(GridPoint(int(cell / uint64_t(config.width)),
+                                                     int(cell % uint64_t(config.width))),
+                                           type, team, health, ammo, range, power));
+        });
+
+        return units;
+    }
+
+    std::unique_ptr<Game> ScenarioGenerator::build(const ScenarioConfig& config)
+    {
+        std::vector<UnitDescriptor> units = generate(config);
+        std::unique_ptr<Game> game(new Game(config.height, config.width));
+        (*game).loadValidUnits(units.data(), units.data() + units.size());
+        return game;
+    }
+}
@@ -0,0 +1,114 @@
+#ifndef SCENARIO_GENERATOR_H
+#define SCENARIO_GENERATOR_H
+
+#include "Game.h"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * StatRange - an inclusive range of a stat, from which values are drawn uniformly.
+     */
+    struct StatRange
+    {
+        units_t min;
+        units_t max;
+
+        StatRange(units_t min, units_t max);
+    };
+
+    /**
+     * ScenarioConfig - the parameters of a generated scenario.
+     *
+     * density            - the fraction of the board's cells that hold a character, between 0 and 1.
+     * crossfitters_ratio - the probability of a character to belong to the crossfitters, between 0 and 1.
+     * *_weight           - the relative frequency of every character type. must be non-negative, not all 0.
+     * health ... power   - the ranges of the characters' stats, with the same conditions as in Game::makeCharacter.
+     * seed               - the same seed and parameters always generate the same scenario.
+     */
+    struct ScenarioConfig
+    {
+        int height;
+        int width;
+        double density;
+        double crossfitters_ratio;
+        double soldier_weight;
+        double medic_weight;
+        double sniper_weight;
+        StatRange health;
+        StatRange ammo;
+        StatRange range;
+        StatRange power;
+        uint64_t seed;
+
+        /**
+         * ScenarioConfig constructor: creates a config of the given board dimensions with default values:
+         * density 0.1, balanced teams and types, health 1-10, ammo 0-5, range 1-6, power 1-5, seed 0.
+         */
+        ScenarioConfig(int height, int width);
+    };
+
+    /**
+     * ScenarioGenerator - builds seeded random scenarios and bulk-loads them into games.
+     *
+     * The generated units are valid and sorted by ComparePoints by construction,
+     * so they are loaded with Game::loadValidUnits, without any per-unit bounds or occupancy checks.
+     */
+    class ScenarioGenerator
+    {
+        public:
+            /**
+             * generate: generates the units of a scenario.
+             *
+             * @param config - the parameters of the scenario.
+             *
+             * @throw
+             *     IllegalArgument - if one of the parameters is incorrect.
+             *
+             * @return
+             *     the units of the scenario, sorted by ComparePoints. exactly round(density * height * width) units.
+             */
+            static std::vector<UnitDescriptor> generate(const ScenarioConfig& config);
+
+            /**
+             * build: generates a scenario and loads it into a new game.
+             *
+             * @param config - the parameters of the scenario.
+             *
+             * @throw
+             *     IllegalArgument - if one of the parameters is incorrect.
+             *
+             * @return
+             *     a new game holding the scenario's units.
+             */
+            static std::unique_ptr<Game> build(const ScenarioConfig& config);
+
+            /**
+             * randomBelow: draws an integer uniformly from [0, bound), identically on every platform.
+             *              a bound of 0 or 1 gives 0.
+             */
+            static uint64_t randomBelow(std::mt19937_64& generator, uint64_t bound);
+
+            /**
+             * randomInt: draws an integer uniformly from [min, max], identically on every platform.
+             */
+            static units_t randomInt(std::mt19937_64& generator, units_t min, units_t max);
+
+            /**
+             * randomReal: draws a real number uniformly from [0, 1), identically on every platform.
+             */
+            static double randomReal(std::mt19937_64& generator);
+
+        private:
+            /**
+             * validateConfig: throws IllegalArgument if one of the config's parameters is incorrect.
+             */
+            static void validateConfig(const ScenarioConfig& config);
+    };
+}
+
+#endif
@@ -0,0 +1,242 @@
+#include "ScenarioParser.h"
+
+#include "Exceptions.h"
+
+#include <chrono>
+#include <climits>
+#include <cstring>
+
+namespace mtm {
+
+    typedef std::chrono::steady_clock ParseClock;
+
+    double ScenarioStats::getMegabytesPerSecond() const
+    {
+        return seconds > 0 ? double(bytes) / seconds / 1e6 : 0;
+    }
+
+    ScenarioParser::ScenarioParser(size_t chunk_size) :
+        buffer(),
+        pending_units(),
+        game(),
+        stats()
+    {
+        if (chunk_size == 0) {
+            throw IllegalArgument();
+        }
+        buffer.resize(chunk_size);
+    }
+
+    const ScenarioStats& ScenarioParser::getStats() const
+    {
+        return stats;
+    }
+
+    bool ScenarioParser::isToken(const Token& token, const char* word)
+    {
+        size_t length = size_t(token.end - token.begin);
+        return std::strlen(word) == length && std::memcmp(token.begin, word, length) == 0;
+    }
+
+    int ScenarioParser::parseInt(const Token& token)
+    {
+        const char* digit = token.begin;
+        bool is_negative = (*digit == '-');
+        if (is_negative || *digit == '+') {
+            ++digit;
+        }
+        if (digit == token.end) {
+            throw IllegalArgument();
+        }
+
+        long long value = 0;
+        for (; digit != token.end; ++digit) {
+            if (*digit < '0' || *digit > '9') {
+                throw IllegalArgument();
+            }
+            value = value * 10 + (*digit - '0');
+            if (value > (long long)INT_MAX + 1) {
+                throw IllegalArgument();
+            }
+        }
+
+        value = is_negative ? -value : value;
+        if (value > INT_MAX) {
+            throw IllegalArgument();
+        }
+        return int(value);
+    }
+
+    CharacterType ScenarioParser::parseType(const Token& token)
+    {
+        if (isToken(token, "soldier")) {
+            return SOLDIER;
+        }
+        if (isToken(token, "medic")) {
+            return MEDIC;
+        }
+        if (isToken(token, "sniper")) {
+            return SNIPER;
+        }
+        throw IllegalArgument();
+    }
+
+    Team ScenarioParser::parseTeam(const Token& token)
+    {
+        if (isToken(token, "powerlifters")) {
+            return POWERLIFTERS;
+        }
+        if (isToken(token, "crossfitters")) {
+            return CROSSFITTERS;
+        }
+        throw IllegalArgument();
+    }
+
+    GridPoint ScenarioParser::parsePoint(const Token& row, const Token& col)
+    {
+        return GridPoint(parseInt(row), parseInt(col));
+    }
+
+    void ScenarioParser::loadPendingUnits()
+    {
+        if (pending_units.empty()) {
+            return;
+        }
+        (*game).loadUnits(pending_units.data(), pending_units.data() + pending_units.size());
+        pending_units.clear();
+    }
+
+    void ScenarioParser::parseLine(const char* begin, const char* end)
+    {
+        Token tokens[MAX_TOKENS];
+        int count = 0;
+        for (const char* current = begin; current != end;)
+        {
+            if (*current == ' ' || *current == '\t' || *current == '\r') {
+                ++current;
+                continue;
+            }
+            if (count == MAX_TOKENS) {
+                throw IllegalArgument();
+            }
+            tokens[count].begin = current;
+            while (current != end && *current != ' ' && *current != '\t' && *current != '\r') {
+                ++current;
+            }
+            tokens[count++].end = current;
+        }
+
+        if (count == 0 || *tokens[0].begin == '#') {
+            return;
+        }
+
+        if (isToken(tokens[0], "board")) {
+            if (count != 3 || game) {
+                throw IllegalArgument();
+            }
+            game.reset(new Game(parseInt(tokens[1]), parseInt(tokens[2])));
+            return;
+        }
+        if (!game) {
+            throw IllegalArgument();
+        }
+
+        if (isToken(tokens[0], "unit")) {
+            if (count != 9) {
+                throw IllegalArgument();
+            }
+            pending_units.push_back(UnitDescriptor(parsePoint(tokens[1], tokens[2]), parseType(tokens[3]),
+                                                   parseTeam(tokens[4]), parseInt(tokens[5]), parseInt(tokens[6]),
+                                                   parseInt(tokens[7]), parseInt(tokens[8])));
+            ++stats.units;
+            return;
+        }
+
+        Command command;
+        if (isToken(tokens[0], "move") && count == 5) {
+            command = Command(MOVE_COMMAND, parsePoint(tokens[1], tokens[2]), parsePoint(tokens[3], tokens[4]));
+        }
+        else if (isToken(tokens[0], "attack") && count == 5) {
+            command = Command(ATTACK_COMMAND, parsePoint(tokens[1], tokens[2]), parsePoint(tokens[3], tokens[4]));
+        }
+        else if (isToken(tokens[0], "reload") && count == 3) {
+            GridPoint coordinates = parsePoint(tokens[1], tokens[2]);
+            command = Command(RELOAD_COMMAND, coordinates, coordinates);
+        }
+        else {
+            throw IllegalArgument();
+        }
+
+        loadPendingUnits();
+        ++stats.actions;
+        stats.applied += (executeCommand(*game, command) == SUCCESS);
+    }
+
+    std::unique_ptr<Game> ScenarioParser::parse(std::istream& input)
+    {
+        ParseClock::time_point start = ParseClock::now();
+        stats = ScenarioStats();
+        pending_units.clear();
+        game.reset();
+
+        // the buffer holds the unfinished line of the previous chunk followed by the new chunk.
+        size_t carry = 0;
+        while (input)
+        {
+            input.read(buffer.data() + carry, std::streamsize(buffer.size() - carry));
+            size_t size = carry + size_t(input.gcount());
+            stats.bytes += size - carry;
+
+            const char* line = buffer.data();
+            const char* end = buffer.data() + size;
+            for (const char* newline; (newline = (const char*)std::memchr(line, '\n', size_t(end - line))) != nullptr;) {
+                ++stats.lines;
+                parseLine(line, newline);
+                line = newline + 1;
+            }
+
+            carry = size_t(end - line);
+            if (carry == buffer.size()) {
+                ++stats.lines;
+                throw IllegalArgument(); // a line longer than a chunk.
+            }
+            std::memmove(buffer.data(), line, carry);
+        }
+
+        if (carry > 0) {
+            ++stats.lines;
+            parseLine(buffer.data(), buffer.data() + carry);
+        }
+        if (!game) {
+            throw IllegalArgument();
+        }
+        loadPendingUnits();
+
+        stats.seconds = std::chrono::duration<double>(ParseClock::now() - start).count();
+        return std::move(game);
+    }
+
+    std::ostream& ScenarioParser::writeScenario(std::ostream& os, const Game& game)
+    {
+        os << "board " << game.getHeight() << ' ' << game.getWidth() << '\n';
+        game.forEachCharacter([&os](const GridPoint& coordinates, const Character& character) {
+            os << "unit " << coordinates.row << ' ' << coordinates.col << ' '
+               << (character.getType() == SOLDIER ? "soldier" : character.getType() == MEDIC ? "medic" : "sniper") << ' '
+               << (character.getTeam() == CROSSFITTERS ? "crossfitters" : "powerlifters") << ' '
+               << character.getHealth() << ' ' << character.getAmmo() << ' '
+               << character.getAttackRange() << ' ' << character.getPower() << '\n';
+        });
+        return os;
+    }
+
+    std::ostream& ScenarioParser::writeCommand(std::ostream& os, const Command& command)
+    {
+        static const char* const COMMAND_NAMES[] = {"move", "attack", "reload"};
+
+        os << COMMAND_NAMES[command.type] << ' ' << command.src.row << ' ' << command.src.col;
+        if (command.type != RELOAD_COMMAND) {
+            os << ' ' << command.dst.row << ' ' << command.dst.col;
+        }
+        return os << '\n';
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef SCENARIO_PARSER_H
+#define SCENARIO_PARSER_H
+
+#include "Game.h"
+#include "Command.h"
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * ScenarioStats - the measurements of a parse.
+     *
+     * applied is the number of actions that succeeded (a failed action is counted but does not stop the parse).
+     */
+    struct ScenarioStats
+    {
+        uint64_t bytes;
+        uint64_t lines;
+        uint64_t units;
+        uint64_t actions;
+        uint64_t applied;
+        double seconds;
+
+        /**
+         * getMegabytesPerSecond: the parse throughput, in 10^6 bytes per second.
+         */
+        double getMegabytesPerSecond() const;
+    };
+
+    /**
+     * ScenarioParser - a streaming parser of the scenario text format.
+     *
+     * Scenario format - one entry per line, blank lines and lines starting with '#' are ignored,
+     * tokens are separated by spaces or tabs:
+     *
+     *      board <height> <width>                                         - must be the first entry.
+     *      unit <row> <col> <type> <team> <health> <ammo> <range> <power> - type is soldier|medic|sniper,
+     *                                                                       team is powerlifters|crossfitters.
+     *      move <src row> <src col> <dst row> <dst col>
+     *      attack <src row> <src col> <dst row> <dst col>
+     *      reload <row> <col>
+     *
+     * for example:
+     *      board 4 5
+     *      unit 0 0 soldier powerlifters 10 2 4 5
+     *      unit 3 4 sniper crossfitters 8 3 5 2
+     *      move 0 0 1 0
+     *      attack 1 0 3 0
+     *
+     * The input is read in fixed-size chunks and the lines are tokenized in place, so parsing allocates
+     * nothing per line and the size of the input is not limited.
+     * Consecutive units are collected and loaded into the game at once (see Game::loadUnits) before the next
+     * action and at the end of the input; the actions are executed in order (see executeCommand).
+     */
+    class ScenarioParser
+    {
+        static const size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+        static const int MAX_TOKENS = 10;
+
+        struct Token
+        {
+            const char* begin;
+            const char* end;
+        };
+
+        std::vector<char> buffer;
+        std::vector<UnitDescriptor> pending_units;
+        std::unique_ptr<Game> game;
+        ScenarioStats stats;
+
+        public:
+            /**
+             * ScenarioParser constructor: creates a parser.
+             *
+             * @param chunk_size - the size in bytes of the reads. it is also the maximal length of a line.
+             *
+             * @throw
+             *     IllegalArgument - if the chunk size is 0.
+             */
+            explicit ScenarioParser(size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+            ScenarioParser(const ScenarioParser& other) = delete;
+            ScenarioParser& operator=(const ScenarioParser& other) = delete;
+
+            /**
+             * parse: reads a scenario and builds its game.
+             *
+             * @param input - the stream of the scenario.
+             *
+             * @throw
+             *     IllegalArgument - if a line is malformed, too long, or the scenario has no board entry.
+             *                       getStats().lines is the number of the malformed line.
+             *     every exception of the Game constructor and of Game::loadUnits, if the board or the units
+             *     are incorrect. getStats().lines is the number of the line that made the units load.
+             *
+             * @return
+             *     the game, after all the units were added and all the actions were executed.
+             */
+            std::unique_ptr<Game> parse(std::istream& input);
+
+            /**
+             * getStats: the measurements of the last parse (or of the lines parsed so far, if it failed).
+             */
+            const ScenarioStats& getStats() const;
+
+            /**
+             * writeScenario: writes a game in the scenario format (a board entry and a unit entry per character).
+             * NOTE: characters of registry types are written as the built-in type they are reported as,
+             *       and the sniper's attack counter is not written.
+             */
+            static std::ostream& writeScenario(std::ostream& os, const Game& game);
+
+            /**
+             * writeCommand: writes a command as an action entry.
+             */
+            static std::ostream& writeCommand(std::ostream& os, const Command& command);
+
+        private:
+            /**
+             * parseLine: parses a single line (without its end of line) and applies it to the game.
+             */
+            void parseLine(const char* begin, const char* end);
+
+            /**
+             * loadPendingUnits: loads the units collected so far into the game.
+             */
+            void loadPendingUnits();
+
+            static bool isToken(const Token& token, const char* word);
+            static int parseInt(const Token& token);
+            static CharacterType parseType(const Token& token);
+            static Team parseTeam(const Token& token);
+            static GridPoint parsePoint(const Token& row, const Token& col);
+    };
+}
+
+#endif
@@ -0,0 +1,327 @@
+#include "SharedSnapshot.h"
+
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mtm {
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "the seqlock needs address-free atomics");
+
+    static const uint64_t SNAPSHOT_MAGIC = 0x3150414e534d544dULL; // "MTMSNAP1", little endian.
+    static const size_t MAX_NAME_LENGTH = 200;
+    static const size_t CACHE_LINE_SIZE = 64;
+
+    /**
+     * SnapshotHeader, SnapshotSlot - the layout of a snapshot region (see SharedSnapshot.h).
+     * a slot is followed by its capacity of SnapshotUnits.
+     */
+    struct SnapshotHeader
+    {
+        uint64_t magic;
+        int32_t height;
+        int32_t width;
+        uint64_t capacity;
+        uint64_t slot_size;
+        std::atomic<uint64_t> latest;
+    };
+
+    struct SnapshotSlot
+    {
+        std::atomic<uint64_t> sequence;
+        uint64_t version;
+        uint64_t hash;
+        uint32_t units_count;
+        int32_t powerlifters;
+        int32_t crossfitters;
+        uint8_t is_over;
+        uint8_t winner;
+    };
+
+    /**
+     * alignSize: rounds a size up to a whole number of cache lines, so the header and the slots
+     * never share a line.
+     */
+    static size_t alignSize(size_t size)
+    {
+        return (size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+    }
+
+    static size_t getSlotSize(size_t capacity)
+    {
+        return alignSize(sizeof(SnapshotSlot) + capacity * sizeof(SnapshotUnit));
+    }
+
+    static size_t getRegionSize(size_t capacity)
+    {
+        return alignSize(sizeof(SnapshotHeader)) + 2 * getSlotSize(capacity);
+    }
+
+    /**
+     * getSlot, getUnits: the slot of a version in a region, and the units that follow a slot.
+     */
+    static SnapshotSlot* getSlot(unsigned char* region, uint64_t version)
+    {
+        const SnapshotHeader* header = reinterpret_cast<const SnapshotHeader*>(region);
+        return reinterpret_cast<SnapshotSlot*>(region + alignSize(sizeof(SnapshotHeader)) +
+                                               size_t(version % 2) * size_t((*header).slot_size));
+    }
+
+    static const SnapshotSlot* getSlot(const unsigned char* region, uint64_t version)
+    {
+        return getSlot(const_cast<unsigned char*>(region), version);
+    }
+
+    static SnapshotUnit* getUnits(SnapshotSlot* slot)
+    {
+        return reinterpret_cast<SnapshotUnit*>(reinterpret_cast<unsigned char*>(slot) + sizeof(SnapshotSlot));
+    }
+
+    static const SnapshotUnit* getUnits(const SnapshotSlot* slot)
+    {
+        return getUnits(const_cast<SnapshotSlot*>(slot));
+    }
+
+    static bool isValidName(const std::string& name)
+    {
+        return name.size() >= 2 && name.size() <= MAX_NAME_LENGTH + 1 && name[0] == '/' &&
+               name.find('/', 1) == std::string::npos;
+    }
+
+    GameSnapshot::GameSnapshot() :
+        version(0),
+        height(0),
+        width(0),
+        units(),
+        powerlifters(0),
+        crossfitters(0),
+        is_over(false),
+        winner(POWERLIFTERS),
+        hash(0)
+    {}
+
+    SnapshotPublisher::SnapshotPublisher(const std::string& name, int height, int width, size_t capacity) :
+        name(name),
+        height(height),
+        width(width),
+        capacity(capacity),
+        size(0),
+        region(nullptr)
+    {
+        if (!isValidName(name) || height <= 0 || width <= 0 || capacity == 0 ||
+            capacity > size_t(UINT32_MAX)) {
+            throw IllegalArgument();
+        }
+
+        // a previous region of the name is replaced: its readers keep the old mapping, new readers get this one.
+        shm_unlink(name.c_str());
+        int descriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (descriptor < 0) {
+            throw IllegalArgument();
+        }
+        size = getRegionSize(capacity);
+        void* mapping = MAP_FAILED;
+        if (ftruncate(descriptor, off_t(size)) == 0) {
+            mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        }
+        close(descriptor);
+        if (mapping == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            throw IllegalArgument();
+        }
+        region = static_cast<unsigned char*>(mapping);
+
+        SnapshotHeader* header = new (region) SnapshotHeader();
+        (*header).height = height;
+        (*header).width = width;
+        (*header).capacity = capacity;
+        (*header).slot_size = getSlotSize(capacity);
+        (*header).latest.store(0, std::memory_order_relaxed);
+        for (uint64_t index = 0; index < 2; ++index) {
+            SnapshotSlot* slot = new (getSlot(region, index)) SnapshotSlot();
+            (*slot).sequence.store(0, std::memory_order_relaxed);
+        }
+
+        // the magic is written last, so a reader never accepts a region that is not initialized yet.
+        std::atomic_thread_fence(std::memory_order_release);
+        (*header).magic = SNAPSHOT_MAGIC;
+    }
+
+    SnapshotPublisher::~SnapshotPublisher()
+    {
+        munmap(region, size);
+        shm_unlink(name.c_str());
+    }
+
+    uint64_t SnapshotPublisher::publish(const Game& game)
+    {
+        if (game.getHeight() != height || game.getWidth() != width) {
+            throw IllegalArgument();
+        }
+
+        SnapshotHeader* header = reinterpret_cast<SnapshotHeader*>(region);
+        uint64_t version = (*header).latest.load(std::memory_order_relaxed) + 1;
+        SnapshotSlot* slot = getSlot(region, version);
+        SnapshotUnit* units = getUnits(slot);
+
+        // the slot is not the latest one, so only a reader slower than a whole publish sees the odd sequence.
+        uint64_t sequence = (*slot).sequence.load(std::memory_order_relaxed);
+        (*slot).sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        size_t count = 0;
+        int powerlifters = 0;
+        int crossfitters = 0;
+        game.forEachCharacter([&](const GridPoint& coordinates, const Character& character) {
+            if (count < capacity) {
+                SnapshotUnit& unit = units[count];
+                unit.row = coordinates.row;
+                unit.col = coordinates.col;
+                unit.health = character.getHealth();
+                unit.ammo = character.getAmmo();
+                unit.range = character.getAttackRange();
+                unit.power = character.getPower();
+                unit.counter = character.getAttackCounter();
+                unit.team = uint8_t(character.getTeam());
+                unit.type = uint8_t(character.getType());
+                unit.reserved = 0;
+            }
+            ++count;
+            ++(character.getTeam() == POWERLIFTERS ? powerlifters : crossfitters);
+        });
+
+        Team winner = POWERLIFTERS;
+        bool is_over = game.isOver(&winner);
+        (*slot).version = count <= capacity ? version : 0; // a slot of version 0 is never accepted by a reader.
+        (*slot).hash = game.getHash();
+        (*slot).units_count = uint32_t(std::min(count, capacity));
+        (*slot).powerlifters = powerlifters;
+        (*slot).crossfitters = crossfitters;
+        (*slot).is_over = is_over;
+        (*slot).winner = uint8_t(winner);
+        (*slot).sequence.store(sequence + 2, std::memory_order_release);
+
+        if (count > capacity) {
+            throw IllegalArgument();
+        }
+        (*header).latest.store(version, std::memory_order_release);
+        return version;
+    }
+
+    uint64_t SnapshotPublisher::getVersion() const
+    {
+        return (*reinterpret_cast<const SnapshotHeader*>(region)).latest.load(std::memory_order_acquire);
+    }
+
+    size_t SnapshotPublisher::getCapacity() const
+    {
+        return capacity;
+    }
+
+    SnapshotReader::SnapshotReader(const std::string& name) :
+        size(0),
+        region(nullptr)
+    {
+        if (!isValidName(name)) {
+            throw IllegalArgument();
+        }
+        int descriptor = shm_open(name.c_str(), O_RDONLY, 0);
+        if (descriptor < 0) {
+            throw IllegalArgument();
+        }
+        struct stat status;
+        void* mapping = MAP_FAILED;
+        if (fstat(descriptor, &status) == 0 && size_t(status.st_size) >= alignSize(sizeof(SnapshotHeader))) {
+            size = size_t(status.st_size);
+            mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0);
+        }
+        close(descriptor);
+        if (mapping == MAP_FAILED) {
+            throw IllegalArgument();
+        }
+        region = static_cast<const unsigned char*>(mapping);
+
+        const SnapshotHeader* header = reinterpret_cast<const SnapshotHeader*>(region);
+        bool is_valid = (*header).magic == SNAPSHOT_MAGIC;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        is_valid = is_valid && (*header).capacity > 0 && (*header).capacity <= uint64_t(UINT32_MAX) &&
+                   (*header).slot_size == getSlotSize(size_t((*header).capacity)) &&
+                   size >= getRegionSize(size_t((*header).capacity));
+        if (!is_valid) {
+            munmap(const_cast<unsigned char*>(region), size);
+            throw IllegalArgument();
+        }
+    }
+
+    SnapshotReader::~SnapshotReader()
+    {
+        munmap(const_cast<unsigned char*>(region), size);
+    }
+
+    bool SnapshotReader::read(GameSnapshot& snapshot, int max_retries) const
+    {
+        const SnapshotHeader* header = reinterpret_cast<const SnapshotHeader*>(region);
+        size_t capacity = size_t((*header).capacity);
+        std::vector<SnapshotUnit> units;
+
+        for (int attempt = 0; attempt <= max_retries; ++attempt) {
+            uint64_t version = (*header).latest.load(std::memory_order_acquire);
+            if (version == 0) {
+                return false;
+            }
+            const SnapshotSlot* slot = getSlot(region, version);
+            uint64_t sequence = (*slot).sequence.load(std::memory_order_acquire);
+            if (sequence % 2 != 0) {
+                continue; // the publisher has gone around both slots and writes this one again.
+            }
+
+            uint64_t slot_version = (*slot).version;
+            uint64_t hash = (*slot).hash;
+            size_t count = std::min(size_t((*slot).units_count), capacity);
+            int powerlifters = (*slot).powerlifters;
+            int crossfitters = (*slot).crossfitters;
+            bool is_over = (*slot).is_over != 0;
+            Team winner = Team((*slot).winner);
+            const SnapshotUnit* slot_units = getUnits(slot);
+            units.assign(slot_units, slot_units + count);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((*slot).sequence.load(std::memory_order_relaxed) != sequence || slot_version != version) {
+                continue;
+            }
+
+            snapshot.version = version;
+            snapshot.height = (*header).height;
+            snapshot.width = (*header).width;
+            snapshot.units.swap(units);
+            snapshot.powerlifters = powerlifters;
+            snapshot.crossfitters = crossfitters;
+            snapshot.is_over = is_over;
+            snapshot.winner = winner;
+            snapshot.hash = hash;
+            return true;
+        }
+        return false;
+    }
+
+    uint64_t SnapshotReader::getVersion() const
+    {
+        return (*reinterpret_cast<const SnapshotHeader*>(region)).latest.load(std::memory_order_acquire);
+    }
+
+    int SnapshotReader::getHeight() const
+    {
+        return (*reinterpret_cast<const SnapshotHeader*>(region)).height;
+    }
+
+    int SnapshotReader::getWidth() const
+    {
+        return (*reinterpret_cast<const SnapshotHeader*>(region)).width;
+    }
+}
@@ -0,0 +1,186 @@
+#ifndef SHARED_SNAPSHOT_H
+#define SHARED_SNAPSHOT_H
+
+#include "Game.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * SnapshotUnit - a character of a published game, as laid out in the shared memory.
+     */
+    struct SnapshotUnit
+    {
+        int32_t row;
+        int32_t col;
+        int32_t health;
+        int32_t ammo;
+        int32_t range;
+        int32_t power;
+        int32_t counter; // the hits counter of the character's cadence (see Character::getAttackCounter).
+        uint8_t team;
+        uint8_t type;
+        uint16_t reserved;
+    };
+
+    /**
+     * GameSnapshot - a consistent copy of a published game.
+     *
+     * version      - the number of the publish the snapshot was taken from, starting at 1.
+     * units        - the characters of the board, in the board's order (row by row).
+     * powerlifters,
+     * crossfitters - the number of characters of every team.
+     * is_over      - the result of Game::isOver, and winner its winning team (meaningful only if is_over).
+     * hash         - the game's Zobrist hash (see Game::getHash).
+     */
+    struct GameSnapshot
+    {
+        uint64_t version;
+        int height;
+        int width;
+        std::vector<SnapshotUnit> units;
+        int powerlifters;
+        int crossfitters;
+        bool is_over;
+        Team winner;
+        uint64_t hash;
+
+        GameSnapshot();
+    };
+
+    /**
+     * SnapshotPublisher - publishes the state of a game into a named shared-memory region (see shm_open),
+     * to be read by other processes (spectators, analytics, recorders) without slowing down the game thread.
+     *
+     * The region holds a header and two slots of a fixed capacity of units. Every publish writes the inactive
+     * slot under its seqlock - the slot's sequence is odd while it is written - and then makes it the latest.
+     * The writer never waits for the readers, and a publish costs the game's characters (at most the capacity),
+     * never the board's size. A reader copies the latest slot and retries if its sequence was odd or changed
+     * meanwhile, so it gets a consistent view without locks, and being double buffered, a reader is disturbed
+     * only if it is slower than a whole publish.
+     *
+     * Layout (native byte order, the processes share a machine):
+     *      header: uint64 magic "MTMSNAP1", int32 height, int32 width, uint64 capacity, uint64 slot size,
+     *              atomic uint64 latest version (0 before the first publish; the slot of version n is n % 2).
+     *      slot:   atomic uint64 sequence, uint64 version, uint64 hash, uint32 units count, int32 powerlifters,
+     *              int32 crossfitters, uint8 is over, uint8 winner, padding, then capacity SnapshotUnits.
+     *
+     * NOTE: POSIX only (shm_open, mmap). a single thread must publish; any number of processes may read.
+     */
+    class SnapshotPublisher
+    {
+        std::string name;
+        int height;
+        int width;
+        size_t capacity;
+        size_t size;
+        unsigned char* region;
+
+        public:
+            SnapshotPublisher() = delete;
+
+            /**
+             * SnapshotPublisher constructor: creates (or replaces) the shared-memory region of a name.
+             *
+             * @param name     - the region's name: a '/' followed by up to 200 characters other than '/'.
+             * @param height   - the height of the published games.
+             * @param width    - the width of the published games.
+             * @param capacity - the maximal number of characters of a published game.
+             *
+             * @throw
+             *     IllegalArgument - if the name is incorrect, the dimensions are not positive, the capacity is 0,
+             *                       or the region can't be created.
+             */
+            SnapshotPublisher(const std::string& name, int height, int width, size_t capacity);
+
+            SnapshotPublisher(const SnapshotPublisher& other) = delete;
+            SnapshotPublisher& operator=(const SnapshotPublisher& other) = delete;
+
+            /**
+             * SnapshotPublisher destructor: unmaps and removes the region. mapped readers keep their view.
+             */
+            ~SnapshotPublisher();
+
+            /**
+             * publish: writes the state of a game as the latest snapshot.
+             *
+             * @param game - the game to publish, of the publisher's dimensions.
+             *
+             * @throw
+             *     IllegalArgument - if the game's dimensions differ, or it has more characters than the capacity.
+             *                       nothing is published then.
+             *
+             * @return
+             *     the version of the published snapshot.
+             */
+            uint64_t publish(const Game& game);
+
+            /**
+             * getVersion: the version of the latest publish, 0 if nothing was published.
+             */
+            uint64_t getVersion() const;
+
+            /**
+             * getCapacity: the maximal number of characters of a published game.
+             */
+            size_t getCapacity() const;
+    };
+
+    /**
+     * SnapshotReader - reads the snapshots of a SnapshotPublisher, in another process or in the same one.
+     * The region is mapped read only, so a reader can't disturb the publisher or the other readers.
+     */
+    class SnapshotReader
+    {
+        size_t size;
+        const unsigned char* region;
+
+        public:
+            SnapshotReader() = delete;
+
+            /**
+             * SnapshotReader constructor: maps the region of a publisher.
+             *
+             * @param name - the name of the publisher's region.
+             *
+             * @throw
+             *     IllegalArgument - if the region does not exist or is not a snapshot region.
+             */
+            explicit SnapshotReader(const std::string& name);
+
+            SnapshotReader(const SnapshotReader& other) = delete;
+            SnapshotReader& operator=(const SnapshotReader& other) = delete;
+
+            ~SnapshotReader();
+
+            /**
+             * read: copies the latest snapshot.
+             *
+             * @param snapshot    - the result keeper. its previous content is replaced only on success.
+             * @param max_retries - the number of times a copy disturbed by the publisher is retried.
+             *
+             * @return
+             *     true on success, false if nothing was published yet or every retry was disturbed.
+             */
+            bool read(GameSnapshot& snapshot, int max_retries = 64) const;
+
+            /**
+             * getVersion: the version of the latest publish, 0 if nothing was published.
+             *             a cheap way to poll for changes before reading.
+             */
+            uint64_t getVersion() const;
+
+            /**
+             * getHeight, getWidth: the dimensions of the published games.
+             */
+            int getHeight() const;
+            int getWidth() const;
+    };
+}
+
+#endif
@@ -13,6 +13,16 @@ namespace mtm {
         return new Sniper(*this);
     }
 
+    std::shared_ptr<Character> Sniper::cloneShared(const TrackingAllocator<Character>& allocator) const
+    {
+        return std::allocate_shared<Sniper>(allocator, *this);
+    }
+
+    size_t Sniper::getObjectSize() const
+    {
+        return sizeof(Sniper);
+    }
+
     bool Sniper::canAttackEmptyCell()
     {
         return false;
@@ -24,18 +34,33 @@ namespace mtm {
         return (distance <= range && distance >= std::ceil(range * MINIMAL_RANGE_FACTOR));
     }
 
-    bool Sniper::attack(Character& other)
+    bool Sniper::isLegalTarget(const Character* other) const
+    {
+        return (other != nullptr && team != other->getTeam());
+    }
+
+    int Sniper::getAttackCounter() const
+    {
+        return number_of_attacks;
+    }
+
+    void Sniper::setAttackCounter(int counter)
+    {
+        number_of_attacks = counter;
+    }
+
+    bool Sniper::attack(Character* other)
     {
-        if (!Character::exists(other) || team == other.getTeam()) {
+        if (!isLegalTarget(other)) {
             return false;
         }
         
         if (number_of_attacks == NUM_OF_ATTACKS_UNTIL_DOUBLE_DAMAGE) {
-            other.addHealth(-power * INCREASED_ATTACK_FACTOR);
+            (*other).addHealth(-power * INCREASED_ATTACK_FACTOR);
             number_of_attacks = 1;
         }
         else {
-            other.addHealth(-power);
+            (*other).addHealth(-power);
             ++number_of_attacks;
         }
         
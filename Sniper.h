@@ -7,17 +7,17 @@ namespace mtm {
 
     class Sniper : public Character
     {
-        static const char SNIPER_SYMBOL = 'N';
-        static const units_t SNIPER_RELOAD_VALUE = 2;
-        static const units_t SNIPER_ATTACK_COST = 1;
-        static const int SNIPER_MAX_MOVEMENT_UNITS = 4; 
-        static const int INCREASED_ATTACK_FACTOR = 2;
-        static const int NUM_OF_ATTACKS_UNTIL_DOUBLE_DAMAGE = 3;
-        static constexpr double MINIMAL_RANGE_FACTOR = 1.0 / 2; 
-
         int number_of_attacks;
 
         public: 
+            static const char SNIPER_SYMBOL = 'N';
+            static const units_t SNIPER_RELOAD_VALUE = 2;
+            static const units_t SNIPER_ATTACK_COST = 1;
+            static const int SNIPER_MAX_MOVEMENT_UNITS = 4; 
+            static const int INCREASED_ATTACK_FACTOR = 2;
+            static const int NUM_OF_ATTACKS_UNTIL_DOUBLE_DAMAGE = 3;
+            static constexpr double MINIMAL_RANGE_FACTOR = 1.0 / 2; 
+
             Sniper() = delete;
 
             /**
@@ -42,6 +42,22 @@ namespace mtm {
             *        a pointer to the new created character.
             */
             Character* clone() override;
+
+            /**
+            * cloneShared: create a clone of the current sniper and its control block in a single allocation.
+            *
+            * @param allocator - the allocator of the clone.
+            *
+            * @return
+            *     a shared pointer to the new created character.
+            */
+            std::shared_ptr<Character> cloneShared(const TrackingAllocator<Character>& allocator) const override;
+
+            /**
+            * getObjectSize: the size of the current sniper's object.
+            * NOTE: overrides the "getObjectSize" method of class 'character'.
+            */
+            size_t getObjectSize() const override;
             
             /** 
             * attack: gets a reference to a slot on the board
@@ -54,7 +70,7 @@ namespace mtm {
             *         false if trying to attack the current sniper,character from the same team, or an empty cell, 
             *         true if the attack was successful.
             */
-            bool attack(Character& other) override;
+            bool attack(Character* other) override;
 
             /** 
             * canAttackEmptyCell: sniper can't attack an empty cell, therefore this method returns false.
@@ -70,6 +86,25 @@ namespace mtm {
             * NOTE: overrides the "isInAttackRange" method of class 'character'.
             */
             bool isInAttackRange(const GridPoint& src, const GridPoint& dst) override;
+
+            /** 
+            * isLegalTarget: a sniper can attack only characters of the other team.
+            *
+            * NOTE: overrides the "isLegalTarget" method of class 'character'.
+            */
+            bool isLegalTarget(const Character* other) const override;
+
+            /** 
+            * getAttackCounter: returns the number of the next attack in the current round of 3 attacks.
+            * NOTE: overrides the "getAttackCounter" method of class 'character'.
+            */
+            int getAttackCounter() const override;
+
+            /** 
+            * setAttackCounter: overwrites the number of the next attack in the current round of 3 attacks.
+            * NOTE: overrides the "setAttackCounter" method of class 'character'.
+            */
+            void setAttackCounter(int counter) override;
     };
 }
 
@@ -12,6 +12,16 @@ namespace mtm {
         return new Soldier(*this);
     }
 
+    std::shared_ptr<Character> Soldier::cloneShared(const TrackingAllocator<Character>& allocator) const
+    {
+        return std::allocate_shared<Soldier>(allocator, *this);
+    }
+
+    size_t Soldier::getObjectSize() const
+    {
+        return sizeof(Soldier);
+    }
+
     bool Soldier::canAttackEmptyCell()
     {
         return true;
@@ -27,15 +37,25 @@ namespace mtm {
         return (src.col == dst.col || src.row == dst.row);
     }
 
-    bool Soldier::attack(Character& other)
+    bool Soldier::isLegalTarget(const Character*) const
     {
-        if(Character::exists(other) && team != other.getTeam()) {
-            other.addHealth(-power);
+        return true;
+    }
+
+    bool Soldier::attack(Character* other)
+    {
+        if(other != nullptr && team != (*other).getTeam()) {
+            (*other).addHealth(-power);
         }
         --ammo;
         return true;
     }
 
+    int Soldier::getSplashRadius() const
+    {
+        return int(std::ceil(range * NEARBY_DISTANCE_FACTOR));
+    }
+
     void Soldier::attackNearbyCharacter(Character& other) const
     {
         if(team == other.getTeam()) {
@@ -7,14 +7,15 @@ namespace mtm {
 
     class Soldier : public Character
     {
-        static const char SOLDIER_SYMBOL = 'S';
-        static const units_t SOLDIER_RELOAD_VALUE = 3;
-        static const units_t SOLDIER_ATTACK_COST = 1; 
-        static const int SOLDIER_MAX_MOVEMENT_UNITS = 3;
+        public:
+            static const char SOLDIER_SYMBOL = 'S';
+            static const units_t SOLDIER_RELOAD_VALUE = 3;
+            static const units_t SOLDIER_ATTACK_COST = 1; 
+            static const int SOLDIER_MAX_MOVEMENT_UNITS = 3;
 
-        static constexpr double NEARBY_DAMAGE_FACTOR = 1.0 / 2;
+            static constexpr double NEARBY_DISTANCE_FACTOR = 1.0 / 3;
+            static constexpr double NEARBY_DAMAGE_FACTOR = 1.0 / 2;
 
-        public:
             Soldier() = delete;
 
             /**
@@ -40,6 +41,22 @@ namespace mtm {
             */            
             Character* clone() override;
 
+            /**
+            * cloneShared: create a clone of the current soldier and its control block in a single allocation.
+            *
+            * @param allocator - the allocator of the clone.
+            *
+            * @return
+            *     a shared pointer to the new created character.
+            */
+            std::shared_ptr<Character> cloneShared(const TrackingAllocator<Character>& allocator) const override;
+
+            /**
+            * getObjectSize: the size of the current soldier's object.
+            * NOTE: overrides the "getObjectSize" method of class 'character'.
+            */
+            size_t getObjectSize() const override;
+
             /** 
             * attack: gets a reference to a slot on the board,
             *         if the character is in a differend team, the character's health units will be decreased.
@@ -50,7 +67,7 @@ namespace mtm {
             * @return
             *       true anyway. there is no reason for the attack to fail.
             */
-            bool attack(Character& other) override;
+            bool attack(Character* other) override;
             
             /** 
             * attackNearbyCharacter: attack all the enemy's characters that are nearby to attacked cell
@@ -59,6 +76,12 @@ namespace mtm {
             *
             */
             void attackNearbyCharacter(Character& other) const override;
+
+            /** 
+            * getSplashRadius: the soldier's splash radius is ceil(range * NEARBY_DISTANCE_FACTOR).
+            * NOTE: overrides the "getSplashRadius" method of class 'character'.
+            */
+            int getSplashRadius() const override;
             
             /** 
             * canAttackEmptyCell: soldier can attack an empty cell, therefore this method returns true.
@@ -91,7 +114,13 @@ namespace mtm {
             */
             bool isInAttackRange2(const GridPoint& src, const GridPoint& dst) override;
 
-            static constexpr double NEARBY_DISTANCE_FACTOR = 1.0 / 3;
+            /** 
+            * isLegalTarget: a soldier can attack any cell, even an empty one or a teammate (which takes no damage).
+            *
+            * @return
+            *       true
+            */
+            bool isLegalTarget(const Character* other) const override;
     };
 }
 
@@ -0,0 +1,133 @@
+#include "TensorEncoder.h"
+
+#include "Exceptions.h"
+
+#include <algorithm>
+
+namespace mtm {
+
+    TensorScale::TensorScale() :
+        health(10),
+        ammo(5),
+        range(6),
+        power(5),
+        counter(3)
+    {}
+
+    /**
+     * normalize: maps a stat to [0, 1], 1 being the stat's scale.
+     */
+    static float normalize(units_t value, float scale)
+    {
+        return std::min(std::max(float(value) / scale, 0.0f), 1.0f);
+    }
+
+    /**
+     * store: writes a normalized value into a cell of a plane, as a float or as a byte.
+     */
+    static void store(float* cell, float value)
+    {
+        *cell = value;
+    }
+
+    static void store(uint8_t* cell, float value)
+    {
+        *cell = uint8_t(value * 255.0f + 0.5f);
+    }
+
+    TensorEncoder::TensorEncoder(const TensorScale& scale) :
+        scale(scale)
+    {
+        if (!(scale.health > 0 && scale.ammo > 0 && scale.range > 0 && scale.power > 0 && scale.counter > 0)) {
+            throw IllegalArgument();
+        }
+    }
+
+    size_t TensorEncoder::getBoardSize(int height, int width)
+    {
+        return size_t(TENSOR_CHANNELS_COUNT) * size_t(height) * size_t(width);
+    }
+
+    void TensorEncoder::encode(const Game& game, float* output) const
+    {
+        encodeBoard(game, output);
+    }
+
+    void TensorEncoder::encode(const Game& game, uint8_t* output) const
+    {
+        encodeBoard(game, output);
+    }
+
+    void TensorEncoder::encodeBatch(const std::vector<const Game*>& games, float* output, ThreadPool& pool) const
+    {
+        encodeGames(games, output, pool);
+    }
+
+    void TensorEncoder::encodeBatch(const std::vector<const Game*>& games, uint8_t* output, ThreadPool& pool) const
+    {
+        encodeGames(games, output, pool);
+    }
+
+    template <class Value>
+    void TensorEncoder::encodeBoard(const Game& game, Value* output) const
+    {
+        if (output == nullptr) {
+            throw IllegalArgument();
+        }
+
+        size_t width = size_t(game.getWidth());
+        size_t plane = size_t(game.getHeight()) * width;
+        std::fill(output, output + TENSOR_CHANNELS_COUNT * plane, Value(0));
+
+        game.forEachCharacter([&](const GridPoint& coordinates, const Character& character) {
+            Value* cell = output + size_t(coordinates.row) * width + size_t(coordinates.col);
+            store(cell + plane * (character.getTeam() == POWERLIFTERS ? POWERLIFTERS_CHANNEL : CROSSFITTERS_CHANNEL), 1);
+
+            // the types a registry defines beyond the built-in ones (see UnitTypeRegistry.h) have no type channel.
+            switch (character.getTypeId())
+            {
+                case SOLDIER: store(cell + plane * SOLDIER_CHANNEL, 1); break;
+                case MEDIC:   store(cell + plane * MEDIC_CHANNEL, 1); break;
+                case SNIPER:  store(cell + plane * SNIPER_CHANNEL, 1); break;
+                default: break;
+            }
+
+            store(cell + plane * HEALTH_CHANNEL, normalize(character.getHealth(), scale.health));
+            store(cell + plane * AMMO_CHANNEL, normalize(character.getAmmo(), scale.ammo));
+            store(cell + plane * RANGE_CHANNEL, normalize(character.getAttackRange(), scale.range));
+            store(cell + plane * POWER_CHANNEL, normalize(character.getPower(), scale.power));
+            store(cell + plane * COUNTER_CHANNEL, normalize(character.getAttackCounter(), scale.counter));
+        });
+    }
+
+    template <class Value>
+    void TensorEncoder::encodeGames(const std::vector<const Game*>& games, Value* output, ThreadPool& pool) const
+    {
+        if (output == nullptr) {
+            throw IllegalArgument();
+        }
+        if (games.empty()) {
+            return;
+        }
+        for (const Game* game : games) {
+            if (game == nullptr || (*game).getHeight() != (*games[0]).getHeight() ||
+                (*game).getWidth() != (*games[0]).getWidth()) {
+                throw IllegalArgument();
+            }
+        }
+
+        // every worker encodes a contiguous range of boards, so the threads write to distinct parts of the batch.
+        size_t board_size = getBoardSize((*games[0]).getHeight(), (*games[0]).getWidth());
+        size_t range_size = (games.size() + pool.getSize() - 1) / pool.getSize();
+        for (unsigned int worker = 0; size_t(worker) * range_size < games.size(); ++worker) {
+            size_t begin = size_t(worker) * range_size;
+            size_t end = std::min(begin + range_size, games.size());
+            pool.submit(worker, [this, &games, output, board_size, begin, end]() {
+                for (size_t index = begin; index < end; ++index) {
+                    encodeBoard(*games[index], output + index * board_size);
+                }
+            });
+        }
+        pool.wait();
+    }
+}
@@ -0,0 +1,120 @@
+#ifndef TENSOR_ENCODER_H
+#define TENSOR_ENCODER_H
+
+#include "Game.h"
+#include "ThreadPool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * TensorChannel - the feature planes of an encoded board, in their order in the tensor:
+     *      POWERLIFTERS_CHANNEL, CROSSFITTERS_CHANNEL - the cells of every team's characters (1 or 0).
+     *      SOLDIER_CHANNEL ... SNIPER_CHANNEL         - the one-hot type of the cell's character (see
+     *                                                   Character::getTypeId). 0 in all three for a registry's
+     *                                                   own types.
+     *      HEALTH_CHANNEL ... POWER_CHANNEL           - the stats of the cell's character, normalized (see TensorScale).
+     *      COUNTER_CHANNEL                            - the hits counter of the character's cadence (the sniper's),
+     *                                                   normalized.
+     */
+    enum TensorChannel
+    {
+        POWERLIFTERS_CHANNEL,
+        CROSSFITTERS_CHANNEL,
+        SOLDIER_CHANNEL,
+        MEDIC_CHANNEL,
+        SNIPER_CHANNEL,
+        HEALTH_CHANNEL,
+        AMMO_CHANNEL,
+        RANGE_CHANNEL,
+        POWER_CHANNEL,
+        COUNTER_CHANNEL,
+        TENSOR_CHANNELS_COUNT
+    };
+
+    /**
+     * TensorScale - the values that map to 1 in the stat channels. larger values are clamped to 1.
+     */
+    struct TensorScale
+    {
+        float health;
+        float ammo;
+        float range;
+        float power;
+        float counter;
+
+        /**
+         * TensorScale constructor: creates the scale of the default generated scenarios (see ScenarioConfig):
+         * health 10, ammo 5, range 6, power 5, and the sniper's cadence of 3 hits.
+         */
+        TensorScale();
+    };
+
+    /**
+     * TensorEncoder - writes games into caller-provided feature planes, for training policy networks.
+     *
+     * A board of height H and width W is written as TENSOR_CHANNELS_COUNT planes of H x W values (CHW),
+     * and a batch of N boards of the same dimensions as N consecutive boards (NCHW), as floats in [0, 1]
+     * or as bytes in [0, 255] (the float value, scaled and rounded).
+     * The planes are cleared and then only the characters' cells are written, so a board costs its size
+     * plus its characters, and a batch is split among the threads of a pool in contiguous ranges of boards.
+     */
+    class TensorEncoder
+    {
+        TensorScale scale;
+
+        public:
+            /**
+             * TensorEncoder constructor: creates an encoder with the given scale.
+             *
+             * @throw
+             *     IllegalArgument - if one of the scale's values is not positive.
+             */
+            explicit TensorEncoder(const TensorScale& scale = TensorScale());
+
+            /**
+             * getBoardSize: the number of values of an encoded board of the given dimensions (C * H * W).
+             */
+            static size_t getBoardSize(int height, int width);
+
+            /**
+             * encode: writes a game into getBoardSize(height, width) values.
+             *
+             * @param game   - the game to encode.
+             * @param output - the first value of the board. must hold getBoardSize values.
+             *
+             * @throw
+             *     IllegalArgument - if the output is nullptr.
+             */
+            void encode(const Game& game, float* output) const;
+            void encode(const Game& game, uint8_t* output) const;
+
+            /**
+             * encodeBatch: writes many games of the same dimensions into a contiguous batch, in parallel.
+             *
+             * @param games  - the games to encode, in their order in the batch.
+             * @param output - the first value of the batch. must hold games.size() * getBoardSize values.
+             * @param pool   - the threads to encode with.
+             *
+             * @throw
+             *     IllegalArgument - if the output or one of the games is nullptr, or the games' dimensions differ.
+             */
+            void encodeBatch(const std::vector<const Game*>& games, float* output, ThreadPool& pool) const;
+            void encodeBatch(const std::vector<const Game*>& games, uint8_t* output, ThreadPool& pool) const;
+
+        private:
+            /**
+             * encodeBoard, encodeGames: the implementations of encode and encodeBatch, for every value type.
+             */
+            template <class Value>
+            void encodeBoard(const Game& game, Value* output) const;
+
+            template <class Value>
+            void encodeGames(const std::vector<const Game*>& games, Value* output, ThreadPool& pool) const;
+    };
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include "ThreadPool.h"
+
+namespace mtm {
+
+    ThreadPool::Worker::Worker() :
+        stopping(false)
+    {}
+
+    ThreadPool::ThreadPool(unsigned int size) :
+        pending(0),
+        next_worker(0)
+    {
+        if (size == 0) {
+            size = std::thread::hardware_concurrency();
+        }
+        if (size == 0) {
+            size = 1;
+        }
+
+        for (unsigned int i = 0; i < size; ++i) {
+            workers.emplace_back(new Worker());
+        }
+        for (std::unique_ptr<Worker>& worker : workers) {
+            Worker* raw_worker = worker.get();
+            worker->thread = std::thread([this, raw_worker]() { run(*raw_worker); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        for (std::unique_ptr<Worker>& worker : workers) {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->stopping = true;
+            worker->wakeup.notify_one();
+        }
+        for (std::unique_ptr<Worker>& worker : workers) {
+            worker->thread.join();
+        }
+    }
+
+    unsigned int ThreadPool::getSize() const
+    {
+        return (unsigned int)workers.size();
+    }
+
+    void ThreadPool::submit(unsigned int worker, std::function<void()> task)
+    {
+        Worker& target = *workers[worker % workers.size()];
+        ++pending;
+        {
+            std::lock_guard<std::mutex> lock(target.mutex);
+            target.tasks.push_back(std::move(task));
+        }
+        target.wakeup.notify_one();
+    }
+
+    void ThreadPool::submit(std::function<void()> task)
+    {
+        submit(next_worker++, std::move(task));
+    }
+
+    void ThreadPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(idle_mutex);
+        idle.wait(lock, [this]() { return pending == 0; });
+    }
+
+    void ThreadPool::run(Worker& worker)
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(worker.mutex);
+                worker.wakeup.wait(lock, [&worker]() { return worker.stopping || !worker.tasks.empty(); });
+                if (worker.tasks.empty()) {
+                    return; // stopping, and nothing is left to run.
+                }
+                task = std::move(worker.tasks.front());
+                worker.tasks.pop_front();
+            }
+
+            task();
+
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> lock(idle_mutex);
+                idle.notify_all();
+            }
+        }
+    }
+}
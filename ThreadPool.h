@@ -0,0 +1,90 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * ThreadPool - a fixed set of worker threads, each with its own task queue.
+     *
+     * Tasks may be sent to a specific worker, which lets callers shard state across workers
+     * (a state that is only touched by its own worker needs no locking).
+     * Tasks must not throw.
+     */
+    class ThreadPool
+    {
+        struct Worker
+        {
+            std::mutex mutex;
+            std::condition_variable wakeup;
+            std::deque<std::function<void()>> tasks;
+            bool stopping;
+            std::thread thread;
+
+            Worker();
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic<size_t> pending;
+        std::atomic<unsigned int> next_worker;
+        std::mutex idle_mutex;
+        std::condition_variable idle;
+
+        public:
+            /**
+             * ThreadPool constructor: starts the worker threads.
+             *
+             * @param size - the number of workers. 0 means one worker per hardware thread.
+             */
+            explicit ThreadPool(unsigned int size = 0);
+
+            ThreadPool(const ThreadPool& other) = delete;
+            ThreadPool& operator=(const ThreadPool& other) = delete;
+
+            /**
+             * ThreadPool destructor: runs the remaining tasks and joins all the workers.
+             */
+            ~ThreadPool();
+
+            /**
+             * getSize: the number of workers in the pool.
+             */
+            unsigned int getSize() const;
+
+            /**
+             * submit: queues a task on a specific worker.
+             *
+             * @param worker - the index of the worker. taken modulo the pool's size.
+             * @param task   - the task to run.
+             */
+            void submit(unsigned int worker, std::function<void()> task);
+
+            /**
+             * submit: queues a task on the workers in a round robin order.
+             *
+             * @param task - the task to run.
+             */
+            void submit(std::function<void()> task);
+
+            /**
+             * wait: blocks until every submitted task has finished.
+             */
+            void wait();
+
+        private:
+            /**
+             * run: the loop of a worker thread.
+             */
+            void run(Worker& worker);
+    };
+}
+
+#endif
@@ -0,0 +1,74 @@
+#include "TranspositionTable.h"
+
+namespace mtm {
+
+    TranspositionTable::TranspositionTable(int size_log2) :
+        mask((size_t(1) << (size_log2 < 1 ? 1 : size_log2 > 40 ? 40 : size_log2)) - 1),
+        slots(new Slot[mask + 1])
+    {
+        clear();
+    }
+
+    // data layout: score (bits 0-31), depth (32-39), bound (40-41), best_move + 1 (48-63).
+    // an empty slot has bound NO_BOUND, so it never matches a key.
+    uint64_t TranspositionTable::pack(const TranspositionEntry& entry)
+    {
+        return uint64_t(uint32_t(entry.score)) |
+               uint64_t(uint8_t(entry.depth)) << 32 |
+               uint64_t(entry.bound & 3) << 40 |
+               uint64_t(uint16_t(entry.best_move + 1)) << 48;
+    }
+
+    TranspositionEntry TranspositionTable::unpack(uint64_t data)
+    {
+        TranspositionEntry entry;
+        entry.score = int(int32_t(uint32_t(data)));
+        entry.depth = int((data >> 32) & 0xFF);
+        entry.bound = Bound((data >> 40) & 3);
+        entry.best_move = int((data >> 48) & 0xFFFF) - 1;
+        return entry;
+    }
+
+    bool TranspositionTable::probe(uint64_t key, TranspositionEntry& entry) const
+    {
+        const Slot& slot = slots[key & mask];
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if ((check ^ data) != key) {
+            return false;
+        }
+
+        TranspositionEntry result = unpack(data);
+        if (result.bound == NO_BOUND) {
+            return false;
+        }
+        entry = result;
+        return true;
+    }
+
+    void TranspositionTable::store(uint64_t key, const TranspositionEntry& entry)
+    {
+        Slot& slot = slots[key & mask];
+        TranspositionEntry old_entry;
+        if (probe(key, old_entry) && old_entry.depth > entry.depth) {
+            return;
+        }
+
+        uint64_t data = pack(entry);
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
+    }
+
+    void TranspositionTable::clear()
+    {
+        for (size_t index = 0; index <= mask; ++index) {
+            slots[index].check.store(0, std::memory_order_relaxed);
+            slots[index].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    size_t TranspositionTable::getSize() const
+    {
+        return mask + 1;
+    }
+}
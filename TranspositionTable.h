@@ -0,0 +1,97 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace mtm {
+
+    /**
+     * Bound - how a stored score relates to the real score of a position.
+     */
+    enum Bound { NO_BOUND, EXACT_BOUND, LOWER_BOUND, UPPER_BOUND };
+
+    /**
+     * TranspositionEntry - the result of a previous search of a position.
+     *
+     * best_move is the index of the best move in the position's move list, or -1 if it is unknown.
+     */
+    struct TranspositionEntry
+    {
+        int score;
+        int depth;
+        Bound bound;
+        int best_move;
+    };
+
+    /**
+     * TranspositionTable - a fixed-size, lock-free hash table of searched positions,
+     * shared between search threads.
+     *
+     * Every slot holds two 64-bit words: the packed entry and the position's key XOR-ed with it.
+     * The words are written and read with relaxed atomics and no lock, so a slot torn by two concurrent
+     * writers does not pass the key check on probe and is simply a miss (the "lockless hashing" scheme).
+     * A store always replaces the slot's content: deeper results are preferred only within the same position.
+     */
+    class TranspositionTable
+    {
+        struct Slot
+        {
+            std::atomic<uint64_t> check;
+            std::atomic<uint64_t> data;
+        };
+
+        size_t mask;
+        std::unique_ptr<Slot[]> slots;
+
+        public:
+            TranspositionTable() = delete;
+            TranspositionTable(const TranspositionTable& other) = delete;
+            TranspositionTable& operator=(const TranspositionTable& other) = delete;
+
+            /**
+             * TranspositionTable constructor: creates an empty table.
+             *
+             * @param size_log2 - the table holds 2^size_log2 entries (16 bytes each). clamped to [1, 40].
+             */
+            explicit TranspositionTable(int size_log2);
+
+            /**
+             * probe: looks a position up.
+             *
+             * @param key   - the position's key.
+             * @param entry - the result keeper.
+             *
+             * @return
+             *     true if the position was found, false otherwise (entry is left unchanged).
+             */
+            bool probe(uint64_t key, TranspositionEntry& entry) const;
+
+            /**
+             * store: saves the result of a search of a position.
+             * a stored result of the same position with a greater depth is kept.
+             *
+             * @param key   - the position's key.
+             * @param entry - the result. score must fit in 32 bits, depth in [0, 255], best_move in [-1, 65534].
+             */
+            void store(uint64_t key, const TranspositionEntry& entry);
+
+            /**
+             * clear: removes all the entries. must not be called while other threads use the table.
+             */
+            void clear();
+
+            /**
+             * getSize: the number of entries of the table.
+             */
+            size_t getSize() const;
+
+        private:
+            static uint64_t pack(const TranspositionEntry& entry);
+            static TranspositionEntry unpack(uint64_t data);
+    };
+}
+
+#endif
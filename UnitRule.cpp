@@ -0,0 +1,23 @@
+#include "UnitRule.h"
+#include "Soldier.h"
+
+namespace mtm {
+
+    UnitRule::UnitRule(char symbol) :
+        id(-1),
+        symbol(symbol),
+        kind(SOLDIER),
+        movement(Soldier::SOLDIER_MAX_MOVEMENT_UNITS),
+        reload_value(Soldier::SOLDIER_RELOAD_VALUE),
+        attack_cost(Soldier::SOLDIER_ATTACK_COST),
+        shape(DIAMOND_RANGE),
+        ring_min_factor(0),
+        can_attack_empty(false),
+        can_target_self(false),
+        ally_effect(ALLY_FORBIDDEN),
+        splash_radius_factor(0),
+        splash_damage_factor(0),
+        cadence_period(0),
+        cadence_factor(1)
+    {}
+}
@@ -0,0 +1,156 @@
+#ifndef UNIT_RULE_H
+#define UNIT_RULE_H
+
+#include "Auxiliaries.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace mtm {
+
+    typedef int UnitTypeId;
+
+    /**
+     * RangeShape - the shape of the cells a unit may attack:
+     *      DIAMOND_RANGE - every cell within the attack range (Manhattan distance).
+     *      LINE_RANGE    - like DIAMOND_RANGE, but the target must share a row or a column with the attacker.
+     *                      a target outside the line is an illegal target, not an out of range one (as a Soldier).
+     *      RING_RANGE    - like DIAMOND_RANGE, without the cells closer than ceil(range * ring_min_factor) (as a Sniper).
+     */
+    enum RangeShape { DIAMOND_RANGE, LINE_RANGE, RING_RANGE };
+
+    /**
+     * AllyEffect - what an attack does to a character of the attacker's team:
+     *      ALLY_FORBIDDEN - the attack is illegal (as a Sniper).
+     *      ALLY_NO_EFFECT - the attack is legal and costs ammo, but does nothing (as a Soldier).
+     *      ALLY_HEAL      - the ally gains health equal to the power, and no ammo is needed or spent (as a Medic).
+     */
+    enum AllyEffect { ALLY_FORBIDDEN, ALLY_NO_EFFECT, ALLY_HEAL };
+
+    /**
+     * UnitRule - the flat rule record of a unit type, compiled from a config table entry.
+     *
+     * Every rule is evaluated by the same kernel functions below, so all the types share one code path
+     * and none of them needs its own class.
+     */
+    struct UnitRule
+    {
+        UnitTypeId id;                 // the id of the type in its registry, -1 if it was never registered.
+        char symbol;                   // the upper case symbol of the type (lower case for the crossfitters).
+        CharacterType kind;            // the built-in type the unit is reported as.
+        int movement;                  // the maximal travel distance of a move.
+        units_t reload_value;          // the ammo gained by a reload.
+        units_t attack_cost;           // the ammo spent by an attack.
+        RangeShape shape;
+        double ring_min_factor;        // RING_RANGE only.
+        bool can_attack_empty;         // may the unit attack an empty cell.
+        bool can_target_self;          // may the unit attack its own cell.
+        AllyEffect ally_effect;
+        double splash_radius_factor;   // the splash radius is ceil(range * factor). 0 means no splash.
+        double splash_damage_factor;   // the splash damage is ceil(power * factor). only enemies are hit.
+        int cadence_period;            // every cadence_period-th hit on an enemy is multiplied. 0 means never.
+        int cadence_factor;
+
+        /**
+         * UnitRule constructor: creates a rule of a plain unit - diamond range, enemies only,
+         * no splash and no cadence, with the given symbol and the soldier's movement, reload and cost.
+         */
+        explicit UnitRule(char symbol = 'X');
+    };
+
+    /**
+     * isInRuleRange: the out-of-range check of a rule (see RangeShape).
+     */
+    inline bool isInRuleRange(const UnitRule& rule, units_t range, const GridPoint& src, const GridPoint& dst)
+    {
+        int distance = GridPoint::distance(src, dst);
+        if (distance > range) {
+            return false;
+        }
+        return (rule.shape != RING_RANGE || distance >= std::ceil(range * rule.ring_min_factor));
+    }
+
+    /**
+     * isInRuleLine: the line check of a rule, made after the ammo check (see RangeShape).
+     */
+    inline bool isInRuleLine(const UnitRule& rule, const GridPoint& src, const GridPoint& dst)
+    {
+        return (rule.shape != LINE_RANGE || src.row == dst.row || src.col == dst.col);
+    }
+
+    /**
+     * hasRuleAmmo: the out-of-ammo check of a rule.
+     *
+     * @param target_exists - is there a character in the attacked cell.
+     * @param same_team     - does that character belong to the attacker's team.
+     */
+    inline bool hasRuleAmmo(const UnitRule& rule, units_t ammo, bool target_exists, bool same_team)
+    {
+        if (target_exists && same_team && rule.ally_effect == ALLY_HEAL) {
+            return true;
+        }
+        return ammo >= rule.attack_cost;
+    }
+
+    /**
+     * isRuleTarget: the illegal-target check of a rule (without the line check).
+     *
+     * @param target_exists - is there a character in the attacked cell.
+     * @param is_self       - is that character the attacker.
+     * @param same_team     - does that character belong to the attacker's team.
+     */
+    inline bool isRuleTarget(const UnitRule& rule, bool target_exists, bool is_self, bool same_team)
+    {
+        if (!target_exists) {
+            return rule.can_attack_empty;
+        }
+        if (is_self) {
+            return rule.can_target_self;
+        }
+        return (!same_team || rule.ally_effect != ALLY_FORBIDDEN);
+    }
+
+    /**
+     * getRuleHitDamage: the damage of a hit on an enemy, advancing the attacker's cadence counter.
+     *
+     * @param counter - the attacker's hits counter. starts at 1.
+     */
+    inline units_t getRuleHitDamage(const UnitRule& rule, units_t power, int& counter)
+    {
+        if (rule.cadence_period <= 0) {
+            return power;
+        }
+        if (counter == rule.cadence_period) {
+            counter = 1;
+            return power * rule.cadence_factor;
+        }
+        ++counter;
+        return power;
+    }
+
+    /**
+     * getRuleSpendsAmmo: does an attack on the given target spend the attacker's ammo.
+     */
+    inline bool getRuleSpendsAmmo(const UnitRule& rule, bool target_exists, bool same_team)
+    {
+        return !(target_exists && same_team && rule.ally_effect == ALLY_HEAL);
+    }
+
+    /**
+     * getRuleSplashRadius: the Manhattan radius of the splash around the attacked cell.
+     */
+    inline int getRuleSplashRadius(const UnitRule& rule, units_t range)
+    {
+        return int(std::ceil(range * rule.splash_radius_factor));
+    }
+
+    /**
+     * getRuleSplashDamage: the damage of the splash to every enemy around the attacked cell.
+     */
+    inline units_t getRuleSplashDamage(const UnitRule& rule, units_t power)
+    {
+        return units_t(std::ceil(power * rule.splash_damage_factor));
+    }
+}
+
+#endif
@@ -0,0 +1,164 @@
+#include "UnitTable.h"
+
+namespace mtm {
+
+    UnitHandle::UnitHandle() :
+        index(0),
+        generation(0)
+    {}
+
+    UnitHandle::UnitHandle(uint32_t index, uint32_t generation) :
+        index(index),
+        generation(generation)
+    {}
+
+    bool UnitHandle::isNull() const
+    {
+        return generation == 0;
+    }
+
+    bool UnitHandle::operator==(const UnitHandle& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool UnitHandle::operator!=(const UnitHandle& other) const
+    {
+        return !(*this == other);
+    }
+
+    UnitTable::UnitTable(MemoryTracker* tracker) :
+        allocator(tracker, UNITS_MEMORY),
+        slots(TrackingAllocator<Slot>(tracker, UNITS_MEMORY)),
+        free_slots(TrackingAllocator<uint32_t>(tracker, UNITS_MEMORY)),
+        size(0),
+        untracked_bytes(0),
+        untracked_count(0)
+    {}
+
+    UnitTable::UnitTable(const UnitTable& other, MemoryTracker* tracker) :
+        UnitTable(tracker)
+    {
+        *this = other;
+    }
+
+    UnitTable& UnitTable::operator=(const UnitTable& other)
+    {
+        if (this == &other) {
+            return *this;
+        }
+
+        // every character is cloned by the table's allocator, the shared ones too.
+        std::vector<Slot, TrackingAllocator<Slot>> copied_slots(slots.get_allocator());
+        copied_slots.reserve(other.slots.size());
+        for (const Slot& slot : other.slots) {
+            std::shared_ptr<Character> clone = slot.character != nullptr ? (*slot.character).cloneShared(allocator)
+                                                                         : nullptr;
+            copied_slots.push_back(Slot{std::move(clone), slot.coordinates, slot.generation, true});
+        }
+        std::vector<uint32_t, TrackingAllocator<uint32_t>> copied_free_slots(other.free_slots,
+                                                                              free_slots.get_allocator());
+        slots.swap(copied_slots);
+        free_slots.swap(copied_free_slots);
+        size = other.size;
+        untracked_bytes = 0;
+        untracked_count = 0;
+        return *this;
+    }
+
+    UnitHandle UnitTable::insert(std::shared_ptr<Character> character, const GridPoint& coordinates, bool is_tracked)
+    {
+        if (!is_tracked) {
+            untracked_bytes += CONTROL_BLOCK_SIZE + (*character).getObjectSize();
+            ++untracked_count;
+        }
+
+        uint32_t index;
+        if (free_slots.empty()) {
+            index = uint32_t(slots.size());
+            slots.push_back(Slot{std::move(character), coordinates, 1, is_tracked});
+        }
+        else {
+            index = free_slots.back();
+            free_slots.pop_back();
+            Slot& slot = slots[index];
+            slot.character = std::move(character);
+            slot.coordinates = coordinates;
+            slot.is_tracked = is_tracked;
+        }
+
+        ++size;
+        return UnitHandle(index, slots[index].generation);
+    }
+
+    const TrackingAllocator<Character>& UnitTable::getAllocator() const
+    {
+        return allocator;
+    }
+
+    void UnitTable::remove(UnitHandle handle)
+    {
+        Slot& slot = slots[handle.index];
+        if (!slot.is_tracked) {
+            untracked_bytes -= CONTROL_BLOCK_SIZE + (*slot.character).getObjectSize();
+            --untracked_count;
+        }
+        slot.character.reset();
+
+        // generation 0 is kept for the null handle.
+        if (++slot.generation == 0) {
+            slot.generation = 1;
+        }
+        free_slots.push_back(handle.index);
+        --size;
+    }
+
+    bool UnitTable::isValid(UnitHandle handle) const
+    {
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation &&
+               slots[handle.index].character != nullptr;
+    }
+
+    Character* UnitTable::get(UnitHandle handle) const
+    {
+        return isValid(handle) ? slots[handle.index].character.get() : nullptr;
+    }
+
+    Character& UnitTable::operator[](UnitHandle handle) const
+    {
+        return *slots[handle.index].character;
+    }
+
+    const GridPoint& UnitTable::getCoordinates(UnitHandle handle) const
+    {
+        return slots[handle.index].coordinates;
+    }
+
+    void UnitTable::setCoordinates(UnitHandle handle, const GridPoint& coordinates)
+    {
+        slots[handle.index].coordinates = coordinates;
+    }
+
+    size_t UnitTable::getSize() const
+    {
+        return size;
+    }
+
+    size_t UnitTable::getCapacity() const
+    {
+        return slots.size();
+    }
+
+    MemoryUsage UnitTable::getMemoryUsage() const
+    {
+        MemoryUsage usage;
+        if (allocator.getTracker() != nullptr) {
+            usage = (*allocator.getTracker()).getUsage(UNITS_MEMORY);
+        }
+        usage.bytes += untracked_bytes;
+        usage.peak_bytes += untracked_bytes;
+        usage.allocations += untracked_count;
+        usage.total_allocations += untracked_count;
+        return usage;
+    }
+}
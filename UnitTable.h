@@ -0,0 +1,160 @@
+#ifndef UNIT_TABLE_H
+#define UNIT_TABLE_H
+
+#include "Character.h"
+#include "MemoryTracker.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * UnitHandle - a stable, generational reference to a unit of a UnitTable.
+     *
+     * A handle stays valid while its unit is in the table (moves included), and becomes stale once the unit
+     * is removed: its slot may be reused, but with a new generation, so a stale handle never refers to another unit.
+     * The default handle is null and is never valid.
+     */
+    struct UnitHandle
+    {
+        uint32_t index;
+        uint32_t generation;
+
+        /**
+         * UnitHandle constructor: creates a null handle.
+         */
+        UnitHandle();
+
+        UnitHandle(uint32_t index, uint32_t generation);
+
+        bool isNull() const;
+        bool operator==(const UnitHandle& other) const;
+        bool operator!=(const UnitHandle& other) const;
+    };
+
+    /**
+     * UnitTable - the owner of a game's characters, in slots addressed by handles.
+     *
+     * Every slot keeps its character and the character's coordinates, so a handle finds both in O(1).
+     * Removed slots are reused (most recently freed first).
+     * The characters are kept by std::shared_ptr only so the table can share them with the callers that
+     * created them (see Game::addCharacter); the table itself passes them around by handle and by reference.
+     * The slots, the clones and the characters created with getAllocator are counted in the table's tracker,
+     * under UNITS_MEMORY. The characters created by the callers are not, so they are estimated.
+     */
+    class UnitTable
+    {
+        // the control block make_shared puts before a character: a vtable pointer and two reference counts.
+        static const size_t CONTROL_BLOCK_SIZE = sizeof(void*) + 2 * sizeof(int);
+
+        struct Slot
+        {
+            std::shared_ptr<Character> character;
+            GridPoint coordinates;
+            uint32_t generation;
+            bool is_tracked; // was the character allocated by the table's allocator.
+        };
+
+        TrackingAllocator<Character> allocator;
+        std::vector<Slot, TrackingAllocator<Slot>> slots;
+        std::vector<uint32_t, TrackingAllocator<uint32_t>> free_slots;
+        size_t size;
+        size_t untracked_bytes;
+        size_t untracked_count;
+
+        public:
+            /**
+             * UnitTable constructor: creates an empty table.
+             *
+             * @param tracker - the tracker the table's memory is counted in. nullptr counts nothing.
+             */
+            explicit UnitTable(MemoryTracker* tracker = nullptr);
+
+            /**
+             * UnitTable copy constructor: creates a table of clones of the other table's characters,
+             * in the same slots, so the other table's handles are valid in the copy.
+             *
+             * @param tracker - the tracker the copy's memory is counted in (not the other table's).
+             */
+            UnitTable(const UnitTable& other, MemoryTracker* tracker);
+
+            UnitTable(const UnitTable& other) = delete;
+
+            /**
+             * operator=: replaces the table's characters by clones of the other table's characters (see above).
+             *            the table keeps its own tracker.
+             */
+            UnitTable& operator=(const UnitTable& other);
+
+            /**
+             * insert: adds a character to the table.
+             *
+             * @param character   - the character. must be non-nullptr.
+             * @param coordinates - the coordinates of the character.
+             * @param is_tracked  - was the character allocated by getAllocator (so it is counted already).
+             *
+             * @return
+             *     the handle of the character.
+             */
+            UnitHandle insert(std::shared_ptr<Character> character, const GridPoint& coordinates,
+                              bool is_tracked = false);
+
+            /**
+             * getAllocator: the allocator of the characters counted in the table's tracker.
+             */
+            const TrackingAllocator<Character>& getAllocator() const;
+
+            /**
+             * remove: removes a character from the table. its handle (and every copy of it) becomes stale.
+             *
+             * @param handle - a valid handle.
+             */
+            void remove(UnitHandle handle);
+
+            /**
+             * isValid: checks if a handle refers to a character of the table.
+             */
+            bool isValid(UnitHandle handle) const;
+
+            /**
+             * get: returns the character of a handle, nullptr if the handle is not valid.
+             */
+            Character* get(UnitHandle handle) const;
+
+            /**
+             * operator[]: returns the character of a valid handle, without checking it.
+             */
+            Character& operator[](UnitHandle handle) const;
+
+            /**
+             * getCoordinates: returns the coordinates of a valid handle's character, without checking it.
+             */
+            const GridPoint& getCoordinates(UnitHandle handle) const;
+
+            /**
+             * setCoordinates: updates the coordinates of a valid handle's character.
+             */
+            void setCoordinates(UnitHandle handle, const GridPoint& coordinates);
+
+            /**
+             * getSize: the number of characters in the table.
+             */
+            size_t getSize() const;
+
+            /**
+             * getCapacity: the number of slots of the table (used and free).
+             */
+            size_t getCapacity() const;
+
+            /**
+             * getMemoryUsage: the memory of the slots and of the characters: the tracked ones as counted by the
+             *                 tracker, and the others as a single make_shared allocation of the object and
+             *                 a control block.
+             */
+            MemoryUsage getMemoryUsage() const;
+    };
+}
+
+#endif
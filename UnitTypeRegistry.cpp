@@ -0,0 +1,259 @@
+#include "UnitTypeRegistry.h"
+
+#include "Exceptions.h"
+#include "Medic.h"
+#include "Sniper.h"
+#include "Soldier.h"
+
+#include <sstream>
+
+namespace mtm {
+
+    static UnitRule makeSoldierRule()
+    {
+        UnitRule rule(Soldier::SOLDIER_SYMBOL);
+        rule.id = SOLDIER;
+        rule.kind = SOLDIER;
+        rule.movement = Soldier::SOLDIER_MAX_MOVEMENT_UNITS;
+        rule.reload_value = Soldier::SOLDIER_RELOAD_VALUE;
+        rule.attack_cost = Soldier::SOLDIER_ATTACK_COST;
+        rule.shape = LINE_RANGE;
+        rule.can_attack_empty = true;
+        rule.can_target_self = true;
+        rule.ally_effect = ALLY_NO_EFFECT;
+        rule.splash_radius_factor = Soldier::NEARBY_DISTANCE_FACTOR;
+        rule.splash_damage_factor = Soldier::NEARBY_DAMAGE_FACTOR;
+        return rule;
+    }
+
+    static UnitRule makeMedicRule()
+    {
+        UnitRule rule(Medic::MEDIC_SYMBOL);
+        rule.id = MEDIC;
+        rule.kind = MEDIC;
+        rule.movement = Medic::MEDIC_MAX_MOVEMENT_UNITS;
+        rule.reload_value = Medic::MEDIC_RELOAD_VALUE;
+        rule.attack_cost = Medic::MEDIC_ATTACK_COST;
+        rule.shape = DIAMOND_RANGE;
+        rule.ally_effect = ALLY_HEAL;
+        return rule;
+    }
+
+    static UnitRule makeSniperRule()
+    {
+        UnitRule rule(Sniper::SNIPER_SYMBOL);
+        rule.id = SNIPER;
+        rule.kind = SNIPER;
+        rule.movement = Sniper::SNIPER_MAX_MOVEMENT_UNITS;
+        rule.reload_value = Sniper::SNIPER_RELOAD_VALUE;
+        rule.attack_cost = Sniper::SNIPER_ATTACK_COST;
+        rule.shape = RING_RANGE;
+        rule.ring_min_factor = Sniper::MINIMAL_RANGE_FACTOR;
+        rule.ally_effect = ALLY_FORBIDDEN;
+        rule.cadence_period = Sniper::NUM_OF_ATTACKS_UNTIL_DOUBLE_DAMAGE;
+        rule.cadence_factor = Sniper::INCREASED_ATTACK_FACTOR;
+        return rule;
+    }
+
+    const UnitRule& UnitTypeRegistry::getBuiltinRule(CharacterType type)
+    {
+        static const UnitRule soldier_rule = makeSoldierRule();
+        static const UnitRule medic_rule = makeMedicRule();
+        static const UnitRule sniper_rule = makeSniperRule();
+
+        switch (type)
+        {
+            case SOLDIER: return soldier_rule;
+            case MEDIC:   return medic_rule;
+            case SNIPER:  return sniper_rule;
+            default: throw IllegalArgument();
+        }
+    }
+
+    UnitTypeRegistry::UnitTypeRegistry() :
+        names(),
+        rules()
+    {
+        registerType("soldier", getBuiltinRule(SOLDIER));
+        registerType("medic", getBuiltinRule(MEDIC));
+        registerType("sniper", getBuiltinRule(SNIPER));
+    }
+
+    UnitTypeId UnitTypeRegistry::registerType(const std::string& name, const UnitRule& rule)
+    {
+        if (name.empty() || rule.symbol < 'A' || rule.symbol > 'Z' ||
+            rule.movement < 0 || rule.reload_value < 0 || rule.attack_cost < 0 ||
+            !(rule.ring_min_factor >= 0) || !(rule.splash_radius_factor >= 0) || !(rule.splash_damage_factor >= 0) ||
+            rule.cadence_period < 0 || rule.cadence_factor < 0 ||
+            (rule.kind != SOLDIER && rule.kind != MEDIC && rule.kind != SNIPER)) {
+            throw IllegalArgument();
+        }
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == name || rules[i].symbol == rule.symbol) {
+                throw IllegalArgument();
+            }
+        }
+
+        names.push_back(name);
+        rules.push_back(rule);
+        rules.back().id = UnitTypeId(rules.size() - 1);
+        return rules.back().id;
+    }
+
+    UnitTypeId UnitTypeRegistry::findType(const std::string& name) const
+    {
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == name) {
+                return UnitTypeId(i);
+            }
+        }
+        throw IllegalArgument();
+    }
+
+    const UnitRule& UnitTypeRegistry::getRule(UnitTypeId type) const
+    {
+        if (type < 0 || size_t(type) >= rules.size()) {
+            throw IllegalArgument();
+        }
+        return rules[type];
+    }
+
+    int UnitTypeRegistry::getTypesCount() const
+    {
+        return int(rules.size());
+    }
+
+    std::shared_ptr<Character> UnitTypeRegistry::makeCharacter(UnitTypeId type, Team team, units_t health,
+                                                               units_t ammo, units_t range, units_t power) const
+    {
+        if (health <= 0 || ammo < 0 || range < 0 || power < 0) {
+            throw IllegalArgument();
+        }
+        return std::make_shared<GenericCharacter>(getRule(type), team, health, ammo, range, power);
+    }
+
+    int UnitTypeRegistry::loadConfig(std::istream& config)
+    {
+        int defined = 0;
+        std::string line;
+        while (std::getline(config, line))
+        {
+            size_t first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#') {
+                continue;
+            }
+            parseLine(line);
+            ++defined;
+        }
+        return defined;
+    }
+
+    static bool parseKind(const std::string& value, CharacterType& kind)
+    {
+        if (value == "soldier") { kind = SOLDIER; return true; }
+        if (value == "medic")   { kind = MEDIC;   return true; }
+        if (value == "sniper")  { kind = SNIPER;  return true; }
+        return false;
+    }
+
+    static bool parseShape(const std::string& value, RangeShape& shape)
+    {
+        if (value == "diamond") { shape = DIAMOND_RANGE; return true; }
+        if (value == "line")    { shape = LINE_RANGE;    return true; }
+        if (value == "ring")    { shape = RING_RANGE;    return true; }
+        return false;
+    }
+
+    static bool parseAllyEffect(const std::string& value, AllyEffect& ally_effect)
+    {
+        if (value == "forbidden") { ally_effect = ALLY_FORBIDDEN; return true; }
+        if (value == "none")      { ally_effect = ALLY_NO_EFFECT; return true; }
+        if (value == "heal")      { ally_effect = ALLY_HEAL;      return true; }
+        return false;
+    }
+
+    template <class T>
+    static bool parseNumber(const std::string& value, T& number)
+    {
+        std::istringstream stream(value);
+        T parsed;
+        if (!(stream >> parsed) || !stream.eof()) {
+            return false;
+        }
+        number = parsed;
+        return true;
+    }
+
+    void UnitTypeRegistry::parseLine(const std::string& line)
+    {
+        std::istringstream tokens(line);
+        std::string name;
+        tokens >> name;
+
+        std::vector<std::pair<std::string, std::string>> entries;
+        bool has_symbol = false;
+        bool has_base = false;
+        UnitRule rule;
+
+        for (std::string token; tokens >> token; )
+        {
+            size_t separator = token.find('=');
+            if (separator == std::string::npos || separator == 0 || separator + 1 == token.size()) {
+                throw IllegalArgument();
+            }
+            std::string key = token.substr(0, separator);
+            std::string value = token.substr(separator + 1);
+
+            // the base is applied first, wherever it appears in the line.
+            if (key == "base") {
+                rule = getRule(findType(value));
+                has_base = true;
+            }
+            else {
+                entries.push_back(std::make_pair(key, value));
+            }
+        }
+
+        for (const std::pair<std::string, std::string>& entry : entries)
+        {
+            const std::string& key = entry.first;
+            const std::string& value = entry.second;
+            bool parsed = false;
+            int flag = 0;
+
+            if (key == "symbol") {
+                parsed = (value.size() == 1);
+                rule.symbol = value[0];
+                has_symbol = true;
+            }
+            else if (key == "kind")           { parsed = parseKind(value, rule.kind); }
+            else if (key == "movement")       { parsed = parseNumber(value, rule.movement); }
+            else if (key == "reload")         { parsed = parseNumber(value, rule.reload_value); }
+            else if (key == "cost")           { parsed = parseNumber(value, rule.attack_cost); }
+            else if (key == "shape")          { parsed = parseShape(value, rule.shape); }
+            else if (key == "ring_min")       { parsed = parseNumber(value, rule.ring_min_factor); }
+            else if (key == "ally")           { parsed = parseAllyEffect(value, rule.ally_effect); }
+            else if (key == "splash_radius")  { parsed = parseNumber(value, rule.splash_radius_factor); }
+            else if (key == "splash_damage")  { parsed = parseNumber(value, rule.splash_damage_factor); }
+            else if (key == "cadence")        { parsed = parseNumber(value, rule.cadence_period); }
+            else if (key == "cadence_factor") { parsed = parseNumber(value, rule.cadence_factor); }
+            else if (key == "empty") {
+                parsed = parseNumber(value, flag) && (flag == 0 || flag == 1);
+                rule.can_attack_empty = (flag == 1);
+            }
+            else if (key == "self") {
+                parsed = parseNumber(value, flag) && (flag == 0 || flag == 1);
+                rule.can_target_self = (flag == 1);
+            }
+
+            if (!parsed) {
+                throw IllegalArgument();
+            }
+        }
+
+        if (!has_symbol && !has_base) {
+            throw IllegalArgument();
+        }
+        registerType(name, rule);
+    }
+}
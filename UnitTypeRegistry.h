@@ -0,0 +1,129 @@
+#ifndef UNIT_TYPE_REGISTRY_H
+#define UNIT_TYPE_REGISTRY_H
+
+#include "UnitRule.h"
+#include "GenericCharacter.h"
+
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * UnitTypeRegistry - a table of unit types, defined at run time from a config table.
+     *
+     * The built-in types "soldier", "medic" and "sniper" are always defined, with rules equal to
+     * the Soldier, Medic and Sniper classes, and may be used as the base of new types.
+     *
+     * Config table format - one type per line, blank lines and lines starting with '#' are ignored:
+     *
+     *      <name> [key=value]...
+     *
+     * keys:  base=<type name>           - copy the rule of an existing type before applying the other keys.
+     *        symbol=<A-Z>               - required unless a base is given. must not be a symbol of another type.
+     *        kind=soldier|medic|sniper  - the built-in type the unit is reported as.
+     *        movement=<int>  reload=<int>  cost=<int>
+     *        shape=diamond|line|ring    ring_min=<real>
+     *        ally=forbidden|none|heal   empty=0|1   self=0|1
+     *        splash_radius=<real>       splash_damage=<real>
+     *        cadence=<int>              cadence_factor=<int>
+     *
+     * for example:
+     *      tank   symbol=T base=soldier movement=2 cost=2 splash_radius=0.5 splash_damage=0.25
+     *      archer symbol=A base=sniper ring_min=0.25 cadence=2 cadence_factor=3
+     */
+    class UnitTypeRegistry
+    {
+        std::vector<std::string> names;
+        std::deque<UnitRule> rules; // a deque keeps the rules in place, since characters point to them.
+
+        public:
+            /**
+             * UnitTypeRegistry constructor: creates a registry holding only the built-in types.
+             */
+            UnitTypeRegistry();
+
+            UnitTypeRegistry(const UnitTypeRegistry& other) = delete;
+            UnitTypeRegistry& operator=(const UnitTypeRegistry& other) = delete;
+
+            /**
+             * registerType: defines a new type.
+             *
+             * @param name - the name of the type. must not be defined already.
+             * @param rule - the rule of the type.
+             *
+             * @throw
+             *     IllegalArgument - if the name or the symbol is already defined, or one of the rule's values is incorrect.
+             *
+             * @return
+             *     the id of the new type.
+             */
+            UnitTypeId registerType(const std::string& name, const UnitRule& rule);
+
+            /**
+             * loadConfig: defines every type of a config table (see the format above).
+             *
+             * @param config - the stream of the table.
+             *
+             * @throw
+             *     IllegalArgument - if a line is malformed or defines an incorrect type.
+             *                       the types of the previous lines remain defined.
+             *
+             * @return
+             *     the number of types defined.
+             */
+            int loadConfig(std::istream& config);
+
+            /**
+             * findType: returns the id of a type by its name.
+             *
+             * @throw
+             *     IllegalArgument - if there is no such type.
+             */
+            UnitTypeId findType(const std::string& name) const;
+
+            /**
+             * getRule: returns the rule of a type.
+             *
+             * @throw
+             *     IllegalArgument - if there is no such type.
+             */
+            const UnitRule& getRule(UnitTypeId type) const;
+
+            /**
+             * getTypesCount: the number of defined types, built-in types included.
+             */
+            int getTypesCount() const;
+
+            /**
+             * makeCharacter: creates a new character of a type.
+             *
+             * @param type - the id of the type.
+             * @param team, health, ammo, range, power - as described in Game::makeCharacter.
+             *
+             * @throw
+             *     IllegalArgument - if there is no such type, or one of the values is incorrect.
+             *
+             * @return
+             *     a shared pointer to the new character. the registry must outlive it.
+             */
+            std::shared_ptr<Character> makeCharacter(UnitTypeId type, Team team, units_t health,
+                                                     units_t ammo, units_t range, units_t power) const;
+
+            /**
+             * getBuiltinRule: returns the rule equal to a built-in character class.
+             */
+            static const UnitRule& getBuiltinRule(CharacterType type);
+
+        private:
+            /**
+             * parseLine: defines the type of a single (non empty) config line.
+             */
+            void parseLine(const std::string& line);
+    };
+}
+
+#endif
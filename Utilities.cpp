@@ -2,7 +2,7 @@
 
 namespace mtm 
 {
-    bool ComparePoints::operator()(const GridPoint& first, const GridPoint& second)
+    bool ComparePoints::operator()(const GridPoint& first, const GridPoint& second) const
     {
         if (first.row == second.row) {
             return first.col < second.col;
@@ -10,15 +10,24 @@ namespace mtm
         return first.row < second.row;
     }
 
-    bool IsInSoldierAttackRange::operator()(BOARD_TILE dst)
-    {
-        int distance = GridPoint::distance(attack_coordinates, dst.first);
-        return (distance > 0 && 
-                distance <= std::ceil(soldier.getAttackRange() * Soldier::NEARBY_DISTANCE_FACTOR));
-    }
+    UnitDescriptor::UnitDescriptor() :
+        coordinates(0, 0),
+        type(SOLDIER),
+        team(POWERLIFTERS),
+        health(0),
+        ammo(0),
+        range(0),
+        power(0)
+    {}
 
-    IsInSoldierAttackRange::IsInSoldierAttackRange(const Character& soldier, const GridPoint& attack_coordinates) :
-        soldier(soldier),
-        attack_coordinates(attack_coordinates)
+    UnitDescriptor::UnitDescriptor(const GridPoint& coordinates, CharacterType type, Team team,
+                                   units_t health, units_t ammo, units_t range, units_t power) :
+        coordinates(coordinates),
+        type(type),
+        team(team),
+        health(health),
+        ammo(ammo),
+        range(range),
+        power(power)
     {}
 }
\ No newline at end of file
@@ -6,15 +6,18 @@
 #include "Soldier.h"
 #include "Sniper.h"
 #include "Medic.h"
+#include "UnitTable.h"
+#include "MemoryTracker.h"
 
 #include <utility>
 #include <memory>
 #include <map>
 
-#define BOARD_MAP std::map<GridPoint, std::shared_ptr<Character>, mtm::ComparePoints>
-#define BOARD_TILE std::pair<const mtm::GridPoint, std::shared_ptr<mtm::Character>>
+// the characters are kept in a UnitTable, the nodes are counted by the game's MemoryTracker.
+#define BOARD_MAP std::map<GridPoint, mtm::UnitHandle, mtm::ComparePoints, mtm::TrackingAllocator<BOARD_TILE>>
+#define BOARD_TILE std::pair<const mtm::GridPoint, mtm::UnitHandle>
 #define MAKE_TILE(coordinates, character) (std::make_pair(coordinates, character))
-#define MAKE_CHARACTER(type) (std::shared_ptr<Character>(new type (team, health, ammo, range, power)))
+#define MAKE_CHARACTER(type) (std::allocate_shared<type>(allocator, team, health, ammo, range, power)) // one allocation per character.
 
 namespace mtm
 {
@@ -33,36 +36,34 @@ namespace mtm
          * @return
          *     true if the first gridPoint is above or (left and not below) the second gridPoint, false otherwise.
          */
-        bool operator()(const GridPoint& first, const GridPoint& second);
+        bool operator()(const GridPoint& first, const GridPoint& second) const;
     };
 
     /**
-     * IsInSoldierAttackRange - a struct used in Game's method "attack".
-     * the struct is used as a function object in order to be used in std::find_if.
+     * UnitDescriptor - a plain description of a character and its coordinates,
+     * used to build a game from a list of units at once.
      * */
-    struct IsInSoldierAttackRange
+    struct UnitDescriptor
     {
-        const Character& soldier;
-        const GridPoint& attack_coordinates; 
+        GridPoint coordinates;
+        CharacterType type;
+        Team team;
+        units_t health, ammo, range, power;
 
         /**
-         * IsInSoldierAttackRange constructor: receives and saves a soldier and his attack coordinated as attributes,
-         * in order to use them later in the activation operator.
-         * 
-         * @param soldier            - a reference to a valid soldier character.
-         * @param attack_coordinated - a reference to a valid soldier's attack coordinates.
+         * UnitDescriptor constructor: creates a soldier of the powerlifters with no stats in cell (0, 0).
+         * exists so descriptors can be stored in preallocated buffers.
          */
-        IsInSoldierAttackRange(const Character& soldier, const GridPoint& attack_coordinates);
+        UnitDescriptor();
 
         /**
-         * operator(): activates the IsInSoldierAttackRange function object.
+         * UnitDescriptor constructor: creates a new unit descriptor.
          *
-         * @param dst - a valid pair of a soldier and his attack coordinates.
-         * 
-         * @return
-         *     true if the coortinates are withing the soldier's nearby area effect range, false otherwise.
+         * @param coordinates - the coordinates of the character.
+         * @param type, team, health, ammo, range, power - as described in Game::makeCharacter.
          */
-        bool operator()(BOARD_TILE dst);
+        UnitDescriptor(const GridPoint& coordinates, CharacterType type, Team team,
+                       units_t health, units_t ammo, units_t range, units_t power);
     };
 }
 
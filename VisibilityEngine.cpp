@@ -0,0 +1,170 @@
+#include "VisibilityEngine.h"
+
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <initializer_list>
+
+namespace mtm {
+
+    const char VisibilityEngine::FOG_CHAR;
+    const int VisibilityEngine::MAX_SIGHT_RADIUS;
+
+    VisibilityEngine::TeamView::TeamView(int height, int width) :
+        coverage(size_t(height) * size_t(width), 0),
+        visible(height, width),
+        frame(size_t(height) * size_t(width), FOG_CHAR),
+        changed(),
+        changed_mask(height, width)
+    {}
+
+    VisibilityEngine::VisibilityEngine(const Game& game, int sight_radius) :
+        game(game),
+        height(game.getHeight()),
+        width(game.getWidth()),
+        sight_radius(sight_radius),
+        crossfitters_view(height, width),
+        powerlifters_view(height, width)
+    {
+        if (sight_radius < 0 || sight_radius > MAX_SIGHT_RADIUS) {
+            throw IllegalArgument();
+        }
+        rebuild();
+    }
+
+    void VisibilityEngine::emit(const GameEvent& event)
+    {
+        switch (event.type) {
+            case UNIT_ADDED_EVENT:
+                addSight(view(event.team), event.coordinates, 1);
+                markContents(event.coordinates);
+                break;
+
+            case MOVED_EVENT:
+                addSight(view(event.team), event.source, -1);
+                addSight(view(event.team), event.coordinates, 1);
+                markContents(event.source);
+                markContents(event.coordinates);
+                break;
+
+            case KILLED_EVENT:
+                addSight(view(event.team), event.coordinates, -1);
+                markContents(event.coordinates);
+                break;
+
+            default: // the other events change neither the visibility nor the chars of the board.
+                break;
+        }
+    }
+
+    void VisibilityEngine::rebuild()
+    {
+        for (TeamView* team_view : {&crossfitters_view, &powerlifters_view}) {
+            std::fill((*team_view).coverage.begin(), (*team_view).coverage.end(), 0);
+            (*team_view).visible.clear();
+            (*team_view).changed.clear();
+            (*team_view).changed_mask.clear();
+            for (int row = 0; row < height; ++row) {
+                for (int col = 0; col < width; ++col) {
+                    markChanged(*team_view, GridPoint(row, col));
+                }
+            }
+        }
+
+        game.forEachCharacter([this](const GridPoint& coordinates, const Character& character) {
+            addSight(view(character.getTeam()), coordinates, 1);
+        });
+    }
+
+    bool VisibilityEngine::isVisible(Team team, const GridPoint& coordinates) const
+    {
+        return view(team).visible.test(coordinates);
+    }
+
+    const Bitboard& VisibilityEngine::getVisibleCells(Team team) const
+    {
+        return view(team).visible;
+    }
+
+    size_t VisibilityEngine::getChangesCount(Team team) const
+    {
+        return view(team).changed.size();
+    }
+
+    std::ostream& VisibilityEngine::render(std::ostream& os, Team team)
+    {
+        drainChanges(team, [](const GridPoint&, char) {});
+        const std::vector<char>& frame = view(team).frame;
+        return printGameBoard(os, frame.data(), frame.data() + frame.size(), (unsigned int)width);
+    }
+
+    VisibilityEngine::TeamView& VisibilityEngine::view(Team team)
+    {
+        return team == CROSSFITTERS ? crossfitters_view : powerlifters_view;
+    }
+
+    const VisibilityEngine::TeamView& VisibilityEngine::view(Team team) const
+    {
+        return team == CROSSFITTERS ? crossfitters_view : powerlifters_view;
+    }
+
+    size_t VisibilityEngine::index(const GridPoint& coordinates) const
+    {
+        return size_t(coordinates.row) * size_t(width) + size_t(coordinates.col);
+    }
+
+    void VisibilityEngine::addSight(TeamView& team_view, const GridPoint& center, int delta)
+    {
+        int first_row = std::max(0, center.row - sight_radius);
+        int last_row  = std::min(height - 1, center.row + sight_radius);
+        for (int row = first_row; row <= last_row; ++row) {
+            int row_radius = sight_radius - std::abs(row - center.row);
+            int first_col  = std::max(0, center.col - row_radius);
+            int last_col   = std::min(width - 1, center.col + row_radius);
+            for (int col = first_col; col <= last_col; ++col) {
+                const GridPoint coordinates(row, col);
+                uint16_t& count = team_view.coverage[index(coordinates)];
+                count = uint16_t(count + delta);
+
+                // only the first character to see a cell and the last one to stop seeing it change its visibility.
+                if (count == 0) {
+                    team_view.visible.reset(coordinates);
+                    markChanged(team_view, coordinates);
+                }
+                else if (count == 1 && delta > 0) {
+                    team_view.visible.set(coordinates);
+                    markChanged(team_view, coordinates);
+                }
+            }
+        }
+    }
+
+    void VisibilityEngine::markContents(const GridPoint& coordinates)
+    {
+        // a team that does not see the cell keeps its fog, and gets the contents when it starts seeing it.
+        for (TeamView* team_view : {&crossfitters_view, &powerlifters_view}) {
+            if ((*team_view).visible.test(coordinates)) {
+                markChanged(*team_view, coordinates);
+            }
+        }
+    }
+
+    void VisibilityEngine::markChanged(TeamView& team_view, const GridPoint& coordinates)
+    {
+        if (!team_view.changed_mask.test(coordinates)) {
+            team_view.changed_mask.set(coordinates);
+            team_view.changed.push_back(coordinates);
+        }
+    }
+
+    char VisibilityEngine::getCellChar(const TeamView& team_view, const GridPoint& coordinates) const
+    {
+        if (!team_view.visible.test(coordinates)) {
+            return FOG_CHAR;
+        }
+
+        const Character* character = game.getCharacter(coordinates);
+        return character == nullptr ? ' ' : (*character).convertToChar();
+    }
+}
@@ -0,0 +1,166 @@
+#ifndef VISIBILITY_ENGINE_H
+#define VISIBILITY_ENGINE_H
+
+#include "Game.h"
+#include "GameEvent.h"
+#include "Bitboard.h"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace mtm {
+
+    /**
+     * VisibilityEngine - the fog of war of a game: the cells every team sees.
+     *
+     * Every character sees the cells within a Manhattan distance of the sight radius from it (its own cell included).
+     * The engine is the game's event sink (see Game::setEventSink): it counts, for every team and cell, the team's
+     * characters that see the cell, and updates those counts on every added, moved and killed character,
+     * so a change costs the area of a sight diamond, never the area of the board.
+     *
+     * Every team has a frame - the board as the team sees it, with FOG_CHAR in the cells it does not see.
+     * The cells whose visibility or contents changed since the team's last frame are kept in a list,
+     * so a new frame is built in time proportional to the changed cells.
+     *
+     * NOTE: while the engine is not the game's event sink (or after the game is assigned to), it misses the game's
+     *       changes, and rebuild must be called before it is used again.
+     */
+    class VisibilityEngine : public GameEventSink
+    {
+        /**
+         * TeamView - the visibility data of a single team.
+         */
+        struct TeamView
+        {
+            std::vector<uint16_t> coverage; // the number of the team's characters that see every cell.
+            Bitboard visible;
+            std::vector<char> frame;
+            std::vector<GridPoint> changed;
+            Bitboard changed_mask;
+
+            TeamView(int height, int width);
+        };
+
+        const Game& game;
+        int height;
+        int width;
+        int sight_radius;
+        TeamView crossfitters_view;
+        TeamView powerlifters_view;
+
+        public:
+            static const char FOG_CHAR = '#';
+
+            /**
+             * the largest sight radius: the number of characters that see a cell must fit the 16 bit counts.
+             */
+            static const int MAX_SIGHT_RADIUS = 180;
+
+            VisibilityEngine() = delete;
+            VisibilityEngine(const VisibilityEngine& other) = delete;
+            VisibilityEngine& operator=(const VisibilityEngine& other) = delete;
+
+            /**
+             * VisibilityEngine constructor: creates the visibility of a game's current characters.
+             *
+             * @param game         - the game. it must outlive the engine.
+             * @param sight_radius - the Manhattan distance every character sees.
+             *
+             * @throw
+             *     IllegalArgument - if the sight radius is negative or greater than MAX_SIGHT_RADIUS.
+             */
+            VisibilityEngine(const Game& game, int sight_radius);
+
+            void emit(const GameEvent& event) override;
+
+            /**
+             * rebuild: recomputes the visibility from the game's current characters.
+             * every cell of both frames is reported as changed.
+             */
+            void rebuild();
+
+            /**
+             * isVisible: checks if a team sees a cell.
+             *
+             * @param team        - the team.
+             * @param coordinates - a reference to a valid cell coordinates (within the board's range).
+             */
+            bool isVisible(Team team, const GridPoint& coordinates) const;
+
+            /**
+             * getVisibleCells: returns the bitboard of the cells a team sees.
+             */
+            const Bitboard& getVisibleCells(Team team) const;
+
+            /**
+             * getChangesCount: the number of cells of a team's frame that changed since it was last updated.
+             */
+            size_t getChangesCount(Team team) const;
+
+            /**
+             * drainChanges: updates a team's frame, and visits every cell that changed since the last update.
+             *
+             * @param team  - the team.
+             * @param visit - a function object, called as visit(const GridPoint&, char) with the new char of the cell:
+             *                the character's char, ' ' for an empty cell or FOG_CHAR for a cell the team does not see.
+             *
+             * @return
+             *     the number of cells visited.
+             */
+            template <class Visitor>
+            size_t drainChanges(Team team, Visitor visit)
+            {
+                TeamView& team_view = view(team);
+                size_t count = team_view.changed.size();
+                for (const GridPoint& coordinates : team_view.changed) {
+                    char cell = getCellChar(team_view, coordinates);
+                    team_view.frame[index(coordinates)] = cell;
+                    team_view.changed_mask.reset(coordinates);
+                    visit(coordinates, cell);
+                }
+                team_view.changed.clear();
+                return count;
+            }
+
+            /**
+             * render: updates a team's frame and prints it, the same way the game itself is printed.
+             *
+             * @param os   - the output stream.
+             * @param team - the team.
+             *
+             * @return
+             *     the output stream.
+             */
+            std::ostream& render(std::ostream& os, Team team);
+
+        private:
+            TeamView& view(Team team);
+            const TeamView& view(Team team) const;
+
+            size_t index(const GridPoint& coordinates) const;
+
+            /**
+             * addSight: adds delta to the counts of the cells a character in "center" sees,
+             * and marks the cells whose visibility changed.
+             */
+            void addSight(TeamView& team_view, const GridPoint& center, int delta);
+
+            /**
+             * markContents: marks a cell whose contents changed, for every team that sees it.
+             */
+            void markContents(const GridPoint& coordinates);
+
+            /**
+             * markChanged: adds a cell to a team's changed cells, once.
+             */
+            static void markChanged(TeamView& team_view, const GridPoint& coordinates);
+
+            /**
+             * getCellChar: the char of a cell in a team's frame.
+             */
+            char getCellChar(const TeamView& team_view, const GridPoint& coordinates) const;
+    };
+}
+
+#endif
@@ -0,0 +1,28 @@
+#include "Zobrist.h"
+
+namespace mtm {
+
+    uint64_t Zobrist::mix(uint64_t value)
+    {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    uint64_t Zobrist::getCharacterKey(const GridPoint& coordinates, const Character& character)
+    {
+        uint64_t cell = (uint64_t(uint32_t(coordinates.row)) << 32) | uint32_t(coordinates.col);
+        uint64_t kind = uint64_t(uint8_t(character.convertToChar())) |
+                        uint64_t(uint32_t(character.getAttackCounter())) << 8;
+        uint64_t stats = uint64_t(uint32_t(character.getHealth())) << 32 | uint32_t(character.getAmmo());
+
+        // the features take more than 64 bits, so they are mixed in two rounds.
+        return mix(mix(mix(cell) ^ kind) ^ stats);
+    }
+
+    uint64_t Zobrist::getTeamKey(Team team)
+    {
+        return mix(0x5EED0000ULL + uint64_t(team == CROSSFITTERS));
+    }
+}
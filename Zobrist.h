@@ -0,0 +1,42 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "Character.h"
+
+#include <cstdint>
+
+namespace mtm {
+
+    /**
+     * Zobrist - the keys of the Zobrist hash of a game.
+     *
+     * The hash of a game is the XOR of the keys of all its characters, so it is updated in O(1)
+     * whenever a single character changes. Instead of a table of random keys per cell (which would be
+     * as large as the board), every key is derived from its cell and features by a 64-bit mixing function.
+     */
+    class Zobrist
+    {
+        public:
+            /**
+             * getCharacterKey: the key of a character standing in a cell.
+             * the key depends on the cell, the character's symbol (type and team), health, ammo and attack counter,
+             * all keyed by their full values.
+             *
+             * @param coordinates - the coordinates of the character.
+             * @param character   - a reference to the character.
+             */
+            static uint64_t getCharacterKey(const GridPoint& coordinates, const Character& character);
+
+            /**
+             * getTeamKey: a key XOR-ed into a hash to tell which team is to move.
+             */
+            static uint64_t getTeamKey(Team team);
+
+            /**
+             * mix: the splitmix64 finalizer - a bijective mixing of 64 bits.
+             */
+            static uint64_t mix(uint64_t value);
+    };
+}
+
+#endif